@@ -0,0 +1,230 @@
+#include "AnalyserView.h"
+#include "../dsp/DSPChain.h"
+
+//==============================================================================
+AnalyserView::AnalyserView(AnalysisTap& tapToRead, juce::AudioProcessorValueTreeState& state)
+    : tap(tapToRead) {
+    mode = state.getRawParameterValue("mode");
+    lowCut = state.getRawParameterValue("lowCut");
+    highCut = state.getRawParameterValue("highCut");
+    jassert(mode != nullptr && lowCut != nullptr && highCut != nullptr);
+
+    history.assign(static_cast<size_t>(fftSize), 0.0f);
+    fftData.assign(static_cast<size_t>(2 * fftSize), 0.0f);
+
+    analysisRate = tap.getAnalysisSampleRate();
+    maxFrequency = static_cast<float>(tap.getAnalysisBandwidth());
+
+    // Frames left over from an earlier editor are stale
+    AnalysisTap::Frame frame;
+    while (tap.pop(frame)) {}
+
+    // Everything below is drawn, so nothing behind needs repainting
+    setOpaque(true);
+
+    tap.setActive(true);
+    startTimerHz(frameRate);
+}
+
+AnalyserView::~AnalyserView() {
+    stopTimer();
+    tap.setActive(false);
+}
+
+//==============================================================================
+void AnalyserView::timerCallback() {
+    newSamples = readFrames();
+
+    const bool spectrumChanged = updateSpectrum();
+    const bool passbandChanged = updatePassband();
+    const bool metersChanged = updateMeters();
+
+    // Only the regions that changed; a silent, settled view repaints nothing
+    if (spectrumChanged || passbandChanged)
+        repaint(spectrumArea);
+
+    if (metersChanged)
+        repaint(meterArea);
+}
+
+bool AnalyserView::readFrames() {
+    // New host rate: the history and the bin layout no longer match
+    if (tap.getAnalysisSampleRate() != analysisRate) {
+        analysisRate = tap.getAnalysisSampleRate();
+        maxFrequency = static_cast<float>(tap.getAnalysisBandwidth());
+        std::fill(history.begin(), history.end(), 0.0f);
+        historyPos = 0;
+        updateColumnBins();
+    }
+
+    bool any = false;
+    AnalysisTap::Frame frame;
+
+    while (tap.pop(frame)) {
+        any = true;
+        inputPeak = juce::jmax(inputPeak, frame.inputPeak);
+        outputPeak = juce::jmax(outputPeak, frame.outputPeak);
+
+        for (int i = 0; i < frame.numSamples; ++i) {
+            history[static_cast<size_t>(historyPos)] = frame.samples[static_cast<size_t>(i)];
+            historyPos = (historyPos + 1) % fftSize;
+        }
+    }
+
+    return any;
+}
+
+bool AnalyserView::updateSpectrum() {
+    if (newSamples) {
+        // Oldest sample first, then window and transform
+        std::copy(history.begin() + historyPos, history.end(), fftData.begin());
+        std::copy(history.begin(), history.begin() + historyPos, fftData.begin() + (fftSize - historyPos));
+        std::fill(fftData.begin() + fftSize, fftData.end(), 0.0f);
+
+        window.multiplyWithWindowingTable(fftData.data(), static_cast<size_t>(fftSize));
+        fft.performFrequencyOnlyForwardTransform(fftData.data(), true);
+    }
+
+    // Sine amplitude from a Hann-windowed bin: 2 / (fftSize * 0.5)
+    const float scale = 4.0f / static_cast<float>(fftSize);
+    bool changed = false;
+
+    for (size_t x = 0; x < spectrumDb.size(); ++x) {
+        float target = floorDb;
+
+        if (newSamples) {
+            const int first = columnBins[x];
+            const int last = juce::jmax(columnBins[x + 1], first + 1);
+
+            float magnitude = 0.0f;
+            for (int bin = first; bin < last; ++bin)
+                magnitude = juce::jmax(magnitude, fftData[static_cast<size_t>(bin)]);
+
+            target = juce::Decibels::gainToDecibels(magnitude * scale, floorDb);
+        }
+
+        const float level = decayTowards(spectrumDb[x], target, releaseDbPerFrame);
+        changed = changed || level != spectrumDb[x];
+        spectrumDb[x] = level;
+    }
+
+    return changed;
+}
+
+bool AnalyserView::updateMeters() {
+    const float inputTarget = juce::Decibels::gainToDecibels(inputPeak, floorDb);
+    const float outputTarget = juce::Decibels::gainToDecibels(outputPeak, floorDb);
+    inputPeak = outputPeak = 0.0f;
+
+    const float newInput = decayTowards(inputDb, inputTarget, releaseDbPerFrame);
+    const float newOutput = decayTowards(outputDb, outputTarget, releaseDbPerFrame);
+
+    // Below a twentieth of a dB nobody sees the bar move
+    const bool changed = std::abs(newInput - inputDb) > 0.05f || std::abs(newOutput - outputDb) > 0.05f;
+    if (changed) {
+        inputDb = newInput;
+        outputDb = newOutput;
+    }
+
+    return changed;
+}
+
+bool AnalyserView::updatePassband() {
+    const auto band = DSPChain<float>::getModePassband(static_cast<int>(mode->load(std::memory_order_relaxed)),
+                                                        tap.getSampleRate(),
+                                                        lowCut->load(std::memory_order_relaxed),
+                                                        highCut->load(std::memory_order_relaxed));
+    if (band == passband)
+        return false;
+
+    passband = band;
+    return true;
+}
+
+//==============================================================================
+void AnalyserView::updateColumnBins() {
+    const int width = spectrumArea.getWidth();
+
+    columnBins.resize(static_cast<size_t>(width + 1));
+    spectrumDb.assign(static_cast<size_t>(width), floorDb);
+
+    // Log frequency axis: each column covers the bins up to the next column's frequency
+    for (int x = 0; x <= width; ++x) {
+        const float proportion = width > 0 ? static_cast<float>(x) / static_cast<float>(width) : 0.0f;
+        const float frequency = minFrequency * std::pow(maxFrequency / minFrequency, proportion);
+        const auto bin = static_cast<int>(frequency * fftSize / static_cast<float>(analysisRate));
+        columnBins[static_cast<size_t>(x)] = juce::jlimit(1, fftSize / 2, bin);
+    }
+}
+
+float AnalyserView::frequencyToX(float frequency) const {
+    const float proportion = std::log(juce::jlimit(minFrequency, maxFrequency, frequency) / minFrequency)
+                           / std::log(maxFrequency / minFrequency);
+    return static_cast<float>(spectrumArea.getX()) + proportion * static_cast<float>(spectrumArea.getWidth());
+}
+
+float AnalyserView::decayTowards(float current, float target, float releaseDb) {
+    // Instant attack, linear-in-dB release
+    return target >= current ? target : juce::jmax(target, current - releaseDb);
+}
+
+//==============================================================================
+void AnalyserView::paint(juce::Graphics& g) {
+    g.fillAll(juce::Colour(0xff15181c));
+
+    // Band kept by the current mode
+    const float bandLeft = frequencyToX(passband.first);
+    const float bandRight = frequencyToX(passband.second);
+    g.setColour(juce::Colour(0xff24303a));
+    g.fillRect(juce::Rectangle<float>(bandLeft, static_cast<float>(spectrumArea.getY()),
+                                      bandRight - bandLeft, static_cast<float>(spectrumArea.getHeight())));
+
+    // Decade lines
+    g.setColour(juce::Colours::white.withAlpha(0.1f));
+    for (float frequency : { 100.0f, 1000.0f, 10000.0f })
+        if (frequency < maxFrequency)
+            g.drawVerticalLine(juce::roundToInt(frequencyToX(frequency)),
+                               static_cast<float>(spectrumArea.getY()), static_cast<float>(spectrumArea.getBottom()));
+
+    // Spectrum: one point per pixel column
+    const auto toY = [this](float db) {
+        return juce::jmap(db, floorDb, 0.0f, static_cast<float>(spectrumArea.getBottom()),
+                          static_cast<float>(spectrumArea.getY()));
+    };
+
+    if (!spectrumDb.empty()) {
+        juce::Path spectrum;
+        spectrum.startNewSubPath(static_cast<float>(spectrumArea.getX()), toY(spectrumDb.front()));
+        for (size_t x = 1; x < spectrumDb.size(); ++x)
+            spectrum.lineTo(static_cast<float>(spectrumArea.getX()) + static_cast<float>(x), toY(spectrumDb[x]));
+
+        g.setColour(juce::Colour(0xff4fc3f7));
+        g.strokePath(spectrum, juce::PathStrokeType(1.2f));
+    }
+
+    // Meters: input and output peak, bottom-up
+    const auto drawMeter = [&](juce::Rectangle<int> area, float db, const juce::String& label) {
+        g.setColour(juce::Colours::white.withAlpha(0.6f));
+        g.setFont(10.0f);
+        g.drawText(label, area.removeFromBottom(12), juce::Justification::centred);
+
+        g.setColour(juce::Colour(0xff23272d));
+        g.fillRect(area);
+
+        const float height = juce::jmap(db, floorDb, 0.0f, 0.0f, static_cast<float>(area.getHeight()));
+        g.setColour(db > -1.0f ? juce::Colours::orangered : juce::Colour(0xff66bb6a));
+        g.fillRect(area.toFloat().removeFromBottom(height));
+    };
+
+    auto meters = meterArea.reduced(2, 0);
+    const int meterWidth = meters.getWidth() / 2;
+    drawMeter(meters.removeFromLeft(meterWidth).reduced(2, 0), inputDb, "IN");
+    drawMeter(meters.reduced(2, 0), outputDb, "OUT");
+}
+
+void AnalyserView::resized() {
+    auto area = getLocalBounds();
+    meterArea = area.removeFromRight(40);
+    spectrumArea = area;
+    updateColumnBins();
+}
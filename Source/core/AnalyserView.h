@@ -0,0 +1,81 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include "AnalysisTap.h"
+#include <vector>
+
+//==============================================================================
+/**
+ * AnalyserView - Input/output meters and output spectrum for the editor
+ *
+ * Everything here runs on the message thread at frameRate: drain the
+ * AnalysisTap frames into a history of the last fftSize samples, run one
+ * windowed FFT if anything arrived, smooth it per pixel column (instant
+ * attack, fixed dB release) and repaint only the part that changed
+ * (spectrum, meters, or neither once everything has decayed).
+ *
+ * The shaded region is the band the current mode keeps, read from the
+ * mode's filter chain (DSPChain::getModePassband()) and the Mode / Low Cut
+ * / High Cut parameters.
+ *
+ * The tap is active only while this view exists.
+ */
+class AnalyserView : public juce::Component,
+                     private juce::Timer {
+public:
+    AnalyserView(AnalysisTap& tapToRead, juce::AudioProcessorValueTreeState& state);
+    ~AnalyserView() override;
+
+    void paint(juce::Graphics&) override;
+    void resized() override;
+
+private:
+    //==========================================================================
+    void timerCallback() override;
+
+    bool readFrames();
+    bool updateSpectrum();
+    bool updateMeters();
+    bool updatePassband();
+    void updateColumnBins();
+
+    float frequencyToX(float frequency) const;
+    static float decayTowards(float current, float target, float releaseDb);
+
+    //==========================================================================
+    static constexpr int frameRate = 30;
+    static constexpr int fftOrder = 11;
+    static constexpr int fftSize = 1 << fftOrder;           ///< ~11 Hz bins at 22-24 kHz
+    static constexpr float minFrequency = 50.0f;
+    static constexpr float floorDb = -90.0f;
+    static constexpr float releaseDbPerFrame = 1.5f;        ///< 45 dB/s at 30 Hz
+
+    AnalysisTap& tap;
+    std::atomic<float>* mode = nullptr;
+    std::atomic<float>* lowCut = nullptr;
+    std::atomic<float>* highCut = nullptr;
+
+    // Analysis (message thread only)
+    juce::dsp::FFT fft { fftOrder };
+    juce::dsp::WindowingFunction<float> window { static_cast<size_t>(fftSize),
+                                                 juce::dsp::WindowingFunction<float>::hann, false };
+    std::vector<float> history;                              ///< Last fftSize samples, circular
+    std::vector<float> fftData;                              ///< 2 x fftSize for the real-only transform
+    int historyPos = 0;
+    bool newSamples = false;
+    double analysisRate = 0.0;
+    float maxFrequency = 11025.0f;                           ///< Right edge of the axis: the tap's alias-free band
+
+    // Display state
+    std::vector<int> columnBins;                             ///< First FFT bin of each pixel column (+ one past the end)
+    std::vector<float> spectrumDb;                           ///< Smoothed level per pixel column
+    float inputPeak = 0.0f, outputPeak = 0.0f;               ///< Largest block peak since the last frame
+    float inputDb = floorDb, outputDb = floorDb;             ///< Smoothed meter levels
+    std::pair<float, float> passband { 0.0f, 0.0f };
+
+    juce::Rectangle<int> spectrumArea, meterArea;
+
+    //==========================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnalyserView)
+};
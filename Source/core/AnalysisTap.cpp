@@ -0,0 +1,68 @@
+#include "AnalysisTap.h"
+
+//==============================================================================
+AnalysisTap::AnalysisTap() {
+    prepare(44100.0);
+}
+
+void AnalysisTap::prepare(double sampleRate) {
+    numStages = 0;
+    while (sampleRate / (1 << (numStages + 1)) >= minAnalysisRate && numStages < maxStages)
+        ++numStages;
+
+    // Every stage keeps the final passband; the early ones have wide transitions and few taps
+    const double analysisRate = sampleRate / (1 << numStages);
+    const double bandwidth = numStages > 0 ? passbandFraction * analysisRate : 0.5 * analysisRate;
+    for (int s = 0; s < numStages; ++s)
+        stages[s].design(sampleRate / (1 << s), bandwidth, attenuationDb);
+
+    // The last entry is the analysis-rate output (no history)
+    for (int s = 0; s <= numStages; ++s) {
+        const int history = s < numStages ? stages[s].getHistoryLength() : 0;
+        stageWork[s].assign(static_cast<size_t>(history + (chunkSize << (numStages - s))), 0.0f);
+    }
+
+    inputHistory = numStages > 0 ? stages[0].getHistoryLength() : 0;
+    analysisSampleRate.store(analysisRate, std::memory_order_relaxed);
+    analysisBandwidth.store(bandwidth, std::memory_order_relaxed);
+    hostSampleRate.store(sampleRate, std::memory_order_relaxed);
+
+    pending = Frame();
+    numBuffered = 0;
+}
+
+void AnalysisTap::decimateChunk() {
+    int count = chunkSize << numStages;
+
+    for (int s = 0; s < numStages; ++s) {
+        auto& work = stageWork[s];
+        const int history = stages[s].getHistoryLength();
+        const int nextHistory = s + 1 < numStages ? stages[s + 1].getHistoryLength() : 0;
+
+        stages[s].decimate(work.data() + history, count, stageWork[s + 1].data() + nextHistory);
+
+        // The stage's last input samples are the next chunk's history
+        std::copy(work.data() + count, work.data() + count + history, work.data());
+        count /= 2;
+    }
+
+    const auto* decimated = stageWork[numStages].data();
+    for (int i = 0; i < chunkSize; ++i) {
+        pending.samples[static_cast<size_t>(pending.numSamples++)] = decimated[i];
+
+        if (pending.numSamples == frameSize)
+            pushFrame();
+    }
+
+    numBuffered = 0;
+}
+
+void AnalysisTap::pushFrame() {
+    // Full queue: the editor is not keeping up, and a late frame is worth nothing to it
+    frames.push(pending);
+
+    // The block in progress goes on into the next frame, so it carries that block's peaks too
+    pending.numSamples = 0;
+    pending.inputPeak = blockInputPeak;
+    pending.outputPeak = blockOutputPeak;
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "../dsp/SPSCQueue.h"
+#include "../dsp/MultirateBand.h"
+#include <array>
+#include <atomic>
+#include <vector>
+
+//==============================================================================
+/**
+ * AnalysisTap - Levels and decimated audio from the audio thread to the editor
+ *
+ * While an editor is showing (setActive(true)), the audio thread records the
+ * input and output peak of every block and appends the output, summed to
+ * mono and decimated by 2 until it is about 24 kHz, to a Frame of frameSize
+ * samples. The decimation runs MultirateBand's half-band stages on chunks
+ * of the mono output, designed for 80 dB: measured at 44.1-192 kHz, every
+ * alias landing below getAnalysisBandwidth() is at least 80 dB down (the
+ * band above it, where the stages' transitions fold, is not displayed).
+ * Full frames go into a wait-free SPSC queue; a full queue drops the
+ * frame. That is all the audio thread does: FFT, smoothing and drawing
+ * happen in AnalyserView on the message thread.
+ *
+ * With no editor open, pushInput() / pushOutput() are not called at all
+ * (the processor checks isActive()), so closed editors cost nothing.
+ */
+class AnalysisTap {
+public:
+    static constexpr int frameSize = 128;
+
+    /** frameSize decimated mono samples plus the block peaks they came with. */
+    struct Frame {
+        float inputPeak = 0.0f;
+        float outputPeak = 0.0f;
+        int numSamples = 0;
+        std::array<float, frameSize> samples {};
+    };
+
+    AnalysisTap();
+
+    //==========================================================================
+    /** Designs the decimation for a sample rate and drops any partial frame (prepareToPlay). */
+    void prepare(double sampleRate);
+
+    /** Message thread: switched on while an editor is showing. */
+    void setActive(bool shouldBeActive) { active.store(shouldBeActive, std::memory_order_relaxed); }
+    bool isActive() const { return active.load(std::memory_order_relaxed); }
+
+    //==========================================================================
+    /** Audio thread, before processing: the block's input peak. */
+    template <typename SampleType>
+    void pushInput(const juce::AudioBuffer<SampleType>& buffer) {
+        blockInputPeak = static_cast<float>(buffer.getMagnitude(0, buffer.getNumSamples()));
+        pending.inputPeak = juce::jmax(pending.inputPeak, blockInputPeak);
+    }
+
+    /** Audio thread, after processing: the output peak and the decimated mono output. */
+    template <typename SampleType>
+    void pushOutput(const juce::AudioBuffer<SampleType>& buffer) {
+        const int numChannels = buffer.getNumChannels();
+        const int numSamples = buffer.getNumSamples();
+        if (numChannels == 0)
+            return;
+
+        blockOutputPeak = static_cast<float>(buffer.getMagnitude(0, numSamples));
+        pending.outputPeak = juce::jmax(pending.outputPeak, blockOutputPeak);
+
+        const auto* const* channels = buffer.getArrayOfReadPointers();
+        const float scale = 1.0f / static_cast<float>(numChannels);
+        const int chunkInput = chunkSize << numStages;
+        auto* input = stageWork[0].data() + inputHistory;
+
+        for (int i = 0; i < numSamples; ++i) {
+            float sum = 0.0f;
+            for (int ch = 0; ch < numChannels; ++ch)
+                sum += static_cast<float>(channels[ch][i]);
+
+            input[numBuffered] = sum * scale;
+            if (++numBuffered == chunkInput)
+                decimateChunk();
+        }
+    }
+
+    //==========================================================================
+    /** Message thread: the oldest full frame, if any. */
+    bool pop(Frame& frame) { return frames.pop(frame); }
+
+    /** Rate of the samples in the frames (host rate / 2^stages). */
+    double getAnalysisSampleRate() const { return analysisSampleRate.load(std::memory_order_relaxed); }
+
+    /** Highest frequency in the frames free of aliasing (the half-band passband edge). */
+    double getAnalysisBandwidth() const { return analysisBandwidth.load(std::memory_order_relaxed); }
+
+    /** The host rate given to prepare(). */
+    double getSampleRate() const { return hostSampleRate.load(std::memory_order_relaxed); }
+
+private:
+    //==========================================================================
+    void decimateChunk();
+    void pushFrame();
+
+    static constexpr double minAnalysisRate = 20000.0;  ///< 22.05-24 kHz at the usual host rates
+    static constexpr double passbandFraction = 0.45;    ///< Of the analysis rate: ~10-11 kHz, the whole voice band
+    static constexpr double attenuationDb = 80.0;       ///< Stopband target of every stage
+    static constexpr int maxStages = 4;                 ///< Up to 384 kHz
+    static constexpr int chunkSize = 32;                ///< Analysis samples per decimation pass
+    static constexpr std::size_t queueSize = 64;        ///< ~0.35 s of frames at 22-24 kHz
+
+    DSP::SPSCQueue<Frame, queueSize> frames;
+    Frame pending;
+    float blockInputPeak = 0.0f, blockOutputPeak = 0.0f;
+
+    // Half-band cascade: stageWork[s] holds the stage's history, then its input
+    DSP::HalfBandFilter<float> stages[maxStages];
+    std::vector<float> stageWork[maxStages + 1];
+    int numStages = 0;
+    int inputHistory = 0;   ///< History ahead of the first stage's input
+    int numBuffered = 0;
+
+    std::atomic<bool> active { false };
+    std::atomic<double> analysisSampleRate { 22050.0 };
+    std::atomic<double> analysisBandwidth { 9922.5 };
+    std::atomic<double> hostSampleRate { 44100.0 };
+
+    //==========================================================================
+    JUCE_DECLARE_NON_COPYABLE(AnalysisTap)
+};
@@ -0,0 +1,204 @@
+#include "ImpulseResponseLibrary.h"
+#include "../dsp/BiquadCoefficients.h"
+#include "../utils/DSPDefines.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+using Coefficients = DSP::BiquadCoefficients<double>;
+
+/** Runs one biquad over samples in place (transposed direct form II). */
+template <typename Sample>
+void applyBiquad(std::vector<Sample>& samples, const Coefficients& c) {
+    double s1 = 0.0, s2 = 0.0;
+
+    for (auto& sample : samples) {
+        const double x = sample;
+        const double y = c.b0 * x + s1;
+        s1 = c.b1 * x - c.a1 * y + s2;
+        s2 = c.b2 * x - c.a2 * y;
+        sample = static_cast<Sample>(y);
+    }
+}
+
+/** One section of a bundled response. */
+struct Section {
+    enum Type { HighPass, LowPass, Peak } type;
+    double frequency, q, gainDb;
+};
+
+/** An early copy of the direct sound (reflections inside the device's shell). */
+struct Reflection {
+    double delayMs, gain;
+};
+
+/** Length the bundled responses are rendered at, before trimming. */
+constexpr double bundledSeconds = 0.08;
+
+/** A bundled response: the reflections, then every section in series. */
+template <size_t numReflections, size_t numSections>
+std::vector<float> renderDevice(const Reflection (&reflections)[numReflections],
+                                const Section (&sections)[numSections], double sampleRate) {
+    std::vector<double> response(static_cast<size_t>(std::ceil(sampleRate * bundledSeconds)), 0.0);
+    for (const auto& reflection : reflections) {
+        const auto delay = static_cast<size_t>(std::lround(reflection.delayMs * 0.001 * sampleRate));
+        if (delay < response.size())
+            response[delay] += reflection.gain;
+    }
+
+    // Kept below Nyquist, so low host rates still get a stable design
+    for (const auto& section : sections) {
+        const double frequency = juce::jmin(section.frequency, 0.45 * sampleRate);
+
+        switch (section.type) {
+            case Section::HighPass: applyBiquad(response, Coefficients::makeHighPass(sampleRate, frequency, section.q)); break;
+            case Section::LowPass:  applyBiquad(response, Coefficients::makeLowPass(sampleRate, frequency, section.q)); break;
+            case Section::Peak:
+                applyBiquad(response, Coefficients::makePeak(sampleRate, frequency, section.q,
+                                                             juce::Decibels::decibelsToGain(section.gainDb)));
+                break;
+        }
+    }
+
+    return { response.begin(), response.end() };
+}
+
+} // namespace
+
+//==============================================================================
+juce::String ImpulseResponseLibrary::getBundledName(int index) {
+    static const char* const names[numBundled] = { "Handset", "Transceiver" };
+    return names[juce::jlimit(0, numBundled - 1, index)];
+}
+
+void ImpulseResponseLibrary::selectBundled(int index) {
+    bundledIndex = juce::jlimit(0, numBundled - 1, index);
+    filePath.clear();
+    fileSamples.clear();
+}
+
+bool ImpulseResponseLibrary::loadFile(const juce::File& file) {
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(file));
+    if (reader == nullptr || reader->lengthInSamples <= 0 || reader->sampleRate <= 0.0 || reader->numChannels == 0)
+        return false;
+
+    // Up to the cap plus a second of leading silence (trimmed in render())
+    const auto maxSamples = static_cast<juce::int64>(reader->sampleRate * (DSP::IMPULSE_RESPONSE_MAX_SECONDS + 1.0));
+    const int length = static_cast<int>(juce::jmin(reader->lengthInSamples, maxSamples));
+    const int numChannels = static_cast<int>(reader->numChannels);
+
+    juce::AudioBuffer<float> buffer(numChannels, length);
+    if (!reader->read(&buffer, 0, length, 0, true, true))
+        return false;
+
+    // Mono: the mode applies one response to every channel
+    std::vector<float> samples(static_cast<size_t>(length));
+    for (int ch = 0; ch < numChannels; ++ch)
+        juce::FloatVectorOperations::addWithMultiply(samples.data(), buffer.getReadPointer(ch),
+                                                     1.0f / static_cast<float>(numChannels), length);
+
+    if (juce::FloatVectorOperations::findMaximum(samples.data(), length) <= 0.0f
+        && juce::FloatVectorOperations::findMinimum(samples.data(), length) >= 0.0f)
+        return false;
+
+    fileSamples = std::move(samples);
+    fileSampleRate = reader->sampleRate;
+    filePath = file.getFullPathName();
+    return true;
+}
+
+juce::String ImpulseResponseLibrary::getName() const {
+    return filePath.isEmpty() ? getBundledName(bundledIndex) : juce::File(filePath).getFileNameWithoutExtension();
+}
+
+//==============================================================================
+std::vector<float> ImpulseResponseLibrary::render(double sampleRate) const {
+    auto response = filePath.isEmpty() ? renderBundled(bundledIndex, sampleRate)
+                                       : resample(fileSamples, fileSampleRate, sampleRate);
+    conform(response, sampleRate);
+    return response;
+}
+
+std::vector<float> ImpulseResponseLibrary::renderBundled(int index, double sampleRate) {
+    static const Reflection handsetReflections[] = { { 0.0, 1.0 }, { 0.35, 0.45 }, { 0.8, -0.25 }, { 1.6, 0.12 } };
+    static const Section handsetSections[] = {
+        { Section::HighPass, 300.0, 0.707, 0.0 }, { Section::HighPass, 300.0, 0.707, 0.0 },
+        { Section::LowPass, 3400.0, 0.707, 0.0 }, { Section::LowPass, 3400.0, 0.707, 0.0 },
+        { Section::Peak, 1100.0, 1.4, 5.0 },      { Section::Peak, 2600.0, 2.5, 6.0 }
+    };
+
+    static const Reflection transceiverReflections[] = { { 0.0, 1.0 }, { 0.6, 0.5 }, { 1.3, 0.3 }, { 2.1, -0.2 } };
+    static const Section transceiverSections[] = {
+        { Section::HighPass, 450.0, 0.9, 0.0 },  { Section::HighPass, 450.0, 0.7, 0.0 },
+        { Section::LowPass, 2700.0, 0.8, 0.0 },  { Section::LowPass, 2700.0, 0.6, 0.0 },
+        { Section::LowPass, 3200.0, 0.707, 0.0 },
+        { Section::Peak, 1700.0, 1.5, 7.0 },     { Section::Peak, 2300.0, 10.0, 9.0 }
+    };
+
+    return juce::jlimit(0, numBundled - 1, index) == 0
+               ? renderDevice(handsetReflections, handsetSections, sampleRate)
+               : renderDevice(transceiverReflections, transceiverSections, sampleRate);
+}
+
+std::vector<float> ImpulseResponseLibrary::resample(const std::vector<float>& source, double sourceRate, double targetRate) {
+    if (source.empty() || sourceRate == targetRate)
+        return source;
+
+    // The interpolator does not band-limit: downsampling gets an 8th-order Butterworth at 0.45 x the new rate
+    auto input = source;
+    if (sourceRate > targetRate)
+        for (const double q : { 0.5098, 0.6013, 0.9000, 2.5629 })
+            applyBiquad(input, Coefficients::makeLowPass(sourceRate, 0.45 * targetRate, q));
+
+    const double ratio = sourceRate / targetRate;
+    const int outputLength = static_cast<int>(std::ceil(static_cast<double>(source.size()) / ratio));
+
+    // The interpolator reads a few samples past the last one it produces
+    input.resize(input.size() + 8, 0.0f);
+
+    std::vector<float> output(static_cast<size_t>(outputLength));
+    juce::LagrangeInterpolator interpolator;
+    interpolator.process(ratio, input.data(), output.data(), outputLength);
+    return output;
+}
+
+void ImpulseResponseLibrary::conform(std::vector<float>& response, double sampleRate) {
+    if (response.empty())
+        return;
+
+    float peak = 0.0f;
+    for (const float sample : response)
+        peak = juce::jmax(peak, std::abs(sample));
+
+    if (peak <= 0.0f) {
+        response.assign(1, 0.0f);
+        return;
+    }
+
+    // Leading silence would only delay the effect (-60 dB); trailing below -80 dB is inaudible
+    const auto isAbove = [](float threshold) { return [threshold](float sample) { return std::abs(sample) > threshold; }; };
+    const auto first = std::find_if(response.begin(), response.end(), isAbove(peak * 1.0e-3f));
+    const auto last = std::find_if(response.rbegin(), response.rend(), isAbove(peak * 1.0e-4f)).base();
+    response = std::vector<float>(first, last);
+
+    // Capped: fade out over the last 10 ms instead of cutting off
+    const auto maxLength = static_cast<size_t>(DSP::IMPULSE_RESPONSE_MAX_SECONDS * sampleRate);
+    if (response.size() > maxLength) {
+        response.resize(maxLength);
+        const auto fadeLength = juce::jmin(maxLength, static_cast<size_t>(0.01 * sampleRate) + 1);
+        for (size_t i = 0; i < fadeLength; ++i)
+            response[maxLength - 1 - i] *= static_cast<float>(i) / static_cast<float>(fadeLength);
+    }
+
+    // Unit energy: broadband input keeps its level, whatever the response's length
+    double energy = 0.0;
+    for (const float sample : response)
+        energy += static_cast<double>(sample) * sample;
+
+    juce::FloatVectorOperations::multiply(response.data(), static_cast<float>(1.0 / std::sqrt(energy)),
+                                          static_cast<int>(response.size()));
+}
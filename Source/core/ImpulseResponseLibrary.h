@@ -0,0 +1,67 @@
+#pragma once
+
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <vector>
+
+//==============================================================================
+/**
+ * ImpulseResponseLibrary - The impulse response the IR mode convolves with
+ *
+ * Either one of the bundled device responses or a user audio file. The
+ * bundled ones are synthesised at the host rate from a few resonances and
+ * shell reflections (no sample data ships with the plugin):
+ *
+ *     Handset      carbon-mic telephone handset, 300 Hz - 3.4 kHz with
+ *                  earpiece resonances at 1.1 and 2.6 kHz
+ *     Transceiver  walkie-talkie speaker, narrower (450 Hz - 2.7 kHz) with
+ *                  a honky 1.7 kHz peak and a ringing cone at 2.3 kHz
+ *
+ * A file is read once, in loadFile(), and kept at its own rate; render()
+ * mixes it to mono, resamples it to the host rate, trims the silence at
+ * either end, caps it at DSP::IMPULSE_RESPONSE_MAX_SECONDS and normalises
+ * it to unit energy, so every response plays at about the level of the
+ * input whatever its length.
+ *
+ * Not thread-safe; PluginProcessor guards it with a lock (message thread
+ * and prepareToPlay()).
+ */
+class ImpulseResponseLibrary {
+public:
+    static constexpr int numBundled = 2;
+
+    /** Name of a bundled response (index 0 .. numBundled - 1). */
+    static juce::String getBundledName(int index);
+
+    //==========================================================================
+    /** Selects a bundled response (drops any loaded file; the index is clamped). */
+    void selectBundled(int index);
+
+    /** Reads an audio file (any format JUCE knows) and selects it.
+     *  Returns false and keeps the selection if it cannot be read or is silent.
+     */
+    bool loadFile(const juce::File& file);
+
+    /** The bundled response selected (the last one selected while a file is in use). */
+    int getBundledIndex() const { return bundledIndex; }
+
+    /** Path of the selected file (empty for a bundled response). */
+    const juce::String& getFilePath() const { return filePath; }
+
+    /** Display name: the bundled name or the file name. */
+    juce::String getName() const;
+
+    //==========================================================================
+    /** The selected response at sampleRate, conformed (see the class notes). */
+    std::vector<float> render(double sampleRate) const;
+
+private:
+    //==========================================================================
+    static std::vector<float> renderBundled(int index, double sampleRate);
+    static std::vector<float> resample(const std::vector<float>& source, double sourceRate, double targetRate);
+    static void conform(std::vector<float>& response, double sampleRate);
+
+    int bundledIndex = 0;
+    juce::String filePath;
+    std::vector<float> fileSamples;     ///< Mono, at fileSampleRate
+    double fileSampleRate = 44100.0;
+};
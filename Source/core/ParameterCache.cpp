@@ -0,0 +1,41 @@
+#include "ParameterCache.h"
+
+//==============================================================================
+ParameterCache::ParameterCache(juce::AudioProcessorValueTreeState& state)
+    : apvts(state)
+{
+    for (int i = 0; i < DSP::ParameterSnapshot::NumParameters; ++i) {
+        const auto index = static_cast<DSP::ParameterSnapshot::Index>(i);
+        auto& binding = bindings[static_cast<size_t>(i)];
+
+        binding.value = apvts.getRawParameterValue(DSP::ParameterSnapshot::parameterIds[i]);
+        binding.pending = &pending;
+        binding.bit = DSP::ParameterSnapshot::bit(index);
+        jassert(binding.value != nullptr);  // ID missing from createParameterLayout()
+
+        apvts.addParameterListener(DSP::ParameterSnapshot::parameterIds[i], &binding);
+    }
+}
+
+ParameterCache::~ParameterCache() {
+    for (int i = 0; i < DSP::ParameterSnapshot::NumParameters; ++i)
+        apvts.removeParameterListener(DSP::ParameterSnapshot::parameterIds[i], &bindings[static_cast<size_t>(i)]);
+}
+
+//==============================================================================
+const DSP::ParameterSnapshot& ParameterCache::update() {
+    // Bits are set after the raw value is stored, so acquiring them makes the new values visible
+    const auto changed = pending.exchange(0, std::memory_order_acquire);
+    snapshot.dirty = changed;
+
+    if (changed == 0)
+        return snapshot;
+
+    for (int i = 0; i < DSP::ParameterSnapshot::NumParameters; ++i) {
+        const auto index = static_cast<DSP::ParameterSnapshot::Index>(i);
+        if (snapshot.isDirty(index))
+            snapshot.setValue(index, bindings[static_cast<size_t>(i)].value->load(std::memory_order_relaxed));
+    }
+
+    return snapshot;
+}
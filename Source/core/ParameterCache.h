@@ -0,0 +1,51 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "../dsp/ParameterSnapshot.h"
+#include <array>
+#include <atomic>
+
+//==============================================================================
+/**
+ * ParameterCache - Resolves the APVTS parameters once, snapshots them per block
+ *
+ * The raw value pointers are looked up by ID at construction. Each parameter
+ * gets a listener that only sets its bit in an atomic "pending" mask, so
+ * update() on the audio thread is one atomic exchange when nothing changed,
+ * however many parameters there are; only the parameters that moved are
+ * reloaded, and their bits come back as the snapshot's dirty flags.
+ *
+ * The listeners run on whichever thread changed the parameter (host,
+ * message thread, preset load); they never lock or allocate.
+ */
+class ParameterCache {
+public:
+    explicit ParameterCache(juce::AudioProcessorValueTreeState& state);
+    ~ParameterCache();
+
+    /** Loads whatever changed since the last call; the returned snapshot stays valid until the next one. */
+    const DSP::ParameterSnapshot& update();
+
+    /** Makes the next update() reload (and flag) every parameter, e.g. before prepareToPlay. */
+    void markAllDirty() { pending.fetch_or(DSP::ParameterSnapshot::allDirty, std::memory_order_release); }
+
+private:
+    //==========================================================================
+    struct Binding : juce::AudioProcessorValueTreeState::Listener {
+        void parameterChanged(const juce::String&, float) override {
+            pending->fetch_or(bit, std::memory_order_release);
+        }
+
+        std::atomic<float>* value = nullptr;
+        std::atomic<std::uint32_t>* pending = nullptr;
+        std::uint32_t bit = 0;
+    };
+
+    juce::AudioProcessorValueTreeState& apvts;
+    std::array<Binding, DSP::ParameterSnapshot::NumParameters> bindings;
+    std::atomic<std::uint32_t> pending { DSP::ParameterSnapshot::allDirty };
+    DSP::ParameterSnapshot snapshot;
+
+    //==========================================================================
+    JUCE_DECLARE_NON_COPYABLE(ParameterCache)
+};
@@ -0,0 +1,128 @@
+#include "PerformanceMonitor.h"
+
+//==============================================================================
+PerformanceMonitor::PerformanceMonitor()
+    : ticksPerSecond(static_cast<double>(juce::Time::getHighResolutionTicksPerSecond())) {
+}
+
+PerformanceMonitor::~PerformanceMonitor() {
+}
+
+//==============================================================================
+PerformanceMonitor::BlockScope::BlockScope(PerformanceMonitor& monitorToUse, int numSamples, int numChannels,
+                                           double sampleRate)
+    : monitor(monitorToUse), timing(monitorToUse.isConsumerAttached()) {
+    if (!timing)
+        return;
+
+    auto& profile = monitor.profile;
+    profile.begin(juce::Time::getHighResolutionTicks());
+    profile.numSamples = numSamples;
+    profile.numChannels = numChannels;
+    profile.sampleRate = sampleRate;
+}
+
+PerformanceMonitor::BlockScope::~BlockScope() {
+    if (!timing)
+        return;
+
+    auto& profile = monitor.profile;
+    profile.blockTicks = juce::Time::getHighResolutionTicks() - profile.startTicks;
+
+    if (profile.blockTicks > profile.getBudgetTicks(monitor.ticksPerSecond))
+        monitor.overruns.fetch_add(1, std::memory_order_relaxed);
+
+    // Full queue: nobody is reading fast enough, the record is not worth waiting for
+    if (!monitor.records.push(profile))
+        monitor.dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+//==============================================================================
+void PerformanceMonitor::setConsumerAttached(bool shouldBeAttached) {
+    // Records left from the previous editor would show up as one long poll
+    if (shouldBeAttached) {
+        DSP::BlockProfile stale;
+        while (records.pop(stale)) {}
+    }
+
+    consumerAttached.store(shouldBeAttached, std::memory_order_relaxed);
+}
+
+PerformanceMonitor::Summary PerformanceMonitor::poll() {
+    Summary summary;
+    double busyTicks = 0.0, budgetTicks = 0.0;
+    juce::int64 peakTicks = 0;
+
+    DSP::BlockProfile record;
+    while (records.pop(record)) {
+        ++summary.numBlocks;
+        busyTicks += static_cast<double>(record.blockTicks);
+        budgetTicks += record.getBudgetTicks(ticksPerSecond);
+        peakTicks = juce::jmax(peakTicks, record.blockTicks);
+
+        if (csv != nullptr)
+            writeCsvLine(record);
+    }
+
+    if (budgetTicks > 0.0)
+        summary.loadPercent = 100.0 * busyTicks / budgetTicks;
+
+    summary.peakBlockMs = 1000.0 * static_cast<double>(peakTicks) / ticksPerSecond;
+    summary.overruns = overruns.load(std::memory_order_relaxed);
+    summary.dropped = dropped.load(std::memory_order_relaxed);
+    return summary;
+}
+
+//==============================================================================
+bool PerformanceMonitor::startCsvExport(const juce::File& file) {
+    stopCsvExport();
+
+    auto stream = std::make_unique<juce::FileOutputStream>(file);
+    if (!stream->openedOk())
+        return false;
+
+    stream->setPosition(0);
+    stream->truncate();
+
+    // One row per block, times in microseconds; control = chain minus its nested stages
+    juce::String header("time_s,sample_rate,block_size,channels,block_us,load_percent,overrun");
+    for (const auto* name : DSP::BlockProfile::stageNames)
+        header << "," << name << "_us";
+    header << ",control_us\n";
+    stream->writeText(header, false, false, nullptr);
+
+    csv = std::move(stream);
+    csvStartTicks = juce::Time::getHighResolutionTicks();
+    return true;
+}
+
+void PerformanceMonitor::stopCsvExport() {
+    if (csv != nullptr)
+        csv->flush();
+    csv.reset();
+}
+
+void PerformanceMonitor::writeCsvLine(const DSP::BlockProfile& record) {
+    using Stage = DSP::BlockProfile::Stage;
+    const auto toMicroseconds = [this](juce::int64 ticks) { return 1.0e6 * static_cast<double>(ticks) / ticksPerSecond; };
+
+    // Records queued before the export started have negative times; that is fine for a log
+    const auto budget = record.getBudgetTicks(ticksPerSecond);
+    juce::String line;
+    line << juce::String(static_cast<double>(record.startTicks - csvStartTicks) / ticksPerSecond, 6) << ","
+         << record.sampleRate << "," << record.numSamples << "," << record.numChannels << ","
+         << juce::String(toMicroseconds(record.blockTicks), 3) << ","
+         << juce::String(budget > 0.0 ? 100.0 * static_cast<double>(record.blockTicks) / budget : 0.0, 2) << ","
+         << (record.blockTicks > budget ? 1 : 0);
+
+    for (int stage = 0; stage < DSP::BlockProfile::NumStages; ++stage)
+        line << "," << juce::String(toMicroseconds(record.stageTicks[stage]), 3);
+
+    const auto controlTicks = record.stageTicks[Stage::Chain] - record.stageTicks[Stage::Filters]
+                            - record.stageTicks[Stage::Transition] - record.stageTicks[Stage::MonoMix]
+                            - record.stageTicks[Stage::Saturation] - record.stageTicks[Stage::Noise]
+                            - record.stageTicks[Stage::Output];
+    line << "," << juce::String(toMicroseconds(controlTicks), 3) << "\n";
+
+    csv->writeText(line, false, false, nullptr);
+}
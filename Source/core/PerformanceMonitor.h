@@ -0,0 +1,92 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include "../dsp/BlockProfile.h"
+#include "../dsp/SPSCQueue.h"
+#include <atomic>
+#include <memory>
+
+//==============================================================================
+/**
+ * PerformanceMonitor - Per-block timing from the audio thread to the editor
+ *
+ * The audio thread wraps each processBlock() in a BlockScope: it starts a
+ * DSP::BlockProfile (DSPChain adds its stage times to it, see
+ * DSPChain::setProfile()), stamps the block's total time and shape, counts
+ * an overrun if the block took longer than its own audio lasts, and pushes
+ * the record into a wait-free SPSC queue. When the queue is full (the
+ * editor is not keeping up) the record is dropped and counted; the audio
+ * thread never waits, locks or allocates.
+ *
+ * Only while a consumer is attached (setConsumerAttached(), an open editor)
+ * is anything timed: otherwise BlockScope reads no clock, hands out no
+ * profile and pushes nothing, so closed editors cost nothing.
+ *
+ * The editor's timer calls poll() on the message thread, which drains the
+ * queue into a Summary (load, peak block time, overruns) and, while a CSV
+ * export is running, appends one line per block to the file.
+ */
+class PerformanceMonitor {
+public:
+    PerformanceMonitor();
+    ~PerformanceMonitor();
+
+    //==========================================================================
+    /** Times one block on the audio thread, from construction to destruction. */
+    class BlockScope {
+    public:
+        BlockScope(PerformanceMonitor& monitorToUse, int numSamples, int numChannels, double sampleRate);
+        ~BlockScope();
+
+        BlockScope(const BlockScope&) = delete;
+        BlockScope& operator=(const BlockScope&) = delete;
+
+        /** The record of this block (pass it to DSPChain::setProfile()); nullptr if nobody is attached. */
+        DSP::BlockProfile* getProfile() const { return timing ? &monitor.profile : nullptr; }
+
+    private:
+        PerformanceMonitor& monitor;
+        const bool timing;
+    };
+
+    /** Message thread: switched on while an editor is showing (attaching drops stale records). */
+    void setConsumerAttached(bool shouldBeAttached);
+    bool isConsumerAttached() const { return consumerAttached.load(std::memory_order_relaxed); }
+
+    //==========================================================================
+    /** What poll() gathered since the previous call. */
+    struct Summary {
+        int numBlocks = 0;
+        double loadPercent = 0.0;       ///< Processing time / audio time of those blocks
+        double peakBlockMs = 0.0;       ///< Slowest of those blocks
+        juce::int64 overruns = 0;       ///< Blocks over their budget while attached, since the plugin was created
+        juce::int64 dropped = 0;        ///< Records lost to a full queue, likewise
+    };
+
+    /** Message thread: drains the queue (writing CSV lines if exporting). */
+    Summary poll();
+
+    /** Message thread: starts appending every block to a CSV file (header first). */
+    bool startCsvExport(const juce::File& file);
+    void stopCsvExport();
+    bool isExportingCsv() const { return csv != nullptr; }
+
+private:
+    //==========================================================================
+    void writeCsvLine(const DSP::BlockProfile& record);
+
+    static constexpr std::size_t queueSize = 1024;  ///< A 10 Hz poll of 32-sample blocks at 192 kHz, with headroom
+
+    DSP::BlockProfile profile;
+    DSP::SPSCQueue<DSP::BlockProfile, queueSize> records;
+    std::atomic<juce::int64> overruns { 0 };
+    std::atomic<juce::int64> dropped { 0 };
+    std::atomic<bool> consumerAttached { false };
+
+    const double ticksPerSecond;
+    std::unique_ptr<juce::FileOutputStream> csv;
+    juce::int64 csvStartTicks = 0;
+
+    //==========================================================================
+    JUCE_DECLARE_NON_COPYABLE(PerformanceMonitor)
+};
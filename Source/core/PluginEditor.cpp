@@ -2,14 +2,17 @@
 
 //==============================================================================
 PluginEditor::PluginEditor(PluginProcessor& p)
-    : AudioProcessorEditor(&p), processor(p) {
+    : AudioProcessorEditor(&p), processor(p), analyser(p.getAnalysisTap(), p.apvts) {
     // Set editor size
-    setSize(400, 300);
+    setSize(400, 780);
 
     // Mode ComboBox
     modeCombo.addItem("Telephone", 1);
     modeCombo.addItem("Radio", 2);
     modeCombo.addItem("Custom", 3);
+    modeCombo.addItem("IR", 4);
+    modeCombo.addItem("u-Law", 5);
+    modeCombo.addItem("A-Law", 6);
     modeCombo.setSelectedItemIndex(0);
     addAndMakeVisible(modeCombo);
 
@@ -17,6 +20,11 @@ PluginEditor::PluginEditor(PluginProcessor& p)
     modeLabel.attachToComponent(&modeCombo, true);
     addAndMakeVisible(modeLabel);
 
+    // Impulse response for the IR mode, alongside the mode
+    refreshImpulseResponseCombo();
+    impulseResponseCombo.onChange = [this] { impulseResponseChosen(); };
+    addAndMakeVisible(impulseResponseCombo);
+
     // Mix Slider
     mixSlider.setSliderStyle(juce::Slider::LinearHorizontal);
     mixSlider.setRange(0.0, 1.0, 0.01);
@@ -27,11 +35,125 @@ PluginEditor::PluginEditor(PluginProcessor& p)
     mixLabel.attachToComponent(&mixSlider, true);
     addAndMakeVisible(mixLabel);
 
+    // Low Cut / High Cut Sliders (range and skew come from the parameters)
+    for (auto* slider : { &lowCutSlider, &highCutSlider }) {
+        slider->setSliderStyle(juce::Slider::LinearHorizontal);
+        slider->setTextBoxStyle(juce::Slider::TextBoxRight, false, 60, 20);
+        slider->setTextValueSuffix(" Hz");
+        addAndMakeVisible(*slider);
+    }
+
+    lowCutLabel.setText("Low Cut:", juce::dontSendNotification);
+    lowCutLabel.attachToComponent(&lowCutSlider, true);
+    addAndMakeVisible(lowCutLabel);
+
+    highCutLabel.setText("High Cut:", juce::dontSendNotification);
+    highCutLabel.attachToComponent(&highCutSlider, true);
+    addAndMakeVisible(highCutLabel);
+
+    // Drift / Drift Rate Sliders
+    driftSlider.setSliderStyle(juce::Slider::LinearHorizontal);
+    driftSlider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 50, 20);
+    addAndMakeVisible(driftSlider);
+
+    driftLabel.setText("Drift:", juce::dontSendNotification);
+    driftLabel.attachToComponent(&driftSlider, true);
+    addAndMakeVisible(driftLabel);
+
+    driftRateSlider.setSliderStyle(juce::Slider::LinearHorizontal);
+    driftRateSlider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 60, 20);
+    driftRateSlider.setTextValueSuffix(" Hz");
+    addAndMakeVisible(driftRateSlider);
+
+    driftRateLabel.setText("Drift Rate:", juce::dontSendNotification);
+    driftRateLabel.attachToComponent(&driftRateSlider, true);
+    addAndMakeVisible(driftRateLabel);
+
+    // Saturation Slider, with its oversampling factor alongside
+    saturationSlider.setSliderStyle(juce::Slider::LinearHorizontal);
+    saturationSlider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 50, 20);
+    addAndMakeVisible(saturationSlider);
+
+    saturationLabel.setText("Saturation:", juce::dontSendNotification);
+    saturationLabel.attachToComponent(&saturationSlider, true);
+    addAndMakeVisible(saturationLabel);
+
+    oversamplingCombo.addItem("1x (Off)", 1);
+    oversamplingCombo.addItem("2x", 2);
+    oversamplingCombo.addItem("4x", 3);
+    oversamplingCombo.setSelectedItemIndex(0);
+    addAndMakeVisible(oversamplingCombo);
+
+    // Noise Level Slider, with the noise mode alongside
+    noiseLevelSlider.setSliderStyle(juce::Slider::LinearHorizontal);
+    noiseLevelSlider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 60, 20);
+    noiseLevelSlider.setTextValueSuffix(" dB");
+    addAndMakeVisible(noiseLevelSlider);
+
+    noiseLabel.setText("Noise:", juce::dontSendNotification);
+    noiseLabel.attachToComponent(&noiseLevelSlider, true);
+    addAndMakeVisible(noiseLabel);
+
+    noiseModeCombo.addItem("Off", 1);
+    noiseModeCombo.addItem("Hiss", 2);
+    noiseModeCombo.addItem("Vinyl", 3);
+    noiseModeCombo.setSelectedItemIndex(0);
+    addAndMakeVisible(noiseModeCombo);
+
+    // Packet Loss Slider, with the codec's bit depth alongside (u-Law / A-Law modes)
+    packetLossSlider.setSliderStyle(juce::Slider::LinearHorizontal);
+    packetLossSlider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 60, 20);
+    packetLossSlider.setTextValueSuffix(" %");
+    addAndMakeVisible(packetLossSlider);
+
+    packetLossLabel.setText("Loss:", juce::dontSendNotification);
+    packetLossLabel.attachToComponent(&packetLossSlider, true);
+    addAndMakeVisible(packetLossLabel);
+
+    for (int bits = 8; bits >= 2; --bits)
+        codecBitsCombo.addItem(juce::String(bits) + " bit", 9 - bits);
+    codecBitsCombo.setSelectedItemIndex(0);
+    addAndMakeVisible(codecBitsCombo);
+
+    // Output Gain Slider, with the limiter toggle alongside
+    outputGainSlider.setSliderStyle(juce::Slider::LinearHorizontal);
+    outputGainSlider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 60, 20);
+    outputGainSlider.setTextValueSuffix(" dB");
+    addAndMakeVisible(outputGainSlider);
+
+    outputGainLabel.setText("Output:", juce::dontSendNotification);
+    outputGainLabel.attachToComponent(&outputGainSlider, true);
+    addAndMakeVisible(outputGainLabel);
+
+    limiterButton.setButtonText("Limiter");
+    addAndMakeVisible(limiterButton);
+
     // Enabled Toggle Button
     enabledButton.setButtonText("Enabled");
     enabledButton.setToggleState(true, juce::dontSendNotification);
     addAndMakeVisible(enabledButton);
 
+    // Multirate Toggle Button
+    multirateButton.setButtonText("Multirate");
+    addAndMakeVisible(multirateButton);
+
+    // Force Mono Toggle Button
+    forceMonoButton.setButtonText("Force Mono");
+    addAndMakeVisible(forceMonoButton);
+
+    // CPU readout and CSV logging
+    cpuLabel.setFont(cpuLabel.getFont().withHeight(12.0f));
+    cpuLabel.setJustificationType(juce::Justification::centredLeft);
+    addAndMakeVisible(cpuLabel);
+
+    csvButton.setButtonText("Log CSV");
+    csvButton.setClickingTogglesState(true);
+    csvButton.onClick = [this] { toggleCsvExport(); };
+    addAndMakeVisible(csvButton);
+
+    // Meters and spectrum
+    addAndMakeVisible(analyser);
+
     // Create APVTS attachments
     modeAttachment = std::make_unique<ComboBoxAttachment>(
         processor.apvts, "mode", modeCombo
@@ -41,12 +163,155 @@ PluginEditor::PluginEditor(PluginProcessor& p)
         processor.apvts, "mix", mixSlider
     );
 
+    lowCutAttachment = std::make_unique<SliderAttachment>(
+        processor.apvts, "lowCut", lowCutSlider
+    );
+
+    highCutAttachment = std::make_unique<SliderAttachment>(
+        processor.apvts, "highCut", highCutSlider
+    );
+
+    driftAttachment = std::make_unique<SliderAttachment>(
+        processor.apvts, "drift", driftSlider
+    );
+
+    driftRateAttachment = std::make_unique<SliderAttachment>(
+        processor.apvts, "driftRate", driftRateSlider
+    );
+
+    saturationAttachment = std::make_unique<SliderAttachment>(
+        processor.apvts, "saturation", saturationSlider
+    );
+
+    oversamplingAttachment = std::make_unique<ComboBoxAttachment>(
+        processor.apvts, "saturationOversampling", oversamplingCombo
+    );
+
+    noiseLevelAttachment = std::make_unique<SliderAttachment>(
+        processor.apvts, "noiseLevel", noiseLevelSlider
+    );
+
+    noiseModeAttachment = std::make_unique<ComboBoxAttachment>(
+        processor.apvts, "noiseMode", noiseModeCombo
+    );
+
+    packetLossAttachment = std::make_unique<SliderAttachment>(
+        processor.apvts, "packetLoss", packetLossSlider
+    );
+
+    codecBitsAttachment = std::make_unique<ComboBoxAttachment>(
+        processor.apvts, "codecBits", codecBitsCombo
+    );
+
+    outputGainAttachment = std::make_unique<SliderAttachment>(
+        processor.apvts, "outputGain", outputGainSlider
+    );
+
+    limiterAttachment = std::make_unique<ButtonAttachment>(
+        processor.apvts, "limiter", limiterButton
+    );
+
     enabledAttachment = std::make_unique<ButtonAttachment>(
         processor.apvts, "enabled", enabledButton
     );
+
+    multirateAttachment = std::make_unique<ButtonAttachment>(
+        processor.apvts, "multirate", multirateButton
+    );
+
+    forceMonoAttachment = std::make_unique<ButtonAttachment>(
+        processor.apvts, "forceMono", forceMonoButton
+    );
+
+    processor.getPerformanceMonitor().setConsumerAttached(true);
+    startTimerHz(10);
 }
 
 PluginEditor::~PluginEditor() {
+    stopTimer();
+    processor.getPerformanceMonitor().setConsumerAttached(false);
+    processor.getPerformanceMonitor().stopCsvExport();
+}
+
+//==============================================================================
+void PluginEditor::timerCallback() {
+    // A state load can change the response behind the editor's back
+    if (!(processor.getImpulseResponse() == shownImpulseResponse))
+        refreshImpulseResponseCombo();
+
+    const auto summary = processor.getPerformanceMonitor().poll();
+
+    // No blocks since the last tick (transport stopped): keep the last reading
+    if (summary.numBlocks == 0)
+        return;
+
+    cpuLabel.setText("CPU " + juce::String(summary.loadPercent, 1) + "%   peak "
+                         + juce::String(summary.peakBlockMs, 2) + " ms   overruns "
+                         + juce::String(summary.overruns),
+                     juce::dontSendNotification);
+}
+
+void PluginEditor::toggleCsvExport() {
+    auto& monitor = processor.getPerformanceMonitor();
+
+    if (!csvButton.getToggleState()) {
+        monitor.stopCsvExport();
+        return;
+    }
+
+    // One new file per run, next to the user's documents
+    const auto file = juce::File::getSpecialLocation(juce::File::userDocumentsDirectory)
+                          .getNonexistentChildFile("paranoidFilteroid-profile", ".csv");
+
+    if (!monitor.startCsvExport(file))
+        csvButton.setToggleState(false, juce::dontSendNotification);
+}
+
+void PluginEditor::refreshImpulseResponseCombo() {
+    shownImpulseResponse = processor.getImpulseResponse();
+    impulseResponseCombo.clear(juce::dontSendNotification);
+
+    for (int i = 0; i < ImpulseResponseLibrary::numBundled; ++i)
+        impulseResponseCombo.addItem(ImpulseResponseLibrary::getBundledName(i), i + 1);
+
+    if (shownImpulseResponse.filePath.isNotEmpty())
+        impulseResponseCombo.addItem(processor.getImpulseResponseName(), impulseResponseFileId);
+
+    impulseResponseCombo.addSeparator();
+    impulseResponseCombo.addItem("Load file...", impulseResponseLoadId);
+
+    impulseResponseCombo.setSelectedId(shownImpulseResponse.filePath.isNotEmpty() ? impulseResponseFileId
+                                                                                  : shownImpulseResponse.bundledIndex + 1,
+                                       juce::dontSendNotification);
+}
+
+void PluginEditor::impulseResponseChosen() {
+    const int id = impulseResponseCombo.getSelectedId();
+
+    if (id == impulseResponseLoadId) {
+        chooseImpulseResponseFile();
+        return;
+    }
+
+    if (id >= 1 && id <= ImpulseResponseLibrary::numBundled)
+        processor.selectImpulseResponse(id - 1);
+
+    refreshImpulseResponseCombo();
+}
+
+void PluginEditor::chooseImpulseResponseFile() {
+    impulseResponseChooser = std::make_unique<juce::FileChooser>("Load Impulse Response", juce::File(),
+                                                                 "*.wav;*.aif;*.aiff;*.flac");
+
+    impulseResponseChooser->launchAsync(juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles,
+                                        [this](const juce::FileChooser& chooser) {
+        // Cancelled or unreadable: the combo goes back to the response in use
+        const auto file = chooser.getResult();
+        if (file.existsAsFile())
+            processor.loadImpulseResponseFile(file);
+
+        refreshImpulseResponseCombo();
+    });
 }
 
 //==============================================================================
@@ -63,14 +328,82 @@ void PluginEditor::resized() {
     // Mode ComboBox (with label space)
     auto modeArea = area.removeFromTop(30);
     modeCombo.setBounds(modeArea.removeFromLeft(100));
+    modeArea.removeFromLeft(10);
+    impulseResponseCombo.setBounds(modeArea.removeFromLeft(150));
 
     // Mix Slider (with label space)
     area.removeFromTop(10);
     auto mixArea = area.removeFromTop(30);
     mixSlider.setBounds(mixArea.removeFromLeft(200));
 
+    // Low Cut / High Cut Sliders
+    area.removeFromTop(10);
+    auto lowCutArea = area.removeFromTop(30);
+    lowCutSlider.setBounds(lowCutArea.removeFromLeft(210));
+
+    area.removeFromTop(10);
+    auto highCutArea = area.removeFromTop(30);
+    highCutSlider.setBounds(highCutArea.removeFromLeft(210));
+
+    // Drift / Drift Rate Sliders
+    area.removeFromTop(10);
+    auto driftArea = area.removeFromTop(30);
+    driftSlider.setBounds(driftArea.removeFromLeft(200));
+
+    area.removeFromTop(10);
+    auto driftRateArea = area.removeFromTop(30);
+    driftRateSlider.setBounds(driftRateArea.removeFromLeft(210));
+
+    // Saturation Slider and oversampling factor
+    area.removeFromTop(10);
+    auto saturationArea = area.removeFromTop(30);
+    saturationSlider.setBounds(saturationArea.removeFromLeft(200));
+    saturationArea.removeFromLeft(10);
+    oversamplingCombo.setBounds(saturationArea.removeFromLeft(90));
+
+    // Noise Level Slider and mode
+    area.removeFromTop(10);
+    auto noiseArea = area.removeFromTop(30);
+    noiseLevelSlider.setBounds(noiseArea.removeFromLeft(210));
+    noiseArea.removeFromLeft(10);
+    noiseModeCombo.setBounds(noiseArea.removeFromLeft(80));
+
+    // Packet Loss Slider and codec bits
+    area.removeFromTop(10);
+    auto codecArea = area.removeFromTop(30);
+    packetLossSlider.setBounds(codecArea.removeFromLeft(210));
+    codecArea.removeFromLeft(10);
+    codecBitsCombo.setBounds(codecArea.removeFromLeft(80));
+
+    // Output Gain Slider and limiter
+    area.removeFromTop(10);
+    auto outputArea = area.removeFromTop(30);
+    outputGainSlider.setBounds(outputArea.removeFromLeft(210));
+    outputArea.removeFromLeft(10);
+    limiterButton.setBounds(outputArea.removeFromLeft(80));
+
     // Enabled Toggle Button
     area.removeFromTop(10);
     auto enabledArea = area.removeFromTop(30);
     enabledButton.setBounds(enabledArea.removeFromLeft(100));
+
+    // Multirate Toggle Button
+    area.removeFromTop(10);
+    auto multirateArea = area.removeFromTop(30);
+    multirateButton.setBounds(multirateArea.removeFromLeft(100));
+
+    // Force Mono Toggle Button
+    area.removeFromTop(10);
+    auto forceMonoArea = area.removeFromTop(30);
+    forceMonoButton.setBounds(forceMonoArea.removeFromLeft(100));
+
+    // CPU readout with the CSV toggle on its right
+    area.removeFromTop(10);
+    auto cpuArea = area.removeFromTop(30);
+    csvButton.setBounds(cpuArea.removeFromRight(70));
+    cpuLabel.setBounds(cpuArea);
+
+    // Meters and spectrum fill the rest
+    area.removeFromTop(10);
+    analyser.setBounds(area);
 }
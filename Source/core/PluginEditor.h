@@ -2,9 +2,11 @@
 
 #include <juce_gui_extra/juce_gui_extra.h>
 #include "PluginProcessor.h"
+#include "AnalyserView.h"
 
 //==============================================================================
-class PluginEditor : public juce::AudioProcessorEditor {
+class PluginEditor : public juce::AudioProcessorEditor,
+                     private juce::Timer {
 public:
     explicit PluginEditor(PluginProcessor&);
     ~PluginEditor() override;
@@ -13,6 +15,16 @@ public:
     void resized() override;
 
 private:
+    //==========================================================================
+    // Polls the processor's PerformanceMonitor for the CPU readout
+    void timerCallback() override;
+    void toggleCsvExport();
+
+    // IR mode's response: bundled entries, the loaded file (if any) and "Load file..."
+    void refreshImpulseResponseCombo();
+    void impulseResponseChosen();
+    void chooseImpulseResponseFile();
+
     //==========================================================================
     // Attachment types
     using SliderAttachment = juce::AudioProcessorValueTreeState::SliderAttachment;
@@ -26,15 +38,72 @@ private:
     juce::ComboBox modeCombo;
     juce::Label modeLabel;
 
+    juce::ComboBox impulseResponseCombo;
+    std::unique_ptr<juce::FileChooser> impulseResponseChooser;
+    PluginState::ImpulseResponseReference shownImpulseResponse;   ///< What the combo shows (refreshed on change)
+    static constexpr int impulseResponseFileId = 100;
+    static constexpr int impulseResponseLoadId = 101;
+
     juce::Slider mixSlider;
     juce::Label mixLabel;
 
+    juce::Slider lowCutSlider;
+    juce::Label lowCutLabel;
+
+    juce::Slider highCutSlider;
+    juce::Label highCutLabel;
+
+    juce::Slider driftSlider;
+    juce::Label driftLabel;
+
+    juce::Slider driftRateSlider;
+    juce::Label driftRateLabel;
+
+    juce::Slider saturationSlider;
+    juce::Label saturationLabel;
+    juce::ComboBox oversamplingCombo;
+
+    juce::Slider noiseLevelSlider;
+    juce::Label noiseLabel;
+    juce::ComboBox noiseModeCombo;
+
+    juce::Slider packetLossSlider;
+    juce::Label packetLossLabel;
+    juce::ComboBox codecBitsCombo;
+
+    juce::Slider outputGainSlider;
+    juce::Label outputGainLabel;
+    juce::ToggleButton limiterButton;
+
     juce::ToggleButton enabledButton;
+    juce::ToggleButton multirateButton;
+    juce::ToggleButton forceMonoButton;
+
+    // CPU readout (load, peak block time, overruns) and per-block CSV logging
+    juce::Label cpuLabel;
+    juce::TextButton csvButton;
+
+    // Input/output meters and output spectrum (taps the audio only while the editor is open)
+    AnalyserView analyser;
 
     // Attachments (must be members to keep alive)
     std::unique_ptr<ComboBoxAttachment> modeAttachment;
     std::unique_ptr<SliderAttachment> mixAttachment;
+    std::unique_ptr<SliderAttachment> lowCutAttachment;
+    std::unique_ptr<SliderAttachment> highCutAttachment;
+    std::unique_ptr<SliderAttachment> driftAttachment;
+    std::unique_ptr<SliderAttachment> driftRateAttachment;
+    std::unique_ptr<SliderAttachment> saturationAttachment;
+    std::unique_ptr<ComboBoxAttachment> oversamplingAttachment;
+    std::unique_ptr<SliderAttachment> noiseLevelAttachment;
+    std::unique_ptr<ComboBoxAttachment> noiseModeAttachment;
+    std::unique_ptr<SliderAttachment> packetLossAttachment;
+    std::unique_ptr<ComboBoxAttachment> codecBitsAttachment;
+    std::unique_ptr<SliderAttachment> outputGainAttachment;
+    std::unique_ptr<ButtonAttachment> limiterAttachment;
     std::unique_ptr<ButtonAttachment> enabledAttachment;
+    std::unique_ptr<ButtonAttachment> multirateAttachment;
+    std::unique_ptr<ButtonAttachment> forceMonoAttachment;
 
     //==========================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginEditor)
@@ -6,10 +6,11 @@
 juce::AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParameterLayout() {
     juce::AudioProcessorValueTreeState::ParameterLayout layout;
 
-    // Mode parameter: Telephone / Radio / Custom
+    // Mode parameter: Telephone / Radio / Custom / IR (convolution with the selected impulse response)
+    // / u-Law / A-Law (the Telephone band through a G.711 phone line)
     layout.add(std::make_unique<juce::AudioParameterChoice>(
         "mode", "Mode",
-        juce::StringArray("Telephone", "Radio", "Custom"),
+        juce::StringArray("Telephone", "Radio", "Custom", "IR", "u-Law", "A-Law"),
         0  // default: Telephone
     ));
 
@@ -20,12 +21,107 @@ juce::AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParam
         1.0f  // default: 100% (wet)
     ));
 
+    // Low Cut parameter: telephone band high-pass, 100–1000 Hz (skewed towards the low end)
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        "lowCut", "Low Cut",
+        juce::NormalisableRange<float>(100.0f, 1000.0f, 1.0f, 0.5f),
+        DSP::TELEPHONE_LOW_CUT_HZ  // default: 300 Hz
+    ));
+
+    // High Cut parameter: telephone band low-pass, 2000–8000 Hz
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        "highCut", "High Cut",
+        juce::NormalisableRange<float>(2000.0f, 8000.0f, 1.0f, 0.5f),
+        DSP::TELEPHONE_HIGH_CUT_HZ  // default: 3400 Hz
+    ));
+
+    // Drift parameter: cutoff wobble/drift amount, 0–100% (0 = static filters)
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        "drift", "Drift",
+        0.0f, 1.0f,  // range (1.0 = +/- DSP::DRIFT_MAX_DEPTH_OCTAVES)
+        0.0f  // default: off
+    ));
+
+    // Drift Rate parameter: wobble speed, 0.05–10 Hz (skewed towards slow drift)
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        "driftRate", "Drift Rate",
+        juce::NormalisableRange<float>(0.05f, 10.0f, 0.01f, 0.4f),
+        0.5f  // default: 0.5 Hz
+    ));
+
     // Enabled parameter: bypass toggle
     layout.add(std::make_unique<juce::AudioParameterBool>(
         "enabled", "Enabled",
         true  // default: enabled
     ));
 
+    // Multirate parameter: run Telephone/Custom at a decimated internal rate (adds latency)
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+        "multirate", "Multirate",
+        false  // default: full-rate processing, zero latency
+    ));
+
+    // Force Mono parameter: sum all channels, filter once, send the result to every output
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+        "forceMono", "Force Mono",
+        false  // default: channels processed independently (as in earlier versions)
+    ));
+
+    // Saturation parameter: soft-clip drive on the filtered signal, 0–100% (0 = off)
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        "saturation", "Saturation",
+        0.0f, 1.0f,  // range (1.0 = DSP::SATURATION_MAX_DRIVE_DB into the clipper)
+        0.0f  // default: off
+    ));
+
+    // Saturation Oversampling parameter: rate the clipper runs at (2x/4x add latency)
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        "saturationOversampling", "Saturation Oversampling",
+        juce::StringArray("1x (Off)", "2x", "4x"),
+        0  // default: 1x, zero latency
+    ));
+
+    // Noise Mode parameter: radio hiss or vinyl crackle added to the filtered signal
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        "noiseMode", "Noise Mode",
+        juce::StringArray("Off", "Hiss", "Vinyl"),
+        0  // default: off
+    ));
+
+    // Noise Level parameter: hiss level, -60 to -20 dB
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        "noiseLevel", "Noise Level",
+        juce::NormalisableRange<float>(DSP::NOISE_MIN_LEVEL_DB, DSP::NOISE_MAX_LEVEL_DB, 0.1f),
+        DSP::NOISE_DEFAULT_LEVEL_DB  // default: -45 dB
+    ));
+
+    // Codec Bits parameter: code width of the u-Law / A-Law modes (fewer bits = coarser steps)
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        "codecBits", "Codec Bits",
+        juce::StringArray("8 bit", "7 bit", "6 bit", "5 bit", "4 bit", "3 bit", "2 bit"),
+        0  // default: 8 bit, plain G.711
+    ));
+
+    // Packet Loss parameter: share of 20 ms packets the u-Law / A-Law modes drop and conceal, 0–20%
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        "packetLoss", "Packet Loss",
+        juce::NormalisableRange<float>(0.0f, DSP::CODEC_MAX_PACKET_LOSS_PERCENT, 0.1f),
+        0.0f  // default: no loss
+    ));
+
+    // Output Gain parameter: final trim, -24 to +24 dB
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        "outputGain", "Output Gain",
+        juce::NormalisableRange<float>(DSP::OUTPUT_GAIN_MIN_DB, DSP::OUTPUT_GAIN_MAX_DB, 0.1f),
+        0.0f  // default: unity
+    ));
+
+    // Limiter parameter: lookahead true-peak limiter after the output gain (adds latency)
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+        "limiter", "Limiter",
+        false  // default: off, zero latency
+    ));
+
     return layout;
 }
 
@@ -36,15 +132,56 @@ PluginProcessor::PluginProcessor()
                      .withOutput("Output", juce::AudioChannelSet::stereo(), true))
     , apvts(*this, nullptr, "STATE", createParameterLayout())
 {
+    startTimerHz(20);
 }
 
 PluginProcessor::~PluginProcessor() {
+    stopTimer();
+}
+
+//==============================================================================
+bool PluginProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const {
+    const auto& input = layouts.getMainInputChannelSet();
+    const auto& output = layouts.getMainOutputChannelSet();
+
+    // An insert effect: channels in == channels out, in the same layout
+    if (input != output || output.isDisabled())
+        return false;
+
+    // Mono up to 7.1.4; the chain runs channels in SIMD lane groups, so the count costs nothing extra
+    static const juce::AudioChannelSet supported[] = {
+        juce::AudioChannelSet::mono(),
+        juce::AudioChannelSet::stereo(),
+        juce::AudioChannelSet::createLCR(),
+        juce::AudioChannelSet::createLCRS(),
+        juce::AudioChannelSet::quadraphonic(),
+        juce::AudioChannelSet::create5point0(),
+        juce::AudioChannelSet::create5point1(),
+        juce::AudioChannelSet::create6point0(),
+        juce::AudioChannelSet::create6point1(),
+        juce::AudioChannelSet::create7point0(),
+        juce::AudioChannelSet::create7point1(),
+        juce::AudioChannelSet::create5point1point2(),
+        juce::AudioChannelSet::create5point1point4(),
+        juce::AudioChannelSet::create7point0point2(),
+        juce::AudioChannelSet::create7point1point2(),
+        juce::AudioChannelSet::create7point0point4(),
+        juce::AudioChannelSet::create7point1point4()
+    };
+
+    for (const auto& set : supported)
+        if (output == set)
+            return true;
+
+    // Anything else the host names as plain discrete channels, up to the size of 7.1.4
+    return output.isDiscreteLayout() && output.size() <= 12;
 }
 
 //==============================================================================
 void PluginProcessor::prepareToPlay(double sampleRate, int samplesPerBlock) {
     currentSampleRate = sampleRate;
     maxBlockSize = samplesPerBlock;
+    analysisTap.prepare(sampleRate);
 
     juce::ScopedNoDenormals noDenormals;
 
@@ -52,33 +189,182 @@ void PluginProcessor::prepareToPlay(double sampleRate, int samplesPerBlock) {
     juce::dsp::ProcessSpec spec;
     spec.sampleRate = sampleRate;
     spec.maximumBlockSize = samplesPerBlock;
-    spec.numChannels = getMainBusNumOutputChannels();
-    dspChain.prepare(spec);
+    spec.numChannels = static_cast<juce::uint32>(juce::jmax(getMainBusNumInputChannels(),
+                                                            getMainBusNumOutputChannels()));
+
+    // The host picks the precision before preparing; only that chain is used
+    if (isUsingDoublePrecision())
+        prepareChain(doubleChain, spec);
+    else
+        prepareChain(floatChain, spec);
+
+    // The IR mode's response at this rate, for this channel count
+    const juce::ScopedLock lock(impulseResponseLock);
+    preparedChannels = static_cast<int>(spec.numChannels);
+    rebuildImpulseResponse();
+}
+
+template <typename SampleType>
+void PluginProcessor::prepareChain(DSPChain<SampleType>& chain, const juce::dsp::ProcessSpec& spec) {
+    // Start from a full snapshot: every parameter counts as changed
+    parameterCache.markAllDirty();
+    const auto& params = parameterCache.update();
+    chain.setParameters(params);
+    chain.setNoiseSeed(noiseSeed.load());
+    chain.prepare(spec);
+
+    // Report the multirate, oversampling and limiter latency (if enabled) before playback starts
+    chain.setMultirateEnabled(params.multirate);
+    chain.setSaturationOversampling(params.saturationOversampling);
+    chain.setLimiterEnabled(params.limiter);
+    pendingLatency.store(-1, std::memory_order_relaxed);
+    setLatencySamples(chain.getLatencySamples());
 }
 
 void PluginProcessor::releaseResources() {
     // Reset DSP chain state
-    dspChain.reset();
+    if (isUsingDoublePrecision())
+        doubleChain.reset();
+    else
+        floatChain.reset();
+}
+
+double PluginProcessor::getTailLengthSeconds() const {
+    return isUsingDoublePrecision() ? doubleChain.getTailLengthSeconds()
+                                    : floatChain.getTailLengthSeconds();
 }
 
 //==============================================================================
 void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer,
                                    juce::MidiBuffer& midiMessages) {
+    processChain(floatChain, buffer);
+}
+
+void PluginProcessor::processBlock(juce::AudioBuffer<double>& buffer,
+                                   juce::MidiBuffer& midiMessages) {
+    processChain(doubleChain, buffer);
+}
+
+template <typename SampleType>
+void PluginProcessor::processChain(DSPChain<SampleType>& chain, juce::AudioBuffer<SampleType>& buffer) {
     juce::ScopedNoDenormals noDenormals;
 
-    // Read parameters
-    bool enabled = apvts.getRawParameterValue("enabled")->load();
-    int mode = static_cast<int>(apvts.getRawParameterValue("mode")->load());
-    float mix = apvts.getRawParameterValue("mix")->load();
+    // Editor open: times the whole block and its stages and hands the record over (wait-free)
+    const PerformanceMonitor::BlockScope blockScope(performanceMonitor, buffer.getNumSamples(),
+                                                    buffer.getNumChannels(), currentSampleRate);
+    chain.setProfile(blockScope.getProfile());
+    DSP::StageTimer parameterTimer(blockScope.getProfile(), DSP::BlockProfile::Parameters);
+
+    // Read parameters: only the ones that changed since the last block are reloaded
+    const auto& params = parameterCache.update();
+
+    // Switching multirate, the saturation oversampling or the limiter changes the processing latency:
+    // switched here, reported to the host by timerCallback() (no host call from the audio thread)
+    bool latencyChanged = false;
+
+    if (params.isDirty(DSP::ParameterSnapshot::Multirate) && params.multirate != chain.isMultirateEnabled()) {
+        chain.setMultirateEnabled(params.multirate);
+        latencyChanged = true;
+    }
+
+    if (params.isDirty(DSP::ParameterSnapshot::SaturationOversampling)
+        && params.saturationOversampling != chain.getSaturationOversampling()) {
+        chain.setSaturationOversampling(params.saturationOversampling);
+        latencyChanged = true;
+    }
+
+    if (params.isDirty(DSP::ParameterSnapshot::Limiter) && params.limiter != chain.isLimiterEnabled()) {
+        chain.setLimiterEnabled(params.limiter);
+        latencyChanged = true;
+    }
+
+    if (latencyChanged)
+        pendingLatency.store(chain.getLatencySamples(), std::memory_order_relaxed);
+
+    // Retarget ramps/modulators before the bypass check, so no change is lost while disabled
+    chain.setParameters(params);
+
+    // A loaded state restarts the noise from its seed, after its levels (the gains snap to them),
+    // so the render matches one prepared with that state
+    if (noiseSeedPending.exchange(false, std::memory_order_acquire))
+        chain.setNoiseSeed(noiseSeed.load(std::memory_order_relaxed));
+    parameterTimer.stop();
+
+    // Editor open: input level before processing (nothing is tapped otherwise)
+    const bool analysing = analysisTap.isActive();
+    if (analysing)
+        analysisTap.pushInput(buffer);
 
     // If disabled, clear output (bypass)
-    if (!enabled) {
+    if (!params.enabled) {
         buffer.clear();
+        if (analysing)
+            analysisTap.pushOutput(buffer);
         return;
     }
 
+    // Re-enabled: drop the state left over from before the bypass (it would click)
+    if (params.isDirty(DSP::ParameterSnapshot::Enabled))
+        chain.reset();
+
     // Process audio through DSP chain with selected mode and mix level
-    dspChain.processBlock(buffer, mode, mix);
+    chain.processBlock(buffer, params.mode, params.mix);
+
+    if (analysing)
+        analysisTap.pushOutput(buffer);
+}
+
+void PluginProcessor::timerCallback() {
+    const int latency = pendingLatency.exchange(-1, std::memory_order_relaxed);
+    if (latency >= 0 && latency != getLatencySamples())
+        setLatencySamples(latency);
+}
+
+//==============================================================================
+void PluginProcessor::selectImpulseResponse(int bundledIndex) {
+    const juce::ScopedLock lock(impulseResponseLock);
+    impulseResponses.selectBundled(bundledIndex);
+    rebuildImpulseResponse();
+}
+
+bool PluginProcessor::loadImpulseResponseFile(const juce::File& file) {
+    const juce::ScopedLock lock(impulseResponseLock);
+    if (!impulseResponses.loadFile(file))
+        return false;
+
+    rebuildImpulseResponse();
+    return true;
+}
+
+PluginState::ImpulseResponseReference PluginProcessor::getImpulseResponse() const {
+    const juce::ScopedLock lock(impulseResponseLock);
+    return { impulseResponses.getBundledIndex(), impulseResponses.getFilePath() };
+}
+
+juce::String PluginProcessor::getImpulseResponseName() const {
+    const juce::ScopedLock lock(impulseResponseLock);
+    return impulseResponses.getName();
+}
+
+void PluginProcessor::rebuildImpulseResponse() {
+    if (preparedChannels == 0)
+        return;
+
+    const auto response = impulseResponses.render(currentSampleRate);
+
+    if (isUsingDoublePrecision())
+        submitImpulseResponse(doubleChain, response);
+    else
+        submitImpulseResponse(floatChain, response);
+}
+
+template <typename SampleType>
+void PluginProcessor::submitImpulseResponse(DSPChain<SampleType>& chain, const std::vector<float>& response) {
+    // Transformed and allocated here; the audio thread only swaps a pointer
+    auto engine = std::make_unique<DSP::PartitionedConvolver<SampleType>>();
+    engine->prepare(response.data(), static_cast<int>(response.size()), preparedChannels,
+                    DSP::CONVOLUTION_HEAD_SIZE, DSP::CONVOLUTION_LEVEL_RATIO);
+    chain.setImpulseResponse(std::move(engine));
 }
 
 //==============================================================================
@@ -92,22 +378,31 @@ const juce::String PluginProcessor::getName() const {
 
 //==============================================================================
 void PluginProcessor::getStateInformation(juce::MemoryBlock& destData) {
-    // Save APVTS state
-    auto state = apvts.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+    // Compact binary state: raw parameter values, no ValueTree/XML round trip
+    pluginState.save(destData, getImpulseResponse());
 }
 
 void PluginProcessor::setStateInformation(const void* data, int sizeInBytes) {
-    // Load APVTS state
-    std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
-
-    if (xmlState.get() != nullptr) {
-        if (xmlState->hasTagName(apvts.state.getType())) {
-            auto newState = juce::ValueTree::fromXml(*xmlState);
-            apvts.replaceState(newState);
-        }
-    }
+    // Binary state, or the XML written by earlier versions (saved as binary from then on).
+    // Complete on its own: the parameters, the seed and the response all reach a running chain
+    const auto current = getImpulseResponse();
+    auto reference = current;
+    pluginState.load(data, sizeInBytes, reference);
+
+    // The seed (the state's, or this instance's if it has none) reaches the chain on the next block
+    noiseSeedPending.store(true, std::memory_order_release);
+
+    // Only a different response is rebuilt; a file that has gone missing falls back to the bundled one
+    if (reference == current)
+        return;
+
+    const juce::ScopedLock lock(impulseResponseLock);
+    impulseResponses.selectBundled(reference.bundledIndex);
+
+    if (juce::File::isAbsolutePath(reference.filePath))
+        impulseResponses.loadFile(juce::File(reference.filePath));
+
+    rebuildImpulseResponse();
 }
 
 //==============================================================================
@@ -2,9 +2,15 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include "../dsp/DSPChain.h"
+#include "ParameterCache.h"
+#include "PerformanceMonitor.h"
+#include "AnalysisTap.h"
+#include "PluginState.h"
+#include "ImpulseResponseLibrary.h"
 
 //==============================================================================
-class PluginProcessor : public juce::AudioProcessor {
+class PluginProcessor : public juce::AudioProcessor,
+                        private juce::Timer {
 public:
     //==========================================================================
     PluginProcessor();
@@ -13,7 +19,12 @@ public:
     //==========================================================================
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
+    bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock(juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+
+    // 64-bit hosts process natively (no float round trip around the plugin)
+    bool supportsDoublePrecisionProcessing() const override { return true; }
 
     //==========================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -24,7 +35,7 @@ public:
     bool acceptsMidi() const override { return false; }
     bool producesMidi() const override { return false; }
     bool isMidiEffect() const override { return false; }
-    double getTailLengthSeconds() const override { return 0.0; }
+    double getTailLengthSeconds() const override;
 
     //==========================================================================
     int getNumPrograms() override { return 1; }
@@ -41,15 +52,70 @@ public:
     // APVTS (Audio Processor Value Tree State)
     juce::AudioProcessorValueTreeState apvts;
 
+    // Per-block timing for the editor's CPU readout (polled on the message thread)
+    PerformanceMonitor& getPerformanceMonitor() { return performanceMonitor; }
+
+    // Levels and decimated output for the editor's meters and spectrum (idle while no editor is open)
+    AnalysisTap& getAnalysisTap() { return analysisTap; }
+
+    // The IR mode's response: a bundled one, or an audio file (false if it cannot be read)
+    void selectImpulseResponse(int bundledIndex);
+    bool loadImpulseResponseFile(const juce::File& file);
+    PluginState::ImpulseResponseReference getImpulseResponse() const;
+    juce::String getImpulseResponseName() const;
+
 private:
     //==========================================================================
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
+    // Shared by both precisions (only the chain matching the host's precision is used)
+    template <typename SampleType>
+    void prepareChain(DSPChain<SampleType>& chain, const juce::dsp::ProcessSpec& spec);
+
+    template <typename SampleType>
+    void processChain(DSPChain<SampleType>& chain, juce::AudioBuffer<SampleType>& buffer);
+
+    // Reports a latency change made on the audio thread (see pendingLatency)
+    void timerCallback() override;
+
+    // Renders the selected response at the current rate and hands it to the chain in use
+    // (called with impulseResponseLock held; nothing to do before prepareToPlay())
+    void rebuildImpulseResponse();
+
+    template <typename SampleType>
+    void submitImpulseResponse(DSPChain<SampleType>& chain, const std::vector<float>& response);
+
     double currentSampleRate = 44100.0;
     int maxBlockSize = 512;
 
-    // DSP Chain for audio processing
-    DSPChain dspChain;
+    // Typed per-block parameter snapshots (resolved once; declared after apvts)
+    ParameterCache parameterCache { apvts };
+
+    // Latency set on the audio thread, reported to the host from the message thread (-1: none).
+    // Polled rather than posted: posting a message can lock or allocate on the audio thread
+    std::atomic<int> pendingLatency { -1 };
+
+    // This instance's noise seed: random per instance, saved with the state so renders repeat
+    std::atomic<juce::uint32> noiseSeed { static_cast<juce::uint32>(juce::Random::getSystemRandom().nextInt()) };
+
+    // Set when a state is loaded: the next block restarts the noise from noiseSeed (audio thread)
+    std::atomic<bool> noiseSeedPending { false };
+
+    // Binary get/setStateInformation (resolved once; declared after apvts and noiseSeed)
+    PluginState pluginState { apvts, noiseSeed };
+
+    // IR mode: the selected response, read on the message thread and in prepareToPlay()
+    ImpulseResponseLibrary impulseResponses;
+    juce::CriticalSection impulseResponseLock;
+    int preparedChannels = 0;                   ///< Channels the engines are built for (0: not prepared yet)
+
+    // Block/stage timing, filled in on the audio thread
+    PerformanceMonitor performanceMonitor;
+    AnalysisTap analysisTap;
+
+    // DSP Chains for audio processing, one per host precision
+    DSPChain<float> floatChain;
+    DSPChain<double> doubleChain;
 
     //==========================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginProcessor)
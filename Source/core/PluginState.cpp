@@ -0,0 +1,120 @@
+#include "PluginState.h"
+#include <cstring>
+
+namespace {
+
+/** Stores value at destination in little-endian byte order (unaligned is fine). */
+template <typename Type>
+void writeLittleEndian(juce::uint8* destination, Type value) {
+    value = juce::ByteOrder::swapIfBigEndian(value);
+    std::memcpy(destination, &value, sizeof(value));
+}
+
+} // namespace
+
+//==============================================================================
+PluginState::PluginState(juce::AudioProcessorValueTreeState& state, std::atomic<juce::uint32>& noiseSeed)
+    : apvts(state), seed(noiseSeed) {
+    for (int i = 0; i < numParameters; ++i) {
+        const auto* id = DSP::ParameterSnapshot::parameterIds[i];
+        parameters[static_cast<size_t>(i)] = apvts.getParameter(id);
+        values[static_cast<size_t>(i)] = apvts.getRawParameterValue(id);
+        jassert(parameters[static_cast<size_t>(i)] != nullptr);  // ID missing from createParameterLayout()
+    }
+}
+
+//==============================================================================
+void PluginState::save(juce::MemoryBlock& destData, const ImpulseResponseReference& impulseResponse) const {
+    const auto path = impulseResponse.filePath.toRawUTF8();
+    const auto pathBytes = static_cast<int>(std::strlen(path));
+    const int seedOffset = headerSize + numParameters * 4;
+
+    destData.setSize(static_cast<size_t>(seedOffset + 4 + 8 + pathBytes));
+    auto* bytes = static_cast<juce::uint8*>(destData.getData());
+
+    writeLittleEndian(bytes, magic);
+    writeLittleEndian(bytes + 4, version);
+    writeLittleEndian(bytes + 6, static_cast<juce::uint16>(numParameters));
+
+    for (int i = 0; i < numParameters; ++i) {
+        const float value = values[static_cast<size_t>(i)]->load(std::memory_order_relaxed);
+        juce::uint32 bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        writeLittleEndian(bytes + headerSize + i * 4, bits);
+    }
+
+    writeLittleEndian(bytes + seedOffset, seed.load(std::memory_order_relaxed));
+
+    writeLittleEndian(bytes + seedOffset + 4, static_cast<juce::uint32>(impulseResponse.bundledIndex));
+    writeLittleEndian(bytes + seedOffset + 8, static_cast<juce::uint32>(pathBytes));
+    std::memcpy(bytes + seedOffset + 12, path, static_cast<size_t>(pathBytes));
+}
+
+bool PluginState::load(const void* data, int sizeInBytes, ImpulseResponseReference& impulseResponse) {
+    if (data == nullptr || sizeInBytes <= 0)
+        return false;
+
+    return isBinary(data, sizeInBytes) ? loadBinary(data, sizeInBytes, impulseResponse)
+                                       : loadXml(data, sizeInBytes);
+}
+
+bool PluginState::isBinary(const void* data, int sizeInBytes) {
+    return sizeInBytes >= headerSize && juce::ByteOrder::littleEndianInt(data) == magic;
+}
+
+//==============================================================================
+bool PluginState::loadBinary(const void* data, int sizeInBytes, ImpulseResponseReference& impulseResponse) {
+    const auto* bytes = static_cast<const juce::uint8*>(data);
+    const auto stateVersion = juce::ByteOrder::littleEndianShort(bytes + 4);
+    const int count = juce::ByteOrder::littleEndianShort(bytes + 6);
+
+    // Written by a newer layout than this build knows
+    if (stateVersion > version || sizeInBytes < headerSize + count * 4)
+        return false;
+
+    for (int i = 0; i < juce::jmin(count, numParameters); ++i) {
+        const juce::uint32 bits = juce::ByteOrder::littleEndianInt(bytes + headerSize + i * 4);
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+
+        auto* parameter = parameters[static_cast<size_t>(i)];
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    }
+
+    // Older states have fewer parameters: the rest go back to their defaults, so a recall
+    // sounds the same whatever the instance was set to before
+    for (int i = count; i < numParameters; ++i) {
+        auto* parameter = parameters[static_cast<size_t>(i)];
+        parameter->setValueNotifyingHost(parameter->getDefaultValue());
+    }
+
+    // Optional trailer: the noise seed (handed to the audio thread by the caller)
+    const int seedOffset = headerSize + count * 4;
+    if (sizeInBytes >= seedOffset + 4)
+        seed.store(juce::ByteOrder::littleEndianInt(bytes + seedOffset), std::memory_order_relaxed);
+
+    // Optional trailer: the impulse response reference (applied by the caller)
+    const int impulseResponseOffset = seedOffset + 4;
+    if (sizeInBytes >= impulseResponseOffset + 8) {
+        const auto pathBytes = static_cast<int>(juce::ByteOrder::littleEndianInt(bytes + impulseResponseOffset + 4));
+
+        if (pathBytes >= 0 && sizeInBytes - (impulseResponseOffset + 8) >= pathBytes) {
+            impulseResponse.bundledIndex = static_cast<int>(juce::ByteOrder::littleEndianInt(bytes + impulseResponseOffset));
+            impulseResponse.filePath = juce::String::fromUTF8(reinterpret_cast<const char*>(bytes + impulseResponseOffset + 8),
+                                                              pathBytes);
+        }
+    }
+
+    return true;
+}
+
+bool PluginState::loadXml(const void* data, int sizeInBytes) {
+    // The format before the binary one: APVTS state as XML (see copyXmlToBinary())
+    std::unique_ptr<juce::XmlElement> xmlState(juce::AudioProcessor::getXmlFromBinary(data, sizeInBytes));
+
+    if (xmlState == nullptr || !xmlState->hasTagName(apvts.state.getType()))
+        return false;
+
+    apvts.replaceState(juce::ValueTree::fromXml(*xmlState));
+    return true;
+}
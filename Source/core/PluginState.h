@@ -0,0 +1,89 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "../dsp/ParameterSnapshot.h"
+#include <array>
+
+//==============================================================================
+/**
+ * PluginState - Compact versioned binary plugin state, with XML migration
+ *
+ * Layout (little-endian):
+ *
+ *     uint32 magic ('PFst')  uint16 version  uint16 count  float value[count]
+ *     [uint32 noiseSeed]
+ *     [uint32 impulseResponseIndex  uint32 pathBytes  char path[pathBytes]]
+ *
+ * The values are the raw (denormalised) parameter values in
+ * DSP::ParameterSnapshot::parameterIds order, read straight from the APVTS
+ * atomics: no ValueTree copy, no XML. save() always writes both trailers,
+ * so a state is 88 bytes for seventeen parameters plus the length of the
+ * impulse response's path (none for a bundled one). That list is
+ * append-only, so a state written with fewer parameters loads its prefix
+ * and sets the newer ones to their defaults; a version bump is only needed
+ * for a change the count cannot express. The noise seed
+ * follows as an optional trailer: older builds ignore it, and states
+ * without one keep the instance's own seed. The IR mode's impulse response
+ * is the second trailer, as a reference (the bundled index, and the UTF-8
+ * path of a user file, empty for none); the samples are not stored.
+ *
+ * load() also accepts the XML blobs older versions wrote (anything without
+ * the magic), so existing sessions keep loading and are saved in the
+ * binary format from then on.
+ *
+ * Every field takes effect on a running processor, with no prepareToPlay():
+ * - values: set through the parameters, picked up by the next block
+ * - noise seed: stored in the seed atomic; the caller flags it and the audio
+ *   thread reseeds before its next block
+ * - impulse response: returned to the caller, which renders it and hands
+ *   it to the chain through the lock-free slot
+ *
+ * Parameters and value pointers are resolved by ID once, at construction.
+ * Message thread (save, load), like get/setStateInformation.
+ */
+class PluginState {
+public:
+    static constexpr juce::uint32 magic = 0x74734650;   ///< "PFst" in memory order
+    static constexpr juce::uint16 version = 1;
+
+    /** The impulse response a state refers to: a bundled one, or a file if the path is set. */
+    struct ImpulseResponseReference {
+        int bundledIndex = 0;
+        juce::String filePath;
+
+        bool operator==(const ImpulseResponseReference& other) const {
+            return bundledIndex == other.bundledIndex && filePath == other.filePath;
+        }
+    };
+
+    PluginState(juce::AudioProcessorValueTreeState& state, std::atomic<juce::uint32>& noiseSeed);
+
+    /** Replaces destData with the binary state. */
+    void save(juce::MemoryBlock& destData, const ImpulseResponseReference& impulseResponse) const;
+
+    /** Loads a binary state, or an older XML state; false if neither could be read.
+     *  impulseResponse is only written if the state has one. The seed is only
+     *  stored and the response only returned: handing them to the audio thread
+     *  is up to the caller (see PluginProcessor::setStateInformation()).
+     */
+    bool load(const void* data, int sizeInBytes, ImpulseResponseReference& impulseResponse);
+
+    /** True if data starts with the binary header (what load() checks). */
+    static bool isBinary(const void* data, int sizeInBytes);
+
+private:
+    //==========================================================================
+    static constexpr int numParameters = DSP::ParameterSnapshot::NumParameters;
+    static constexpr int headerSize = 8;
+
+    bool loadBinary(const void* data, int sizeInBytes, ImpulseResponseReference& impulseResponse);
+    bool loadXml(const void* data, int sizeInBytes);
+
+    juce::AudioProcessorValueTreeState& apvts;
+    std::array<juce::RangedAudioParameter*, numParameters> parameters {};
+    std::array<std::atomic<float>*, numParameters> values {};
+    std::atomic<juce::uint32>& seed;
+
+    //==========================================================================
+    JUCE_DECLARE_NON_COPYABLE(PluginState)
+};
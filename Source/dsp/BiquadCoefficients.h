@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cmath>
+
+//==============================================================================
+/**
+ * BiquadCoefficients - Normalised second-order section coefficients
+ *
+ * Plain value type (b0, b1, b2, a1, a2 with a0 = 1) used by the lane-parallel
+ * biquad kernels. The design functions use the same formulas and the same
+ * arithmetic type as juce::dsp::IIR::Coefficients, so filters built from them
+ * produce bit-close output to the JUCE filters they replace.
+ *
+ * Real-Time Safety: ✅
+ * - No heap allocation, no reference counting
+ * - Safe to compute on the audio thread
+ */
+namespace DSP {
+
+template <typename SampleType>
+struct BiquadCoefficients
+{
+    SampleType b0 = 1, b1 = 0, b2 = 0;
+    SampleType a1 = 0, a2 = 0;
+
+    //==============================================================================
+    /** Second-order high-pass (same response as IIR::Coefficients::makeHighPass). */
+    static BiquadCoefficients makeHighPass(double sampleRate, SampleType frequency, SampleType q)
+    {
+        const auto n = std::tan(pi() * frequency / static_cast<SampleType>(sampleRate));
+        const auto nSquared = n * n;
+        const auto invQ = 1 / q;
+        const auto c1 = 1 / (1 + invQ * n + nSquared);
+
+        return normalise(c1, c1 * -2, c1,
+                         1, c1 * 2 * (nSquared - 1), c1 * (1 - invQ * n + nSquared));
+    }
+
+    /** Second-order low-pass (same response as IIR::Coefficients::makeLowPass). */
+    static BiquadCoefficients makeLowPass(double sampleRate, SampleType frequency, SampleType q)
+    {
+        const auto n = 1 / std::tan(pi() * frequency / static_cast<SampleType>(sampleRate));
+        const auto nSquared = n * n;
+        const auto invQ = 1 / q;
+        const auto c1 = 1 / (1 + invQ * n + nSquared);
+
+        return normalise(c1, c1 * 2, c1,
+                         1, c1 * 2 * (1 - nSquared), c1 * (1 - invQ * n + nSquared));
+    }
+
+    /** Peaking EQ (same response as IIR::Coefficients::makePeakFilter).
+     *
+     * @param gainFactor Linear gain at the centre frequency (2.0 = +6 dB)
+     */
+    static BiquadCoefficients makePeak(double sampleRate, SampleType frequency,
+                                       SampleType q, SampleType gainFactor)
+    {
+        const auto A = std::sqrt(gainFactor > 0 ? gainFactor : SampleType(0));
+        const auto omega = (2 * pi() * (frequency > 2 ? frequency : SampleType(2)))
+                           / static_cast<SampleType>(sampleRate);
+        const auto alpha = std::sin(omega) / (q * 2);
+        const auto c2 = -2 * std::cos(omega);
+        const auto alphaTimesA = alpha * A;
+        const auto alphaOverA = alpha / A;
+
+        return normalise(1 + alphaTimesA, c2, 1 - alphaTimesA,
+                         1 + alphaOverA, c2, 1 - alphaOverA);
+    }
+
+    //==============================================================================
+    /** Samples the section's impulse response takes to decay by decayDb.
+     *
+     * Uses the slowest pole (radius r): the response shrinks by r per sample,
+     * so this is the IIR tail length. Unstable or marginal sections report
+     * infinity.
+     */
+    double getDecaySamples(double decayDb) const
+    {
+        const double p1 = a1, p2 = a2;
+        const double discriminant = p1 * p1 - 4.0 * p2;
+        const double radius = discriminant < 0.0 ? std::sqrt(p2)
+                                                 : 0.5 * (std::abs(p1) + std::sqrt(discriminant));
+
+        if (radius >= 1.0)
+            return HUGE_VAL;
+
+        // Two samples of FIR part, then the pole decay
+        return 2.0 + (radius > 0.0 ? decayDb * (0.11512925464970229 / -std::log(radius)) : 0.0);  // ln(10) / 20
+    }
+
+private:
+    static constexpr SampleType pi() { return static_cast<SampleType>(3.141592653589793238L); }
+
+    static BiquadCoefficients normalise(SampleType b0, SampleType b1, SampleType b2,
+                                        SampleType a0, SampleType a1, SampleType a2)
+    {
+        const auto a0inv = 1 / a0;
+        return { b0 * a0inv, b1 * a0inv, b2 * a0inv, a1 * a0inv, a2 * a0inv };
+    }
+};
+
+} // namespace DSP
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+//==============================================================================
+/**
+ * BlockDelay - Fixed integer delay for latency alignment
+ *
+ * Delays every channel by the same whole number of samples. Used to keep
+ * paths with different processing latency (multirate, oversampling,
+ * lookahead) time-aligned with the dry signal, so the total latency
+ * reported to the host is the same whatever path is active.
+ *
+ * In-place safe: input and output may be the same channels.
+ *
+ * Real-Time Safety: ✅
+ * - Delay lines allocated in prepare(), never in process()
+ */
+namespace DSP {
+
+template <typename SampleType>
+class BlockDelay
+{
+public:
+    BlockDelay() = default;
+
+    /** Allocates the delay lines (for up to maxDelayInSamples, if larger) and clears them. */
+    void prepare(int numChannelsToUse, int delayInSamples, int maxDelayInSamples = 0)
+    {
+        numChannels = std::max(numChannelsToUse, 0);
+        capacity = std::max({ delayInSamples, maxDelayInSamples, 1 });
+        lines.assign(static_cast<size_t>(numChannels * capacity), SampleType(0));
+        setDelay(delayInSamples);
+    }
+
+    /** Changes the delay within the prepared maximum and clears the lines. */
+    void setDelay(int delayInSamples)
+    {
+        delay = std::clamp(delayInSamples, 0, capacity);
+        reset();
+    }
+
+    void reset()
+    {
+        std::fill(lines.begin(), lines.end(), SampleType(0));
+        writePos = 0;
+    }
+
+    int getDelay() const { return delay; }
+
+    //==============================================================================
+    void process(const SampleType* const* input, SampleType* const* output,
+                 int numChannelsToProcess, int numSamples)
+    {
+        numChannelsToProcess = std::min(numChannelsToProcess, numChannels);
+
+        if (delay == 0)
+        {
+            for (int ch = 0; ch < numChannelsToProcess; ++ch)
+                if (input[ch] != output[ch])
+                    std::copy(input[ch], input[ch] + numSamples, output[ch]);
+            return;
+        }
+
+        int pos = writePos;
+        for (int ch = 0; ch < numChannelsToProcess; ++ch)
+        {
+            auto* line = lines.data() + ch * capacity;
+            const auto* in = input[ch];
+            auto* out = output[ch];
+
+            pos = writePos;
+            for (int n = 0; n < numSamples; ++n)
+            {
+                const auto x = in[n];  // Read first: in and out may alias
+                out[n] = line[pos];
+                line[pos] = x;
+                if (++pos == delay)
+                    pos = 0;
+            }
+        }
+
+        writePos = pos;
+    }
+
+private:
+    std::vector<SampleType> lines;  ///< One ring per channel; the first 'delay' samples are in use
+    int numChannels = 0;
+    int capacity = 1;
+    int delay = 0;
+    int writePos = 0;
+};
+
+} // namespace DSP
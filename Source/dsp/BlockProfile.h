@@ -0,0 +1,102 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <algorithm>
+#include <cstdint>
+
+//==============================================================================
+/**
+ * BlockProfile - Timing record of one processed block
+ *
+ * Plain value type filled in on the audio thread: the block's total time,
+ * the time spent in each stage, and the block shape. Times are counted in
+ * juce::Time high-resolution ticks (getHighResolutionTicksPerSecond() per
+ * second), read directly from the OS counter, so a stage costs two counter
+ * reads and an add. Readers convert to seconds off the audio thread.
+ *
+ * Stages nest: Chain is the whole of DSPChain::processBlock(), and Filters,
+ * Transition, Saturation, Noise, Output and MonoMix are parts of it (the rest of Chain is control
+ * work: silence detection, tail and ramp bookkeeping, topology switches).
+ *
+ * Real-Time Safety: ✅
+ * - Trivially copyable, no allocation
+ */
+namespace DSP {
+
+struct BlockProfile
+{
+    enum Stage : int
+    {
+        Parameters,     ///< Parameter snapshot and retargeting (processor)
+        Chain,          ///< DSPChain::processBlock() as a whole
+        Filters,        ///< Steady-state filter kernels (including multirate)
+        Transition,     ///< Both chains plus crossfade during a mode change
+        MonoMix,        ///< Force Mono sum and fan-out
+        Saturation,     ///< Drive stage, oversampling included
+        Noise,          ///< Hiss / crackle generator
+        Output,         ///< Output gain and limiter
+        NumStages
+    };
+
+    static constexpr const char* stageNames[NumStages] = {
+        "parameters", "chain", "filters", "transition", "monoMix", "saturation", "noise", "output"
+    };
+
+    //==============================================================================
+    juce::int64 startTicks = 0;                 ///< When the block started
+    juce::int64 blockTicks = 0;                 ///< Whole processBlock() call
+    juce::int64 stageTicks[NumStages] = {};
+    double sampleRate = 0.0;
+    int numSamples = 0;
+    int numChannels = 0;
+
+    //==============================================================================
+    /** Starts a new record (stage times back to zero). */
+    void begin(juce::int64 now)
+    {
+        startTicks = now;
+        blockTicks = 0;
+        std::fill(std::begin(stageTicks), std::end(stageTicks), juce::int64(0));
+    }
+
+    /** Duration of the block's audio in ticks (what blockTicks has to stay under). */
+    double getBudgetTicks(double ticksPerSecond) const
+    {
+        return sampleRate > 0.0 ? numSamples * ticksPerSecond / sampleRate : 0.0;
+    }
+};
+
+//==============================================================================
+/** Adds the time between construction and destruction to one stage of a
+ *  profile; with a null profile it reads no clock and does nothing.
+ */
+class StageTimer
+{
+public:
+    StageTimer(BlockProfile* profileToFill, BlockProfile::Stage stageToTime)
+        : profile(profileToFill), stage(stageToTime),
+          start(profileToFill != nullptr ? juce::Time::getHighResolutionTicks() : 0)
+    {
+    }
+
+    ~StageTimer() { stop(); }
+
+    /** Ends the stage early (the destructor then adds nothing more). */
+    void stop()
+    {
+        if (profile != nullptr)
+            profile->stageTicks[stage] += juce::Time::getHighResolutionTicks() - start;
+
+        profile = nullptr;
+    }
+
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+
+private:
+    BlockProfile* profile;
+    BlockProfile::Stage stage;
+    juce::int64 start;
+};
+
+} // namespace DSP
@@ -0,0 +1,405 @@
+#pragma once
+
+#include "SIMDVector.h"
+#include "../utils/DSPDefines.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+//==============================================================================
+/**
+ * Codec - A digital phone line after the band filters: G.711 coding at 8 kHz
+ * and lost packets
+ *
+ * Per sample of the line (CODEC_SAMPLE_RATE_HZ, whatever the rate process()
+ * runs at):
+ *
+ *   - Sample-and-hold: the input is picked up once per line sample and held
+ *     until the next, so everything above 4 kHz folds back like an 8 kHz
+ *     converter without its anti-aliasing filter (the telephone band in front
+ *     keeps that mild at the default High Cut)
+ *   - Companding: the sample is coded to 8-bit mu-law or A-law and decoded
+ *     again. Both directions are table lookups (the G.711 segment code of the
+ *     14 / 13-bit magnitude, then the decoded level of the code), generated at
+ *     compile time from the integer G.711 rules, so no log or exp is evaluated
+ *   - Bit reduction (setBits()): fewer than 8 bits drop the code's low bits,
+ *     so the steps stay logarithmic but coarser (decoded at the middle of the
+ *     wider step; one decode table per width)
+ *   - Packet loss (setPacketLoss()): the line is cut into 20 ms packets and each
+ *     one is lost with the given probability. A lost packet is concealed by
+ *     replaying the last good one back and forth (reversed first, so the
+ *     waveform stays continuous at every turn), fading out over 60 ms; the
+ *     first packet after a loss is crossfaded in over 1 ms. The losses are the
+ *     same on every channel (one packet carries them all) and repeat after
+ *     reset()
+ *
+ * The hold times and the packet schedule are worked out once per chunk for
+ * all channels; per channel only the line samples are coded, a sixth of the
+ * samples at 48 kHz. The quantiser indices and the sign restore are plain
+ * loops over the line samples that the compiler vectorises, and the held
+ * runs are filled with SIMDVector stores; only the two table reads per line
+ * sample are scalar (no gather on SSE2 / NEON).
+ *
+ * Real-Time Safety: ✅
+ * - Channel state allocated in prepare(); setBits(), setPacketLoss(),
+ *   reset() and process() allocate nothing
+ */
+namespace DSP {
+
+/** Which G.711 companding curve a codec uses. */
+enum class CodecLaw
+{
+    MuLaw,      ///< North America / Japan
+    ALaw        ///< Europe and most of the rest
+};
+
+namespace G711 {
+
+/** Quantiser input resolution: mu-law codes the 14-bit, A-law the 13-bit magnitude. */
+constexpr int muLawTableSize = 8192;
+constexpr int aLawTableSize = 4096;
+
+/** Code widths setBits() accepts (sign included). */
+constexpr int minBits = 2;
+constexpr int maxBits = 8;
+
+/** 7-bit segment code (segment << 4 | step) of a 14-bit mu-law magnitude. */
+constexpr int encodeMuLaw(int magnitude)
+{
+    // In 16-bit units, clipped and biased as in G.711 (the low two bits never carry)
+    const int biased = std::min(magnitude << 2, 32635) + 0x84;
+
+    int segment = 7;
+    for (int mask = 0x4000; (biased & mask) == 0 && segment > 0; mask >>= 1)
+        --segment;
+
+    return (segment << 4) | ((biased >> (segment + 3)) & 0x0f);
+}
+
+/** Decoded mu-law magnitude of a 7-bit code, full scale 1. */
+constexpr double decodeMuLaw(int code)
+{
+    const int segment = code >> 4, step = code & 0x0f;
+    return static_cast<double>((((step << 3) + 0x84) << segment) - 0x84) / 32768.0;
+}
+
+/** 7-bit segment code of a 12-bit A-law magnitude (13 bits with the sign). */
+constexpr int encodeALaw(int magnitude)
+{
+    if (magnitude < 32)
+        return magnitude >> 1;
+
+    int segment = 1;
+    while ((magnitude >> (segment + 5)) != 0)
+        ++segment;
+
+    return (segment << 4) | ((magnitude >> segment) & 0x0f);
+}
+
+/** Decoded A-law magnitude of a 7-bit code (the middle of its step), full scale 1. */
+constexpr double decodeALaw(int code)
+{
+    const int segment = code >> 4, step = code & 0x0f;
+    const int level = segment == 0 ? (step << 1) + 1 : (((step | 0x10) << 1) + 1) << (segment - 1);
+    return static_cast<double>(level) / 4096.0;
+}
+
+/** The code a width keeps: the top bits, pointing at the middle of the dropped range. */
+constexpr int truncateCode(int code, int bits)
+{
+    const int dropped = maxBits - bits;
+    return dropped == 0 ? code : ((code >> dropped) << dropped) | (1 << (dropped - 1));
+}
+
+template <int Size, typename Encoder>
+constexpr std::array<std::uint8_t, Size> makeEncodeTable(Encoder encode)
+{
+    std::array<std::uint8_t, Size> table {};
+    for (int i = 0; i < Size; ++i)
+        table[static_cast<size_t>(i)] = static_cast<std::uint8_t>(encode(i));
+    return table;
+}
+
+constexpr int numWidths = maxBits - minBits + 1;
+
+/** Decoded magnitude of every 7-bit code at every width: [law][bits - minBits][code]. */
+template <typename SampleType>
+constexpr std::array<SampleType, 2 * numWidths * 128> makeDecodeTable()
+{
+    std::array<SampleType, 2 * numWidths * 128> table {};
+    for (int law = 0; law < 2; ++law)
+        for (int bits = minBits; bits <= maxBits; ++bits)
+            for (int code = 0; code < 128; ++code)
+            {
+                const int kept = truncateCode(code, bits);
+                table[static_cast<size_t>(((law * numWidths) + bits - minBits) * 128 + code)]
+                    = static_cast<SampleType>(law == 0 ? decodeMuLaw(kept) : decodeALaw(kept));
+            }
+    return table;
+}
+
+/** The coding tables, one copy per program (built by the compiler). */
+struct EncodeTables
+{
+    static constexpr auto muLaw = makeEncodeTable<muLawTableSize>(encodeMuLaw);
+    static constexpr auto aLaw = makeEncodeTable<aLawTableSize>(encodeALaw);
+};
+
+/** The decoding table, one copy per sample type. */
+template <typename SampleType>
+struct DecodeTable
+{
+    static constexpr auto levels = makeDecodeTable<SampleType>();
+};
+
+} // namespace G711
+
+//==============================================================================
+template <typename SampleType>
+class Codec
+{
+public:
+    static constexpr double packetSeconds = 0.02;
+    static constexpr double concealmentFadeSeconds = 0.06;
+    static constexpr double recoverySeconds = 0.001;
+
+    static constexpr int packetLength = static_cast<int>(CODEC_SAMPLE_RATE_HZ * packetSeconds + 0.5);
+    static constexpr int concealmentFadeLength = static_cast<int>(CODEC_SAMPLE_RATE_HZ * concealmentFadeSeconds + 0.5);
+    static constexpr int recoveryLength = static_cast<int>(CODEC_SAMPLE_RATE_HZ * recoverySeconds + 0.5);
+
+    void prepare(CodecLaw newLaw, double sampleRate, int numChannelsToUse)
+    {
+        law = newLaw;
+        setBits(bits);
+        holdIncrement = std::min(1.0, CODEC_SAMPLE_RATE_HZ / std::max(sampleRate, 1.0));
+        numChannels = std::max(numChannelsToUse, 1);
+        held.assign(static_cast<size_t>(numChannels), SampleType(0));
+        history.assign(static_cast<size_t>(numChannels * packetLength), SampleType(0));
+        reset();
+    }
+
+    /** Code width, G711::minBits..maxBits including the sign (8 = plain G.711). */
+    void setBits(int newBits)
+    {
+        bits = std::clamp(newBits, G711::minBits, G711::maxBits);
+        decodeTable = G711::DecodeTable<SampleType>::levels.data()
+                      + ((law == CodecLaw::MuLaw ? 0 : G711::numWidths) + bits - G711::minBits) * 128;
+    }
+
+    /** Probability of losing a packet, 0 to 1. */
+    void setPacketLoss(float probability)
+    {
+        lossProbability = std::clamp(probability, 0.0f, 1.0f);
+    }
+
+    /** Clears the held samples and the last packet, and restarts the loss pattern. */
+    void reset()
+    {
+        std::fill(held.begin(), held.end(), SampleType(0));
+        std::fill(history.begin(), history.end(), SampleType(0));
+        holdPhase = 1.0;  // The first sample is picked up at once
+        packetPosition = 0;
+        packetLost = false;
+        concealedSamples = 0;
+        recoveryLeft = 0;
+        random = lossSeed;
+    }
+
+    /** Longest the output can carry on after the input stops: a packet, then its concealment. */
+    static double getTailSeconds()
+    {
+        return packetSeconds + concealmentFadeSeconds + 1.0 / CODEC_SAMPLE_RATE_HZ;
+    }
+
+    //==============================================================================
+    /** Codes the channels in place. */
+    void process(SampleType* const* channels, int numChannelsToProcess, int numSamples)
+    {
+        numChannelsToProcess = std::min(numChannelsToProcess, numChannels);
+
+        for (int start = 0; start < numSamples; start += chunkSize)
+        {
+            const int count = std::min(chunkSize, numSamples - start);
+            Schedule schedule;
+            planChunk(schedule, count);
+
+            for (int ch = 0; ch < numChannelsToProcess; ++ch)
+                processChannel(schedule, ch, channels[ch] + start, count);
+        }
+    }
+
+private:
+    static constexpr int chunkSize = 256;
+    static constexpr std::uint32_t lossSeed = 0x2545f491u;
+
+    /** When the line samples of one chunk fall, and what the packets do to each. */
+    struct Schedule
+    {
+        int numTicks = 0;
+        bool concealing = false;                 ///< Some tick reads the last packet
+        int offset[chunkSize];                   ///< Where each line sample starts in the chunk
+        int write[chunkSize];                    ///< Its place in the last packet (-1: lost, not kept)
+        int replay[chunkSize];                   ///< What concealment plays there
+        SampleType received[chunkSize];          ///< Weight of the decoded sample
+        SampleType concealed[chunkSize];         ///< Weight of the replayed one
+    };
+
+    //==============================================================================
+    void planChunk(Schedule& schedule, int numSamples)
+    {
+        // Line sample instants: shared by every channel
+        int numTicks = 0;
+        auto phase = holdPhase;
+        for (int i = 0; i < numSamples; ++i)
+        {
+            if (phase >= 1.0)
+            {
+                phase -= 1.0;
+                schedule.offset[numTicks++] = i;
+            }
+            phase += holdIncrement;
+        }
+        holdPhase = phase;
+        schedule.numTicks = numTicks;
+        schedule.concealing = false;
+
+        for (int k = 0; k < numTicks; ++k)
+        {
+            // A new packet: lost or received (the crossfade back starts on the first one received)
+            if (packetPosition == 0)
+            {
+                const bool wasLost = packetLost;
+                packetLost = lossProbability > 0.0f && uniform() < lossProbability;
+
+                if (wasLost && !packetLost)
+                    recoveryLeft = recoveryLength;
+            }
+
+            if (packetLost || recoveryLeft > 0)
+            {
+                const auto fade = static_cast<SampleType>(std::max(0, concealmentFadeLength - concealedSamples))
+                                  / static_cast<SampleType>(concealmentFadeLength);
+                const auto received = packetLost ? SampleType(0)
+                                                 : static_cast<SampleType>(recoveryLength - recoveryLeft + 1)
+                                                       / static_cast<SampleType>(recoveryLength + 1);
+
+                // Back and forth through the last packet, starting from its end
+                const int cycle = concealedSamples / packetLength;
+                const int within = concealedSamples % packetLength;
+
+                schedule.replay[k] = (cycle & 1) == 0 ? packetLength - 1 - within : within;
+                schedule.received[k] = received;
+                schedule.concealed[k] = (SampleType(1) - received) * fade;
+                schedule.write[k] = packetLost ? -1 : packetPosition;
+                schedule.concealing = true;
+
+                concealedSamples = std::min(concealedSamples + 1, 1 << 30);
+                if (!packetLost && --recoveryLeft == 0)
+                    concealedSamples = 0;
+            }
+            else
+            {
+                schedule.replay[k] = 0;
+                schedule.received[k] = SampleType(1);
+                schedule.concealed[k] = SampleType(0);
+                schedule.write[k] = packetPosition;
+            }
+
+            packetPosition = (packetPosition + 1) % packetLength;
+        }
+    }
+
+    void processChannel(const Schedule& schedule, int channel, SampleType* samples, int numSamples)
+    {
+        const int numTicks = schedule.numTicks;
+        SampleType line[chunkSize];
+        int index[chunkSize];
+
+        // Sample-and-hold: the input at each line sample instant
+        for (int k = 0; k < numTicks; ++k)
+            line[k] = samples[schedule.offset[k]];
+
+        // Quantiser input: the magnitude in table steps (NaN ends up at the top)
+        const bool muLaw = law == CodecLaw::MuLaw;
+        const auto tableSize = static_cast<SampleType>(muLaw ? G711::muLawTableSize : G711::aLawTableSize);
+        const auto topIndex = tableSize - SampleType(1);
+        for (int k = 0; k < numTicks; ++k)
+            index[k] = static_cast<int>(std::min(topIndex, std::abs(line[k]) * tableSize));
+
+        // Code and decode: two table reads, then the sign back on
+        const auto* encode = muLaw ? G711::EncodeTables::muLaw.data() : G711::EncodeTables::aLaw.data();
+        for (int k = 0; k < numTicks; ++k)
+            line[k] = std::copysign(decodeTable[encode[index[k]]], line[k]);
+
+        // Packets: keep the last good one, replay it over the lost ones
+        auto* packet = history.data() + channel * packetLength;
+        if (schedule.concealing)
+        {
+            for (int k = 0; k < numTicks; ++k)
+            {
+                const auto value = line[k] * schedule.received[k] + packet[schedule.replay[k]] * schedule.concealed[k];
+                if (schedule.write[k] >= 0)
+                    packet[schedule.write[k]] = value;
+                line[k] = value;
+            }
+        }
+        else
+        {
+            for (int k = 0; k < numTicks; ++k)
+                packet[schedule.write[k]] = line[k];
+        }
+
+        // Hold each line sample until the next one starts
+        auto& value = held[(size_t) channel];
+        int start = 0;
+        for (int k = 0; k < numTicks; ++k)
+        {
+            fill(samples + start, schedule.offset[k] - start, value);
+            value = line[k];
+            start = schedule.offset[k];
+        }
+        fill(samples + start, numSamples - start, value);
+    }
+
+    static void fill(SampleType* destination, int count, SampleType value)
+    {
+        using Vector = SIMDVector<SampleType>;
+        const auto vector = Vector::expand(value);
+
+        int i = 0;
+        for (; i + Vector::size <= count; i += Vector::size)
+            vector.storeUnaligned(destination + i);
+        for (; i < count; ++i)
+            destination[i] = value;
+    }
+
+    /** Uniform in [0, 1) from a xorshift32 step. */
+    float uniform()
+    {
+        random ^= random << 13;
+        random ^= random >> 17;
+        random ^= random << 5;
+        return static_cast<float>(random >> 8) * (1.0f / 16777216.0f);
+    }
+
+    //==============================================================================
+    CodecLaw law = CodecLaw::MuLaw;
+    int bits = G711::maxBits;
+    const SampleType* decodeTable = G711::DecodeTable<SampleType>::levels.data();
+    int numChannels = 1;
+
+    std::vector<SampleType> held;                 ///< Per channel: the line sample being held
+    std::vector<SampleType> history;              ///< Per channel: the last packet (packetLength samples)
+
+    double holdPhase = 1.0, holdIncrement = 1.0;  ///< Line samples per input sample
+    float lossProbability = 0.0f;
+    int packetPosition = 0;
+    bool packetLost = false;
+    int concealedSamples = 0;                     ///< Line samples since the loss began
+    int recoveryLeft = 0;                         ///< Line samples left in the crossfade back
+    std::uint32_t random = lossSeed;
+};
+
+} // namespace DSP
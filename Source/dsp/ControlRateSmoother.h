@@ -0,0 +1,99 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+//==============================================================================
+/**
+ * ControlRateSmoother - Geometric parameter ramps advanced every N samples
+ *
+ * Smooths a small fixed set of positive values (e.g. filter cutoffs) at
+ * control rate: the caller splits its block into getControlInterval()-sized
+ * pieces while isSmoothing() is true, calls tick() before each piece and
+ * redesigns whatever depends on the values. When no target has changed,
+ * nothing ticks and nothing is recomputed.
+ *
+ * Ramps are multiplicative (equal ratio per tick), so a cutoff sweep moves
+ * evenly in octaves rather than racing through the low end.
+ *
+ * Real-Time Safety: ✅
+ * - Fixed-size storage, no allocation, no locks
+ */
+namespace DSP {
+
+template <int NumValues>
+class ControlRateSmoother
+{
+public:
+    ControlRateSmoother() = default;
+
+    /** Sets the tick length and ramp time. Values jump to their targets. */
+    void prepare(double sampleRate, int controlIntervalSamples, double rampSeconds)
+    {
+        controlInterval = std::max(controlIntervalSamples, 1);
+        rampTicks = std::max(1, static_cast<int>(std::lround(rampSeconds * sampleRate / controlInterval)));
+        snapToTargets();
+    }
+
+    /** Starts a ramp towards a new target. Repeating the current target costs nothing. */
+    void setTarget(int index, float newTarget)
+    {
+        newTarget = std::max(newTarget, 1.0e-6f);
+        if (newTarget == targets[index])
+            return;
+
+        targets[index] = newTarget;
+        ratios[index] = std::pow(newTarget / values[index], 1.0f / static_cast<float>(rampTicks));
+        remainingTicks[index] = rampTicks;
+    }
+
+    /** Sets a value immediately, with no ramp (initial state, preset loads). */
+    void setCurrentAndTargetValue(int index, float newValue)
+    {
+        values[index] = targets[index] = std::max(newValue, 1.0e-6f);
+        remainingTicks[index] = 0;
+    }
+
+    /** Jumps every value to its target, ending any ramp. */
+    void snapToTargets()
+    {
+        for (int i = 0; i < NumValues; ++i)
+        {
+            values[i] = targets[i];
+            remainingTicks[i] = 0;
+        }
+    }
+
+    bool isSmoothing() const
+    {
+        return std::any_of(remainingTicks, remainingTicks + NumValues, [](int ticks) { return ticks > 0; });
+    }
+
+    /** Advances every active ramp by one control interval. */
+    void tick()
+    {
+        for (int i = 0; i < NumValues; ++i)
+        {
+            if (remainingTicks[i] == 0)
+                continue;
+
+            // Geometric step; the last tick takes the target itself, which the product of the ratios only approximates
+            values[i] = --remainingTicks[i] == 0 ? targets[i] : values[i] * ratios[i];
+        }
+    }
+
+    float getCurrentValue(int index) const { return values[index]; }
+    float getTargetValue(int index) const { return targets[index]; }
+    int getControlInterval() const { return controlInterval; }
+
+private:
+    float values[NumValues] = {};
+    float targets[NumValues] = {};
+    float ratios[NumValues] = {};
+    int remainingTicks[NumValues] = {};
+
+    int controlInterval = 32;
+    int rampTicks = 1;
+};
+
+} // namespace DSP
@@ -1,31 +1,69 @@
 #pragma once
 
-#include "TelephonyFilter.h"
-#include "RadioFilter.h"
+#include "ModeChains.h"
+#include "MultirateBand.h"
+#include "BlockDelay.h"
+#include "ControlRateSmoother.h"
+#include "StateVariableCascade.h"
+#include "DriftModulator.h"
+#include "ParameterSnapshot.h"
+#include "ModeCrossfade.h"
+#include "Saturation.h"
+#include "NoiseGenerator.h"
+#include "ImpulseResponseSlot.h"
+#include "OutputStage.h"
+#include "BlockProfile.h"
+#include <juce_dsp/juce_dsp.h>
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 
 //==============================================================================
 /**
  * DSPChain - Main audio processing orchestrator
  * 
- * Routes input audio through the selected filter (Telephone or Radio)
- * and applies wet/dry blending via the mix parameter.
+ * Signal flow per block:
  * 
- * Modes:
- * - 0: Telephone (narrowband, muffled)
- * - 1: Radio (bright, presence-heavy)
- * - 2: Custom (both filters chained for extreme effect)
+ *     input -> [Force Mono sum] -> mode -> [saturation] -> [noise] -> mix
+ *           -> output gain -> [limiter] -> output
+ * 
+ * - Mode: one of the chains declared in ModeChains.h (0 Telephone, 1 Radio,
+ *   2 Custom, 4/5 mu-law/A-law phone line), each a fused BiquadCascade with
+ *   the mix folded into its last stage, or 3: a loaded impulse response
+ *   (PartitionedConvolver). Low Cut / High Cut, tuning drift (state-variable
+ *   twins) and mode crossfades act on the chains at control rate
+ * - Codec modes run their chain at full mix, then G.711 (DSP::Codec), then
+ *   blend the dry signal in (through codecBuffer when processing in place)
+ * - Multirate: band-limited modes run at an 11-12 kHz internal rate; full-band
+ *   modes and the dry signal are delayed to match
+ * - Saturation and noise run on the wet signal; while either is in use the
+ *   mix is applied after them against a delayed dry copy
+ * - The chain sleeps on silent input once the filter tail has decayed
+ * 
+ * getLatencySamples() covers multirate, saturation oversampling and the
+ * limiter lookahead for every mode and mix setting. SampleType is float or
+ * double; control values stay float.
  * 
  * Real-Time Safe: ✅
- * - Mode switching done via parameter (no mode-specific allocations)
- * - All filter processing pre-allocated
- * - Mix blending done in real-time without allocations
+ * - Everything is allocated in prepare(), including the scratch buffers:
+ *   delayed dry (multirate, saturation/noise), codec blending, mode
+ *   transitions and Force Mono
+ * - Mode switches, parameter changes and profiling allocate nothing
  */
+template <typename SampleType>
 class DSPChain
 {
 public:
-    DSPChain() = default;
+    DSPChain()
+    {
+        cutoffs.setCurrentAndTargetValue(lowCutIndex, DSP::TELEPHONE_LOW_CUT_HZ);
+        cutoffs.setCurrentAndTargetValue(highCutIndex, DSP::TELEPHONE_HIGH_CUT_HZ);
+    }
+
     ~DSPChain() = default;
 
     //==============================================================================
@@ -41,80 +79,419 @@ public:
         // Store spec for later reference
         currentSpec = spec;
 
-        // Prepare both filters
-        telephonyFilter.prepare(spec);
-        radioFilter.prepare(spec);
+        // Multirate runs the cutoff ramps at the internal rate (inside the narrowband callback)
+        const int numChannels = static_cast<int>(spec.numChannels);
+        const int maxBlockSize = static_cast<int>(spec.maximumBlockSize);
+
+        multirate.prepare(spec.sampleRate, maxBlockSize, numChannels, DSP::MULTIRATE_MIN_INTERNAL_RATE_HZ);
+
+        // Start from the latest cutoff targets, no ramp
+        prepareCutoffRamps();
+        const double internalRate = multirate.getInternalSampleRate();
+
+        // Every mode's chains pre-allocated (no allocation in processBlock()): biquad and
+        // state-variable (tuning drift) twins at the host rate, and the multirate pair for
+        // band-limited modes, always ready so multirate can switch on in real time. Only the
+        // state is sized here; each chain is designed when it first runs (see refreshCutoffSections()),
+        // so modes that are never used cost no design work
+        forEachMode([numChannels, internalRate, &spec](auto& filters)
+        {
+            using Stages = typename std::decay_t<decltype(filters)>::Stages;
+
+            filters.chain.prepare(numChannels);
+            filters.driftChain.prepare(numChannels);
+
+            if constexpr (Stages::isBandLimited)
+            {
+                filters.narrowChain.prepare(numChannels);
+                filters.narrowDriftChain.prepare(numChannels);
+            }
+
+            if constexpr (DSP::hasCodec<Stages>)
+            {
+                filters.codec.prepare(Stages::law, spec.sampleRate, numChannels);
+                filters.narrowCodec.prepare(Stages::law, internalRate, numChannels);
+            }
+        });
+
+        // One modulator per rate; both start from the same seed and the current depth
+        drift.prepare(spec.sampleRate);
+        narrowDrift.prepare(multirate.getInternalSampleRate());
+        drift.reset(driftSeed);
+        narrowDrift.reset(driftSeed);
+        driftActive = drift.isActive();
+        narrowDriftActive = narrowDrift.isActive();
+        driftScale.assign(static_cast<size_t>(juce::jmax(maxBlockSize, 1)), 1.0f);
+        driftInput.assign(static_cast<size_t>(numChannels), nullptr);
+        driftOutput.assign(static_cast<size_t>(numChannels), nullptr);
+        codecInput.assign(static_cast<size_t>(numChannels), nullptr);
+        codecOutput.assign(static_cast<size_t>(numChannels), nullptr);
+
+        alignmentDelay.prepare(numChannels, multirate.getLatencySamples());
+        delayedDry.setSize(numChannels, juce::jmax(maxBlockSize, 1));
+
+        // Saturation and noise after the filters; their dry signal can be delayed past both latencies
+        saturation.prepare(spec.sampleRate, maxBlockSize, numChannels);
+        noise.prepare(spec.sampleRate, numChannels);
+        wetStageDryDelay.prepare(numChannels, getWetStageLatencySamples(),
+                                 multirate.getLatencySamples() + saturation.getMaxLatencySamples());
+        wetStageDry.setSize(numChannels, juce::jmax(maxBlockSize, 1));
+        impulseResponse.prepare(spec.sampleRate, maxBlockSize, numChannels);
+        impulseResponse.reset();
+        codecBuffer.setSize(numChannels, juce::jmax(maxBlockSize, 1));
+        outputStage.prepare(spec.sampleRate, maxBlockSize, numChannels);
+        narrowSegment.assign(static_cast<size_t>(numChannels), nullptr);
+
+        // Mode transitions: incoming output at either rate, plus the fade lengths
+        transitionBuffer.setSize(numChannels, juce::jmax(maxBlockSize, 1));
+        narrowTransitionBuffer.setSize(numChannels, juce::jmax(maxBlockSize, 1));
+        narrowIncoming.assign(static_cast<size_t>(numChannels), nullptr);
+        narrowOutgoing.assign(static_cast<size_t>(numChannels), nullptr);
+
+        // Force Mono: the summed channel, processed in its place
+        monoBuffer.setSize(1, juce::jmax(maxBlockSize, 1));
+        prepareModeFades();
+        modeFade.stop();
+        narrowModeFade.stop();
+        modeSettled = false;
+
+        // Silence detection starts awake, with the tail for the current settings
+        updateTailLength();
+        silentSamples = 0;
+        asleep = false;
+
+        // No chain is designed yet: each one is on first use, at the cutoffs of that moment
+        advanceCutoffGeneration();
+        forEachMode([](auto& filters)
+        {
+            filters.generation = filters.driftGeneration = undesignedGeneration;
+            filters.narrowGeneration = filters.narrowDriftGeneration = undesignedGeneration;
+        });
+    }
+
+    //==============================================================================
+    /** Sets the Low Cut (high-pass) and High Cut (low-pass) targets in Hz.
+     * 
+     * Call once per block with the current parameter values. Unchanged values
+     * cost nothing; a change starts a 50 ms ramp applied at control rate.
+     * In multirate mode the High Cut is limited by the internal band
+     * (about 4.1-4.5 kHz).
+     */
+    void setCutoffs(float lowCutHz, float highCutHz)
+    {
+        if (lowCutHz != cutoffs.getTargetValue(lowCutIndex) || highCutHz != cutoffs.getTargetValue(highCutIndex))
+            tailNeedsUpdate = true;
+
+        cutoffs.setTarget(lowCutIndex, lowCutHz);
+        cutoffs.setTarget(highCutIndex, highCutHz);
+    }
+
+    //==============================================================================
+    /** Sets the tuning drift: amount 0..1 (0 = off, 1 = +/- DRIFT_MAX_DEPTH_OCTAVES)
+     *  and the wobble rate in Hz.
+     * 
+     * Call once per block with the current parameter values. Depth changes
+     * are ramped over 50 ms; the chains switch topology on their own once
+     * the drift has ramped in from or back out to zero.
+     */
+    void setDrift(float amount, float rateHz)
+    {
+        const float depth = juce::jlimit(0.0f, 1.0f, amount) * DSP::DRIFT_MAX_DEPTH_OCTAVES;
+        drift.setParameters(depth, rateHz);
+        narrowDrift.setParameters(depth, rateHz);
+
+        if (depth != driftDepth)
+        {
+            driftDepth = depth;
+            tailNeedsUpdate = true;
+        }
+    }
+
+    //==============================================================================
+    /** Applies the parameters that changed since the previous snapshot.
+     * 
+     * Only the dirty groups are touched (cutoff targets, drift depth/rate,
+     * saturation drive, noise), so a block with steady parameters does no
+     * retargeting work at all. Mode and mix are passed to processBlock();
+     * multirate, saturation oversampling and the limiter are left to the
+     * caller, which has to report the latency change to the host.
+     */
+    void setParameters(const DSP::ParameterSnapshot& parameters)
+    {
+        using Snapshot = DSP::ParameterSnapshot;
+
+        if (parameters.isAnyDirty(Snapshot::bit(Snapshot::LowCut) | Snapshot::bit(Snapshot::HighCut)))
+            setCutoffs(parameters.lowCut, parameters.highCut);
+
+        if (parameters.isAnyDirty(Snapshot::bit(Snapshot::Drift) | Snapshot::bit(Snapshot::DriftRate)))
+            setDrift(parameters.drift, parameters.driftRate);
+
+        if (parameters.isDirty(Snapshot::Saturation))
+            setSaturation(parameters.saturation);
+
+        if (parameters.isAnyDirty(Snapshot::bit(Snapshot::NoiseMode) | Snapshot::bit(Snapshot::NoiseLevel)))
+            setNoise(parameters.noiseMode, parameters.noiseLevel);
+
+        if (parameters.isDirty(Snapshot::ForceMono))
+            setForceMono(parameters.forceMono);
+
+        if (parameters.isAnyDirty(Snapshot::bit(Snapshot::CodecBits) | Snapshot::bit(Snapshot::PacketLoss)))
+            setCodec(parameters.codecBits, parameters.packetLoss);
+
+        if (parameters.isDirty(Snapshot::OutputGain))
+            setOutputGain(parameters.outputGain);
+    }
+
+    //==============================================================================
+    /** Sets the saturation drive, 0..1 (0 = off). Changes are ramped over 50 ms. */
+    void setSaturation(float amount)
+    {
+        saturation.setDrive(static_cast<SampleType>(juce::jlimit(0.0f, 1.0f, amount)));
+    }
+
+    /** Runs the saturation at 1x, 2x or 4x the host rate.
+     * 
+     * Everything is prepared up front, so this is real-time safe; the
+     * saturation restarts from cleared state. The host must be told about
+     * the latency change (see getLatencySamples()).
+     */
+    void setSaturationOversampling(int factor)
+    {
+        if (factor == saturation.getOversampling())
+            return;
+
+        saturation.setOversampling(factor);
+        wetStageDryDelay.setDelay(getWetStageLatencySamples());
+        tailNeedsUpdate = true;
+    }
+
+    int getSaturationOversampling() const { return saturation.getOversampling(); }
+
+    //==============================================================================
+    /** Sets the noise: mode 0 = off, 1 = hiss, 2 = vinyl (hiss and crackle), and
+     *  the hiss level in dB. Changes are ramped over 50 ms.
+     */
+    void setNoise(int mode, float levelDb)
+    {
+        noise.setMode(mode);
+        noise.setLevel(levelDb);
+    }
+
+    /** Restarts the noise from a seed. The same seed gives the same noise on
+     *  every render; prepare() restarts it from the last seed set.
+     */
+    void setNoiseSeed(std::uint32_t seed) { noise.reseed(seed); }
+
+    //==============================================================================
+    /** Sets the output gain in dB (OUTPUT_GAIN_MIN_DB..OUTPUT_GAIN_MAX_DB). Changes are ramped over 50 ms. */
+    void setOutputGain(float decibels) { outputStage.setGain(decibels); }
+
+    /** Switches the output limiter in or out.
+     * 
+     * Everything is prepared up front, so this is real-time safe; the
+     * limiter restarts from cleared state. The host must be told about the
+     * latency change (see getLatencySamples()).
+     */
+    void setLimiterEnabled(bool shouldBeEnabled)
+    {
+        if (shouldBeEnabled == outputStage.isLimiting())
+            return;
+
+        outputStage.setLimiting(shouldBeEnabled);
+        tailNeedsUpdate = true;
+    }
+
+    bool isLimiterEnabled() const { return outputStage.isLimiting(); }
+
+    //==============================================================================
+    /** Sets the codec modes' code width (2..8 bits, 8 = plain G.711) and the
+     *  percentage of packets lost (0..100).
+     * 
+     * Both take effect at once (there is nothing to ramp: a code width or a
+     * loss rate is heard per packet anyway).
+     */
+    void setCodec(int bits, float packetLossPercent)
+    {
+        const float probability = juce::jlimit(0.0f, 100.0f, packetLossPercent) * 0.01f;
+
+        forEachMode([bits, probability](auto& filters)
+        {
+            if constexpr (DSP::hasCodec<typename std::decay_t<decltype(filters)>::Stages>)
+            {
+                for (auto* codec : { &filters.codec, &filters.narrowCodec })
+                {
+                    codec->setBits(bits);
+                    codec->setPacketLoss(probability);
+                }
+            }
+        });
+    }
+
+    //==============================================================================
+    /** Hands a new impulse response to the audio thread (message thread).
+     * 
+     * The engine must be freshly prepared for this chain's channel count
+     * (PartitionedConvolver::prepare() allocates and transforms, so build it
+     * off the audio thread). It is taken at the next block; while the mode
+     * plays it is crossfaded in. Engines the chain has finished with are
+     * deleted here, on the caller's thread.
+     */
+    void setImpulseResponse(std::unique_ptr<DSP::PartitionedConvolver<SampleType>> engine)
+    {
+        impulseResponse.submit(std::move(engine));
+    }
+
+    //==============================================================================
+    /** Sums all channels to one before processing and copies the result to every
+     *  output channel (the spec's Force Mono).
+     * 
+     * Real-time safe; the filters restart from cleared state on a change, as
+     * the channel they would continue from no longer matches.
+     */
+    void setForceMono(bool shouldForceMono)
+    {
+        if (shouldForceMono == forceMono)
+            return;
+
+        forceMono = shouldForceMono;
+        reset();
+    }
+
+    bool isForceMono() const { return forceMono; }
+
+    //==============================================================================
+    /** Makes processBlock() add its stage times to profileToFill (nullptr stops it).
+     * 
+     * The profile is owned by the caller, which starts a record before each
+     * block and reads it afterwards, on the thread that calls processBlock().
+     */
+    void setProfile(DSP::BlockProfile* profileToFill) { profile = profileToFill; }
+
+    //==============================================================================
+    /** The band a mode keeps at the given cutoffs, as (lower, upper) in Hz.
+     * 
+     * Read from the mode's stage list (see DSP::Chain::getPassband()), so a
+     * display can follow any mode without knowing its filters. Any thread.
+     */
+    static std::pair<float, float> getModePassband(int mode, double sampleRate, float lowCut, float highCut)
+    {
+        return getModeKernels(juce::jlimit(0, numModes - 1, mode)).passband(sampleRate, lowCut, highCut);
+    }
+
+    //==============================================================================
+    /** Sets how long a mode change crossfades (after a fixed 5 ms warm-up).
+     * 
+     * Call before prepare(); the default is 10 ms.
+     */
+    void setModeCrossfadeTime(double seconds)
+    {
+        modeCrossfadeSeconds = juce::jmax(seconds, 0.0);
+    }
+
+    /** True while a mode change is being crossfaded (two chains running). */
+    bool isModeTransitionActive() const
+    {
+        return activeMode != targetMode;
+    }
+
+    //==============================================================================
+    /** Switches Telephone/Custom between full-rate and multirate processing.
+     * 
+     * Everything is prepared up front, so this is real-time safe; the newly
+     * active path starts from cleared state. The host must be told about the
+     * latency change (see getLatencySamples()).
+     */
+    void setMultirateEnabled(bool shouldBeEnabled)
+    {
+        if (shouldBeEnabled == multirateEnabled)
+            return;
+
+        multirateEnabled = shouldBeEnabled;
+        wetStageDryDelay.setDelay(getWetStageLatencySamples());
+        prepareCutoffRamps();
+        prepareModeFades();
+        reset();
+        tailNeedsUpdate = true;
+    }
+
+    bool isMultirateEnabled() const { return multirateEnabled; }
+
+    /** How long the output keeps ringing after the input stops, in seconds.
+     * 
+     * The slowest decay (down by SILENCE_TAIL_DECAY_DB) over every mode's
+     * sections at the current cutoffs, lowered by the drift depth, plus the
+     * multirate, saturation and limiter latency. Safe to call from any thread.
+     */
+    double getTailLengthSeconds() const
+    {
+        return tailSeconds.load(std::memory_order_relaxed);
+    }
+
+    /** True while the input is silent and the tail has died out (no filter runs). */
+    bool isAsleep() const { return asleep; }
 
-        // Pre-allocate temporary buffer for wet/dry blending
-        // This avoids allocations in real-time processBlock()
-        tempBuffer.setSize(spec.numChannels, spec.maximumBlockSize);
+    /** Processing delay in samples: the multirate latency when enabled plus the
+     *  saturation's oversampling latency and the limiter's lookahead (0 with none).
+     */
+    int getLatencySamples() const
+    {
+        return getWetStageLatencySamples() + outputStage.getLatencySamples();
     }
 
     //==============================================================================
     /** Processes an audio buffer through the selected filter.
      * 
-     * Routes audio through Telephone, Radio, or Custom filter based on
+     * Routes audio through the filter (or convolution, or phone line) of
      * the mode parameter, then blends with dry signal using mix parameter.
      * 
      * Real-Time Safe: No allocations (all state pre-allocated in prepare).
      * 
      * @param buffer The audio buffer to process in-place
-     * @param mode   The selected mode (0=Telephone, 1=Radio, 2=Custom)
+     * @param mode   The selected mode (0=Telephone, 1=Radio, 2=Custom, 3=Impulse response,
+     *               4=mu-law, 5=A-law)
      * @param mix    Wet/dry blend (0.0=dry, 1.0=100% wet effect)
      */
-    void processBlock(juce::AudioBuffer<float>& buffer, int mode, float mix)
+    void processBlock(juce::AudioBuffer<SampleType>& buffer, int mode, float mix)
     {
-        const int numSamples = buffer.getNumSamples();
-        const int numChannels = buffer.getNumChannels();
-
-        // Ensure mix is in valid range [0, 1]
-        mix = juce::jlimit(0.0f, 1.0f, mix);
-
-        // If completely dry (mix=0), bypass processing
-        if (mix < 0.001f)
-        {
-            return;  // Output = input, no processing needed
-        }
+        processBlock(buffer, buffer, mode, mix);
+    }
 
-        // Copy input to temp buffer for wet signal processing
-        tempBuffer.makeCopyOf(buffer, true);
+    /** Out-of-place version: reads input and writes the blended result to output.
+     * 
+     * The filters read the input directly and the blend is folded into the
+     * last filter stage, so no copy of the input is made. At mix == 1 the
+     * dry signal is not touched at all. input and output may be the same
+     * buffer (that is exactly the in-place overload above).
+     * 
+     * @param input  Source audio (not modified unless it is also the output)
+     * @param output Destination buffer (same channel count and length as input)
+     * @param mode   The selected mode (0=Telephone, 1=Radio, 2=Custom, 3=Impulse response,
+     *               4=mu-law, 5=A-law)
+     * @param mix    Wet/dry blend (0.0=dry, 1.0=100% wet effect)
+     */
+    void processBlock(const juce::AudioBuffer<SampleType>& input, juce::AudioBuffer<SampleType>& output,
+                      int mode, float mix)
+    {
+        jassert(input.getNumChannels() == output.getNumChannels());
+        jassert(input.getNumSamples() == output.getNumSamples());
 
-        // Route through selected filter
-        switch (mode)
-        {
-            case 0:
-                // Telephone mode: narrowband effect
-                telephonyFilter.process(tempBuffer);
-                break;
+        const int numChannels = juce::jmin(input.getNumChannels(), output.getNumChannels());
+        const int numSamples = juce::jmin(input.getNumSamples(), output.getNumSamples());
 
-            case 1:
-                // Radio mode: bright, presence effect
-                radioFilter.process(tempBuffer);
-                break;
+        // Ensure mix is in valid range [0, 1]
+        mix = juce::jlimit(0.0f, 1.0f, mix);
 
-            case 2:
-                // Custom mode: both filters chained (extreme effect)
-                telephonyFilter.process(tempBuffer);
-                radioFilter.process(tempBuffer);
-                break;
+        const DSP::StageTimer timer(profile, DSP::BlockProfile::Chain);
 
-            default:
-                // Safety: default to Telephone if invalid mode
-                telephonyFilter.process(tempBuffer);
-                break;
-        }
+        if (forceMono && numChannels > 1)
+            processMono(input, output, numChannels, numSamples, mode, mix);
+        else
+            processChannels(input, output, numChannels, numSamples, mode, mix);
 
-        // Blend wet and dry signals
-        // output = dry * (1 - mix) + wet * mix
-        for (int ch = 0; ch < numChannels; ++ch)
+        if (outputStage.isEngaged())
         {
-            auto* dryPtr = buffer.getWritePointer(ch);
-            const auto* wetPtr = tempBuffer.getReadPointer(ch);
-
-            for (int n = 0; n < numSamples; ++n)
-            {
-                dryPtr[n] = dryPtr[n] * (1.0f - mix) + wetPtr[n] * mix;
-            }
+            const DSP::StageTimer outputTimer(profile, DSP::BlockProfile::Output);
+            outputStage.process(output.getArrayOfWritePointers(), numChannels, numSamples);
         }
     }
 
@@ -130,8 +507,22 @@ public:
      */
     void reset()
     {
-        telephonyFilter.reset();
-        radioFilter.reset();
+        forEachMode([](auto& filters) { filters.reset(); });
+        multirate.reset();
+        alignmentDelay.reset();
+        saturation.reset();
+        wetStageDryDelay.reset();
+        impulseResponse.reset();
+        outputStage.reset();
+
+        // Everything is cleared, so the next block can start in its mode directly
+        modeFade.stop();
+        narrowModeFade.stop();
+        activeMode = targetMode;
+        modeSettled = false;
+
+        silentSamples = 0;
+        asleep = false;
     }
 
     //==============================================================================
@@ -142,15 +533,1068 @@ public:
     }
 
 private:
-    // Filter instances
-    TelephonyFilter telephonyFilter;  ///< Narrowband voice effect
-    RadioFilter radioFilter;          ///< Bright voice effect
+    //==============================================================================
+    /** Everything one mode runs: its chain at either rate and in either topology,
+     *  and the codec after it at either rate. The internal-rate pair is only
+     *  prepared for band-limited chains, the codecs only for codec chains.
+     */
+    template <typename ModeChain>
+    struct ModeFilters
+    {
+        using Stages = ModeChain;
+
+        DSP::BiquadCascade<SampleType> chain;                    ///< Host rate
+        DSP::StateVariableCascade<SampleType> driftChain;        ///< Host rate, while drift is on
+        DSP::BiquadCascade<SampleType> narrowChain;              ///< Internal rate (multirate)
+        DSP::StateVariableCascade<SampleType> narrowDriftChain;
+        DSP::Codec<SampleType> codec;                            ///< Host rate, after chain / driftChain
+        DSP::Codec<SampleType> narrowCodec;                      ///< Internal rate (multirate)
+
+        // cutoffGeneration each cascade was last designed at (undesignedGeneration: not yet)
+        juce::uint32 generation = 0, driftGeneration = 0;
+        juce::uint32 narrowGeneration = 0, narrowDriftGeneration = 0;
+
+        void reset()
+        {
+            chain.reset();
+            driftChain.reset();
+            narrowChain.reset();
+            narrowDriftChain.reset();
+            codec.reset();
+            narrowCodec.reset();
+        }
+    };
+
+    // Every mode with a chain (ModeFilters, kernels): the filter modes, then the codec modes.
+    // In DSP::Mode the impulse response sits between the two (see getModeKernels())
+    using Modes = DSP::JoinChainLists<DSP::ModeChainList, DSP::CodecModeChainList>;
+    static constexpr int impulseResponseMode = DSP::ModeChainList::size;
+    static constexpr int numModes = Modes::size + 1;
+    static_assert(impulseResponseMode == static_cast<int>(DSP::Mode::ImpulseResponse),
+                  "DSP::Mode must list the impulse response after the filter modes");
+    static_assert(impulseResponseMode + 1 == static_cast<int>(DSP::Mode::MuLaw),
+                  "DSP::Mode must list the codec modes after the impulse response");
+
+    /** One mode's entry points, instantiated for its stage list (see getModeKernels()). */
+    struct ModeKernels
+    {
+        void (DSPChain::*process)(const SampleType* const*, SampleType* const*, int, int, float);
+        void (DSPChain::*processNarrow)(SampleType* const*, int, int);
+        void (DSPChain::*reset)();
+        std::pair<float, float> (*passband)(double, float, float);
+        bool bandLimited;   ///< Runs inside the multirate band when multirate is on
+        bool tunable;       ///< Has stages that follow Low Cut / High Cut
+        bool codec;         ///< Runs a DSP::Codec after its chain
+    };
+
+    //==============================================================================
+    /** Everything processBlock() does, on numChannels independent channels: the
+     *  filters, then the saturation and noise when they are in use.
+     * 
+     * Those stages need the wet signal on its own, so while they run the
+     * filters run at full mix and the dry signal (delayed by the whole
+     * latency) is blended in afterwards, in slices of wetStageDry.
+     */
+    void processChannels(const juce::AudioBuffer<SampleType>& input, juce::AudioBuffer<SampleType>& output,
+                         int numChannels, int numSamples, int mode, float mix)
+    {
+        // No wet stages and no latency to keep up with: the filters with the blend folded in, as ever
+        if (!hasWetStages() && wetStageDryDelay.getDelay() == 0)
+        {
+            processFilters(input, output, numChannels, numSamples, mode, mix);
+            return;
+        }
+
+        for (int start = 0; start < numSamples; start += wetStageDry.getNumSamples())
+        {
+            const int blockSize = juce::jmin(wetStageDry.getNumSamples(), numSamples - start);
+
+            auto [in, out] = makeSliceViews(input, output, numChannels, start, blockSize);
+
+            // Delayed dry is kept up to date even while unused, so engaging a wet stage is seamless
+            wetStageDryDelay.process(in.getArrayOfReadPointers(), wetStageDry.getArrayOfWritePointers(),
+                                     numChannels, blockSize);
+
+            if (!hasWetStages())
+            {
+                processFilters(in, out, numChannels, blockSize, mode, mix);
+                continue;
+            }
+
+            processFilters(in, out, numChannels, blockSize, mode, 1.0f);
+
+            // Asleep: the filters left silence, which only the noise changes
+            if (asleep && !noise.isActive())
+                continue;
+
+            if (!asleep)
+            {
+                const DSP::StageTimer timer(profile, DSP::BlockProfile::Saturation);
+                saturation.process(out.getArrayOfWritePointers(), numChannels, blockSize);
+            }
+
+            if (noise.isActive())
+            {
+                const DSP::StageTimer timer(profile, DSP::BlockProfile::Noise);
+                noise.process(out.getArrayOfWritePointers(), numChannels, blockSize);
+            }
+
+            if (mix < 1.0f)
+            {
+                for (int ch = 0; ch < numChannels; ++ch)
+                {
+                    juce::FloatVectorOperations::multiply(out.getWritePointer(ch), static_cast<SampleType>(mix), blockSize);
+                    juce::FloatVectorOperations::addWithMultiply(out.getWritePointer(ch), wetStageDry.getReadPointer(ch),
+                                                                 static_cast<SampleType>(1.0f - mix), blockSize);
+                }
+            }
+        }
+    }
+
+    /** Latency up to the blend (multirate and saturation), which the delayed dry signal matches. */
+    int getWetStageLatencySamples() const
+    {
+        return (multirateEnabled ? multirate.getLatencySamples() : 0) + saturation.getLatencySamples();
+    }
+
+    /** True while saturation or noise has to run on the wet signal. */
+    bool hasWetStages() const { return saturation.isEngaged() || noise.isActive(); }
+
+    /** The filter stage: the active mode (or a mode transition) with mix folded in. */
+    void processFilters(const juce::AudioBuffer<SampleType>& input, juce::AudioBuffer<SampleType>& output,
+                        int numChannels, int numSamples, int mode, float mix)
+    {
+        // A newly set impulse response: crossfaded in while it is heard, swapped in otherwise
+        if (impulseResponse.update(!asleep && modeSettled && isImpulseResponseInUse()))
+            tailNeedsUpdate = true;
+
+        if (tailNeedsUpdate)
+            updateTailLength();
+
+        // Silent input after the tail has died out: nothing to compute
+        if (updateSilence(input, numChannels, numSamples))
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                output.clear(ch, 0, numSamples);
+            return;
+        }
+
+        // A new mode starts a transition (the old chain keeps running until it has faded out)
+        updateModeTransition(mode);
+
+        // Neither mode follows the cutoff ramp (e.g. Radio): finish it instead of splitting the block
+        if (!followsCutoffRamp(activeMode) && !followsCutoffRamp(targetMode) && cutoffs.isSmoothing())
+        {
+            cutoffs.snapToTargets();
+            advanceCutoffGeneration();
+        }
+
+        // Drift starting or stopping: move to the other topology before processing
+        updateDriftTopology();
+
+        // Steady cutoffs, or multirate (which ramps at the internal rate): the whole block in one pass
+        if (multirateEnabled || !cutoffs.isSmoothing())
+        {
+            processModes(input, output, numChannels, numSamples, mix);
+            return;
+        }
+
+        // Cutoff ramp: redesign the sections every control interval
+        for (int start = 0; start < numSamples;)
+        {
+            const int segmentSize = nextCutoffSegment(numSamples - start);
+
+            auto [in, out] = makeSliceViews(input, output, numChannels, start, segmentSize);
+
+            processModes(in, out, numChannels, segmentSize, mix);
+            start += segmentSize;
+        }
+    }
+
+    /** Force Mono: sums the input once per slice of monoBuffer, runs the chain on
+     *  that one channel and copies the result to every output channel.
+     */
+    void processMono(const juce::AudioBuffer<SampleType>& input, juce::AudioBuffer<SampleType>& output,
+                     int numChannels, int numSamples, int mode, float mix)
+    {
+        const auto gain = static_cast<SampleType>(1.0 / numChannels);
+
+        for (int start = 0; start < numSamples;)
+        {
+            const int blockSize = juce::jmin(monoBuffer.getNumSamples(), numSamples - start);
+            auto* sum = monoBuffer.getWritePointer(0);
+
+            {
+                const DSP::StageTimer timer(profile, DSP::BlockProfile::MonoMix);
+
+                juce::FloatVectorOperations::copyWithMultiply(sum, input.getReadPointer(0) + start, gain, blockSize);
+                for (int ch = 1; ch < numChannels; ++ch)
+                    juce::FloatVectorOperations::addWithMultiply(sum, input.getReadPointer(ch) + start, gain, blockSize);
+            }
+
+            // Non-owning view of the summed slice, processed in place
+            juce::AudioBuffer<SampleType> mono(monoBuffer.getArrayOfWritePointers(), 1, 0, blockSize);
+            processChannels(mono, mono, 1, blockSize, mode, mix);
+
+            {
+                const DSP::StageTimer timer(profile, DSP::BlockProfile::MonoMix);
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                    juce::FloatVectorOperations::copy(output.getWritePointer(ch) + start, sum, blockSize);
+            }
+
+            start += blockSize;
+        }
+    }
+
+    //==============================================================================
+    /** One stretch of audio with fixed cutoffs, in the active mode or crossfading to the next. */
+    void processModes(const juce::AudioBuffer<SampleType>& input, juce::AudioBuffer<SampleType>& output,
+                      int numChannels, int numSamples, float mix)
+    {
+        if (activeMode == targetMode)
+        {
+            const DSP::StageTimer timer(profile, DSP::BlockProfile::Filters);
+            processSegment(input, output, numChannels, numSamples, activeMode, mix);
+        }
+        else
+        {
+            const DSP::StageTimer timer(profile, DSP::BlockProfile::Transition);
+            processTransition(input, output, numChannels, numSamples, mix);
+        }
+    }
+
+    /** One stretch of audio with fixed cutoffs: bypass, multirate or full-rate chain. */
+    void processSegment(const juce::AudioBuffer<SampleType>& input, juce::AudioBuffer<SampleType>& output,
+                        int numChannels, int numSamples, int mode, float mix)
+    {
+        if (multirateEnabled)
+        {
+            processMultirate(input, output, numChannels, numSamples, mode, mix);
+            return;
+        }
+
+        // If completely dry (mix=0), bypass processing
+        if (mix < 0.001f)
+        {
+            // Output = input, no processing needed (copy only when out of place)
+            for (int ch = 0; ch < numChannels; ++ch)
+                if (output.getReadPointer(ch) != input.getReadPointer(ch))
+                    juce::FloatVectorOperations::copy(output.getWritePointer(ch), input.getReadPointer(ch), numSamples);
+            return;
+        }
+
+        (this->*getModeKernels(mode).process)(input.getArrayOfReadPointers(), output.getArrayOfWritePointers(),
+                                              numChannels, numSamples, mix);
+    }
+
+    /** Multirate version of processSegment(): every path is delayed by the same
+     *  latency so switching mode or mix never shifts the signal in time.
+     */
+    void processMultirate(const juce::AudioBuffer<SampleType>& input, juce::AudioBuffer<SampleType>& output,
+                          int numChannels, int numSamples, int mode, float mix)
+    {
+        const auto& kernels = getModeKernels(mode);
+
+        // Full-band modes (Radio) stay at the full rate: delay the input, then filter in place
+        if (!kernels.bandLimited || mix < 0.001f)
+        {
+            alignmentDelay.process(input.getArrayOfReadPointers(), output.getArrayOfWritePointers(),
+                                   numChannels, numSamples);
+
+            if (mix >= 0.001f)
+                (this->*kernels.process)(output.getArrayOfReadPointers(), output.getArrayOfWritePointers(),
+                                         numChannels, numSamples, mix);
+            return;
+        }
+
+        // Delayed dry is kept up to date even at mix == 1, so lowering the mix is seamless
+        for (int start = 0; start < numSamples; start += delayedDry.getNumSamples())
+        {
+            const int blockSize = juce::jmin(delayedDry.getNumSamples(), numSamples - start);
+
+            auto [in, out] = makeSliceViews(input, output, numChannels, start, blockSize);
+
+            alignmentDelay.process(in.getArrayOfReadPointers(), delayedDry.getArrayOfWritePointers(),
+                                   numChannels, blockSize);
+
+            multirate.process(in.getArrayOfReadPointers(), out.getArrayOfWritePointers(), numChannels, blockSize,
+                              [this, mode](SampleType* const* channels, int numNarrowChannels, int numNarrowSamples)
+                              {
+                                  processNarrowband(channels, numNarrowChannels, numNarrowSamples, mode);
+                              });
+
+            if (mix < 1.0f)
+            {
+                for (int ch = 0; ch < numChannels; ++ch)
+                {
+                    juce::FloatVectorOperations::multiply(out.getWritePointer(ch), static_cast<SampleType>(mix), blockSize);
+                    juce::FloatVectorOperations::addWithMultiply(out.getWritePointer(ch), delayedDry.getReadPointer(ch),
+                                                                 static_cast<SampleType>(1.0f - mix), blockSize);
+                }
+            }
+        }
+    }
+
+    /** A band-limited mode at the internal rate, with the cutoff ramp ticking at that rate too. */
+    void processNarrowband(SampleType* const* channels, int numChannels, int numSamples, int mode)
+    {
+        for (int start = 0; start < numSamples;)
+        {
+            const int segmentSize = nextCutoffSegment(numSamples - start);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                narrowSegment[(size_t) ch] = channels[ch] + start;
+
+            // Transition between band-limited modes: both run here, at the internal rate
+            if (narrowModeFade.isActive())
+                processNarrowTransition(narrowSegment.data(), numChannels, segmentSize);
+            else
+                processNarrowChain(isNarrowTransition() ? targetMode : mode, narrowSegment.data(), numChannels, segmentSize);
+
+            start += segmentSize;
+        }
+    }
+
+    /** A band-limited mode's chain (biquad or drifting) in place at the internal rate. */
+    void processNarrowChain(int mode, SampleType* const* channels, int numChannels, int numSamples)
+    {
+        (this->*getModeKernels(mode).processNarrow)(channels, numChannels, numSamples);
+    }
+
+    //==============================================================================
+    /** Kernel of one mode at the host rate: its stage list, biquad or drifting,
+     *  and its codec if it has one.
+     */
+    template <std::size_t Mode>
+    void processMode(const SampleType* const* input, SampleType* const* output,
+                     int numChannels, int numSamples, float mix)
+    {
+        using Stages = typename Modes::template At<Mode>;
+
+        if constexpr (DSP::hasCodec<Stages>)
+            processCodecMode<Mode>(input, output, numChannels, numSamples, mix);
+        else
+            processModeChain<Mode>(input, output, numChannels, numSamples, mix);
+    }
+
+    /** One mode's chain at the host rate, with the blend folded in. */
+    template <std::size_t Mode>
+    void processModeChain(const SampleType* const* input, SampleType* const* output,
+                          int numChannels, int numSamples, float mix)
+    {
+        auto& filters = std::get<Mode>(modeFilters);
+        using Stages = typename Modes::template At<Mode>;
+
+        // Drift on: state-variable chain, cutoffs modulated per sample
+        if (driftActive)
+        {
+            processDrifting<Stages>(refreshCutoffSections<Stages>(filters.driftChain, filters.driftGeneration,
+                                                                  currentSpec.sampleRate),
+                                    drift, input, output, numChannels, numSamples, mix);
+            return;
+        }
+
+        // Filter and blend in a single pass:
+        // output = dry * (1 - mix) + wet * mix  (blend skipped at mix == 1)
+        Stages::process(refreshCutoffSections<Stages>(filters.chain, filters.generation, currentSpec.sampleRate),
+                        input, output, numChannels, numSamples, static_cast<SampleType>(mix));
+    }
+
+    /** A codec mode at the host rate: the chain at full mix, the codec, then the blend.
+     * 
+     * Out of place (input[0] != output[0]) or at mix == 1, the output holds the
+     * wet signal while the input is still there to blend with; in place, the
+     * wet signal goes through codecBuffer, in slices of its size.
+     */
+    template <std::size_t Mode>
+    void processCodecMode(const SampleType* const* input, SampleType* const* output,
+                          int numChannels, int numSamples, float mix)
+    {
+        auto& codec = std::get<Mode>(modeFilters).codec;
+
+        // Channel 0 stands for all: callers pass either fully in-place or fully separate
+        // buffers, every channel pointer coming from one AudioBuffer
+        if (mix >= 1.0f || input[0] != output[0])
+        {
+            processModeChain<Mode>(input, output, numChannels, numSamples, 1.0f);
+            codec.process(output, numChannels, numSamples);
+
+            if (mix < 1.0f)
+                blendDry(output, input, numChannels, numSamples, mix);
+            return;
+        }
+
+        for (int start = 0; start < numSamples; start += codecBuffer.getNumSamples())
+        {
+            const int blockSize = juce::jmin(codecBuffer.getNumSamples(), numSamples - start);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                codecInput[(size_t) ch] = input[ch] + start;
+                codecOutput[(size_t) ch] = output[ch] + start;
+            }
+
+            auto* const* wet = codecBuffer.getArrayOfWritePointers();
+            processModeChain<Mode>(codecInput.data(), wet, numChannels, blockSize, 1.0f);
+            codec.process(wet, numChannels, blockSize);
+            blendDry(wet, codecInput.data(), numChannels, blockSize, mix);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                juce::FloatVectorOperations::copy(codecOutput[(size_t) ch], wet[ch], blockSize);
+        }
+    }
+
+    /** Non-owning views of samples [start, start + numSamples) of input and output. */
+    struct SliceViews
+    {
+        const juce::AudioBuffer<SampleType> in;
+        juce::AudioBuffer<SampleType> out;
+    };
+
+    /** AudioBuffer keeps up to 32 channel pointers inline, so the views allocate
+     *  nothing for any supported layout (7.1.4 at most). The const_cast only
+     *  feeds AudioBuffer's constructor: the input view is const.
+     */
+    static SliceViews makeSliceViews(const juce::AudioBuffer<SampleType>& input, juce::AudioBuffer<SampleType>& output,
+                                     int numChannels, int start, int numSamples)
+    {
+        return { juce::AudioBuffer<SampleType>(const_cast<SampleType* const*>(input.getArrayOfReadPointers()),
+                                               numChannels, start, numSamples),
+                 juce::AudioBuffer<SampleType>(output.getArrayOfWritePointers(), numChannels, start, numSamples) };
+    }
+
+    /** output = output * mix + dry * (1 - mix), per channel. */
+    static void blendDry(SampleType* const* output, const SampleType* const* dry, int numChannels, int numSamples,
+                         float mix)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            juce::FloatVectorOperations::multiply(output[ch], static_cast<SampleType>(mix), numSamples);
+            juce::FloatVectorOperations::addWithMultiply(output[ch], dry[ch], static_cast<SampleType>(1.0f - mix),
+                                                         numSamples);
+        }
+    }
+
+    /** Kernel of one band-limited mode at the internal rate, in place. */
+    template <std::size_t Mode>
+    void processNarrowMode(SampleType* const* channels, int numChannels, int numSamples)
+    {
+        auto& filters = std::get<Mode>(modeFilters);
+        using Stages = typename Modes::template At<Mode>;
+        const double internalRate = multirate.getInternalSampleRate();
+
+        if (narrowDriftActive)
+            processDrifting<Stages>(refreshCutoffSections<Stages>(filters.narrowDriftChain, filters.narrowDriftGeneration,
+                                                                  internalRate),
+                                    narrowDrift, channels, channels, numChannels, numSamples, 1.0f);
+        else
+            Stages::process(refreshCutoffSections<Stages>(filters.narrowChain, filters.narrowGeneration, internalRate),
+                            channels, channels, numChannels, numSamples, SampleType(1));
+
+        // Wet only here (the blend is outside the band), so the codec follows the chain directly
+        if constexpr (DSP::hasCodec<Stages>)
+            filters.narrowCodec.process(channels, numChannels, numSamples);
+    }
+
+    /** Clears every chain of one mode. */
+    template <std::size_t Mode>
+    void resetMode()
+    {
+        std::get<Mode>(modeFilters).reset();
+    }
+
+    /** Kernel of the impulse response mode (full band, host rate). */
+    void processImpulseResponse(const SampleType* const* input, SampleType* const* output,
+                                int numChannels, int numSamples, float mix)
+    {
+        impulseResponse.process(input, output, numChannels, numSamples, static_cast<SampleType>(mix));
+    }
+
+    void resetImpulseResponse() { impulseResponse.reset(); }
+
+    /** A response can have any spectrum: the display shows the whole band. */
+    static std::pair<float, float> getFullBandPassband(double sampleRate, float, float)
+    {
+        return { 0.0f, static_cast<float>(sampleRate * 0.5) };
+    }
+
+    /** True while the impulse response is the active mode or being faded in or out. */
+    bool isImpulseResponseInUse() const
+    {
+        return activeMode == impulseResponseMode || targetMode == impulseResponseMode;
+    }
+
+    /** True while a codec mode is the active mode or being faded in or out. */
+    bool isCodecInUse() const
+    {
+        return getModeKernels(activeMode).codec || getModeKernels(targetMode).codec;
+    }
+
+    /** Table entry of the chain at index Chain of Modes. */
+    template <std::size_t Chain>
+    static constexpr ModeKernels makeChainKernels()
+    {
+        using Stages = typename Modes::template At<Chain>;
+
+        return { &DSPChain::processMode<Chain>,
+                 &DSPChain::processNarrowMode<Chain>,
+                 &DSPChain::resetMode<Chain>,
+                 &Stages::template getPassband<float>,
+                 Stages::isBandLimited,
+                 Stages::isTunable,
+                 DSP::hasCodec<Stages> };
+    }
+
+    /** The filter modes' entries, the impulse response's, then the codec modes' (DSP::Mode order). */
+    template <std::size_t... Filter, std::size_t... Codec>
+    static constexpr std::array<ModeKernels, numModes> makeModeKernels(std::index_sequence<Filter...>,
+                                                                       std::index_sequence<Codec...>)
+    {
+        return {{ makeChainKernels<Filter>()...,
+                  ModeKernels { &DSPChain::processImpulseResponse,
+                                nullptr,
+                                &DSPChain::resetImpulseResponse,
+                                &DSPChain::getFullBandPassband,
+                                false,
+                                false,
+                                false },
+                  makeChainKernels<DSP::ModeChainList::size + Codec>()... }};
+    }
+
+    /** The dispatch table entry of a mode (0..numModes-1): one lookup, then a
+     *  direct call into the kernel generated for that mode's stage list (or
+     *  the impulse response's, between the filter and codec modes).
+     */
+    static const ModeKernels& getModeKernels(int mode)
+    {
+        static constexpr auto table = makeModeKernels(std::make_index_sequence<static_cast<std::size_t>(DSP::ModeChainList::size)>(),
+                                                      std::make_index_sequence<static_cast<std::size_t>(DSP::CodecModeChainList::size)>());
+        return table[static_cast<std::size_t>(mode)];
+    }
+
+    /** True if the mode's chain moves with the cutoff ramp where the ramp ticks
+     *  (at the internal rate in multirate mode, which full-band modes do not join).
+     */
+    bool followsCutoffRamp(int mode) const
+    {
+        const auto& kernels = getModeKernels(mode);
+        return kernels.tunable && (kernels.bandLimited || !multirateEnabled);
+    }
+
+    /** Calls function(filters) for every mode's ModeFilters, in mode order. */
+    template <typename Function>
+    void forEachMode(Function&& function)
+    {
+        std::apply([&function](auto&... filters) { (function(filters), ...); }, modeFilters);
+    }
+
+    //==============================================================================
+    /** Runs a state-variable chain with its cutoffs scaled per sample by a drift
+     *  modulator (in pieces of at most driftScale.size() samples).
+     */
+    template <typename Stages>
+    void processDrifting(DSP::StateVariableCascade<SampleType>& chain, DSP::DriftModulator<SampleType>& modulator,
+                         const SampleType* const* input, SampleType* const* output,
+                         int numChannels, int numSamples, float mix)
+    {
+        for (int start = 0; start < numSamples;)
+        {
+            const int blockSize = juce::jmin(static_cast<int>(driftScale.size()), numSamples - start);
+            modulator.render(driftScale.data(), blockSize);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                driftInput[(size_t) ch] = input[ch] + start;
+                driftOutput[(size_t) ch] = output[ch] + start;
+            }
+
+            Stages::process(chain, driftInput.data(), driftOutput.data(), numChannels, blockSize,
+                            static_cast<SampleType>(mix), driftScale.data());
+            start += blockSize;
+        }
+    }
+
+    //==============================================================================
+    /** Tracks how long the input has been silent; returns true while asleep.
+     * 
+     * A block is processed as usual until the silence has outlasted the tail
+     * (measured before the block, so the whole tail is always rendered). At
+     * that point the state is cleared to exact zeros, which is what it has
+     * decayed to, and nothing runs until the input comes back.
+     */
+    bool updateSilence(const juce::AudioBuffer<SampleType>& input, int numChannels, int numSamples)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            if (input.getMagnitude(ch, 0, numSamples) >= DSP::SILENCE_THRESHOLD)
+            {
+                silentSamples = 0;
+                asleep = false;
+                return false;
+            }
+        }
+
+        if (asleep)
+            return true;
+
+        if (silentSamples < tailSamples)
+        {
+            silentSamples += numSamples;
+            return false;
+        }
+
+        // Decayed: clear everything and finish any ramp (no one can hear it)
+        reset();
+        if (cutoffs.isSmoothing())
+        {
+            cutoffs.snapToTargets();
+            advanceCutoffGeneration();
+        }
+
+        asleep = true;
+        return true;
+    }
+
+    /** Recomputes the tail for the current cutoff targets, drift depth and latency.
+     * 
+     * A chain's tail is the sum of its sections' decays; the longest over all
+     * modes (Custom, which runs the Telephone and Radio sections in series)
+     * bounds whichever mode runs. Decay time scales inversely with cutoff, so
+     * drift, which can pull every cutoff down by driftDepth octaves,
+     * stretches it by 2^driftDepth. While the impulse response is in use its
+     * length counts too (it is only that long while heard, so other modes
+     * are not held awake by it), and likewise a codec mode's packet and
+     * concealment fade.
+     */
+    void updateTailLength()
+    {
+        const double sampleRate = currentSpec.sampleRate;
+        const auto lowCut = static_cast<SampleType>(cutoffs.getTargetValue(lowCutIndex));
+        const auto highCut = static_cast<SampleType>(cutoffs.getTargetValue(highCutIndex));
+
+        double decaySamples = 0.0;
+        forEachMode([&](auto& filters)
+        {
+            using Stages = typename std::decay_t<decltype(filters)>::Stages;
+            decaySamples = juce::jmax(decaySamples, Stages::getDecaySamples(sampleRate, lowCut, highCut,
+                                                                            DSP::SILENCE_TAIL_DECAY_DB));
+        });
+
+        decaySamples = decaySamples * std::exp2(static_cast<double>(driftDepth));
+
+        if (isImpulseResponseInUse())
+            decaySamples = juce::jmax(decaySamples, static_cast<double>(impulseResponse.getLengthInSamples()));
+
+        if (isCodecInUse())
+            decaySamples += DSP::Codec<SampleType>::getTailSeconds() * sampleRate;
+
+        decaySamples += getLatencySamples();
+        decaySamples = juce::jmin(decaySamples, maxTailSeconds * sampleRate);
+
+        tailSamples = static_cast<int>(std::ceil(decaySamples));
+        tailSeconds.store(tailSamples / sampleRate, std::memory_order_relaxed);
+        tailNeedsUpdate = false;
+    }
+
+    //==============================================================================
+    /** Starts a transition when the requested mode differs from the active one.
+     * 
+     * The first block after prepare() / reset() adopts its mode directly
+     * (nothing to fade from); requests during a transition wait for it.
+     */
+    void updateModeTransition(int mode)
+    {
+        mode = (mode >= 0 && mode < numModes) ? mode : 0;  // Invalid modes run as Telephone
+
+        if (!modeSettled)
+        {
+            if (mode != activeMode)
+                tailNeedsUpdate = true;
+
+            activeMode = targetMode = mode;
+            modeSettled = true;
+            return;
+        }
+
+        if (activeMode != targetMode || mode == activeMode)
+            return;
+
+        targetMode = mode;
+        tailNeedsUpdate = true;   // The impulse response's length and the codec's tail only count while in use
+
+        // The incoming chains hold stale state from whenever they last ran
+        (this->*getModeKernels(targetMode).reset)();
+
+        // Full-band modes bypass the multirate band, so leaving one finds it stale too
+        if (multirateEnabled && !getModeKernels(activeMode).bandLimited)
+            multirate.reset();
+
+        if (isNarrowTransition())
+            narrowModeFade.start();
+        else
+            modeFade.start();
+    }
+
+    /** Between band-limited modes (Telephone <-> Custom) with multirate on: the
+     *  fade runs inside the internal band.
+     */
+    bool isNarrowTransition() const
+    {
+        return multirateEnabled && getModeKernels(activeMode).bandLimited && getModeKernels(targetMode).bandLimited;
+    }
+
+    /** Both modes' output for one stretch, the incoming one faded in over the outgoing one. */
+    void processTransition(const juce::AudioBuffer<SampleType>& input, juce::AudioBuffer<SampleType>& output,
+                           int numChannels, int numSamples, float mix)
+    {
+        if (isNarrowTransition())
+        {
+            processMultirate(input, output, numChannels, numSamples, activeMode, mix);
+            if (!narrowModeFade.isActive())
+                activeMode = targetMode;
+            return;
+        }
+
+        for (int start = 0; start < numSamples;)
+        {
+            const int blockSize = juce::jmin(transitionBuffer.getNumSamples(), numSamples - start);
+
+            auto [in, out] = makeSliceViews(input, output, numChannels, start, blockSize);
+            juce::AudioBuffer<SampleType> incoming(transitionBuffer.getArrayOfWritePointers(), numChannels, 0, blockSize);
+
+            if (multirateEnabled)
+            {
+                processMultirateTransition(in, out, incoming, numChannels, blockSize, mix);
+            }
+            else
+            {
+                // Incoming first (out may be the input); both see the same drift modulation
+                const auto driftBefore = drift;
+                processSegment(in, incoming, numChannels, blockSize, targetMode, mix);
+                drift = driftBefore;
+                processSegment(in, out, numChannels, blockSize, activeMode, mix);
+            }
+
+            modeFade.process(out.getArrayOfWritePointers(), incoming.getArrayOfReadPointers(), numChannels, blockSize);
+            start += blockSize;
+
+            if (!modeFade.isActive())
+            {
+                activeMode = targetMode;
+
+                if (start < numSamples)
+                {
+                    auto [restIn, restOut] = makeSliceViews(input, output, numChannels, start, numSamples - start);
+                    processSegment(restIn, restOut, numChannels, numSamples - start, activeMode, mix);
+                }
+                return;
+            }
+        }
+    }
+
+    /** A transition with multirate on that involves a full-band mode (Radio):
+     *  a band-limited side runs as usual (which also delays the dry signal), a
+     *  full-band side runs on that delayed input.
+     */
+    void processMultirateTransition(const juce::AudioBuffer<SampleType>& input, juce::AudioBuffer<SampleType>& output,
+                                    juce::AudioBuffer<SampleType>& incoming, int numChannels, int numSamples, float mix)
+    {
+        // Fully dry: every mode is the delayed input
+        if (mix < 0.001f)
+        {
+            processMultirate(input, output, numChannels, numSamples, activeMode, mix);
+            for (int ch = 0; ch < numChannels; ++ch)
+                juce::FloatVectorOperations::copy(incoming.getWritePointer(ch), output.getReadPointer(ch), numSamples);
+            return;
+        }
+
+        const bool fullBandOutgoing = !getModeKernels(activeMode).bandLimited;
+        const bool fullBandIncoming = !getModeKernels(targetMode).bandLimited;
+
+        // Both full-band: one delay, then each mode in place (both see the same drift modulation)
+        if (fullBandOutgoing && fullBandIncoming)
+        {
+            alignmentDelay.process(input.getArrayOfReadPointers(), output.getArrayOfWritePointers(),
+                                   numChannels, numSamples);
+            for (int ch = 0; ch < numChannels; ++ch)
+                juce::FloatVectorOperations::copy(incoming.getWritePointer(ch), output.getReadPointer(ch), numSamples);
+
+            const auto driftBefore = drift;
+            (this->*getModeKernels(targetMode).process)(incoming.getArrayOfReadPointers(), incoming.getArrayOfWritePointers(),
+                                                        numChannels, numSamples, mix);
+            drift = driftBefore;
+            (this->*getModeKernels(activeMode).process)(output.getArrayOfReadPointers(), output.getArrayOfWritePointers(),
+                                                        numChannels, numSamples, mix);
+            return;
+        }
+
+        auto& narrowOutput = fullBandOutgoing ? incoming : output;
+        auto& fullBandOutput = fullBandOutgoing ? output : incoming;
+        const int fullBandMode = fullBandOutgoing ? activeMode : targetMode;
+
+        // Narrowband first: it reads the input (output may be the input) and fills delayedDry
+        processMultirate(input, narrowOutput, numChannels, numSamples, fullBandOutgoing ? targetMode : activeMode, mix);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            juce::FloatVectorOperations::copy(fullBandOutput.getWritePointer(ch), delayedDry.getReadPointer(ch), numSamples);
+
+        (this->*getModeKernels(fullBandMode).process)(fullBandOutput.getArrayOfReadPointers(),
+                                                      fullBandOutput.getArrayOfWritePointers(),
+                                                      numChannels, numSamples, mix);
+    }
+
+    /** Between band-limited modes inside the multirate band (called from processNarrowband()). */
+    void processNarrowTransition(SampleType* const* channels, int numChannels, int numSamples)
+    {
+        for (int start = 0; start < numSamples;)
+        {
+            const int blockSize = juce::jmin(narrowTransitionBuffer.getNumSamples(), numSamples - start);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                narrowOutgoing[(size_t) ch] = channels[ch] + start;
+                narrowIncoming[(size_t) ch] = narrowTransitionBuffer.getWritePointer(ch);
+                juce::FloatVectorOperations::copy(narrowIncoming[(size_t) ch], narrowOutgoing[(size_t) ch], blockSize);
+            }
+
+            const auto driftBefore = narrowDrift;
+            processNarrowChain(targetMode, narrowIncoming.data(), numChannels, blockSize);
+            narrowDrift = driftBefore;
+            processNarrowChain(activeMode, narrowOutgoing.data(), numChannels, blockSize);
+
+            narrowModeFade.process(narrowOutgoing.data(), narrowIncoming.data(), numChannels, blockSize);
+            start += blockSize;
+
+            if (!narrowModeFade.isActive())
+            {
+                // activeMode is switched by processTransition() once the band returns
+                for (int ch = 0; ch < numChannels; ++ch)
+                    narrowOutgoing[(size_t) ch] = channels[ch] + start;
+
+                if (start < numSamples)
+                    processNarrowChain(targetMode, narrowOutgoing.data(), numChannels, numSamples - start);
+                return;
+            }
+        }
+    }
+
+    /** Fade lengths at each rate; with multirate on, the warm-up also covers the band's latency. */
+    void prepareModeFades()
+    {
+        const double latencySeconds = multirateEnabled ? multirate.getLatencySamples() / currentSpec.sampleRate : 0.0;
+
+        modeFade.prepare(currentSpec.sampleRate, modeWarmupSeconds + latencySeconds, modeCrossfadeSeconds);
+        narrowModeFade.prepare(multirate.getInternalSampleRate(), modeWarmupSeconds, modeCrossfadeSeconds);
+    }
+
+    //==============================================================================
+    /** Moves each rate's chains to the state-variable topology when its drift
+     *  becomes active, and back once it has ramped out to exactly zero.
+     * 
+     * The filter state is handed over section by section (see
+     * DSP::transferCascadeState()), so the output carries on without a click.
+     */
+    void updateDriftTopology()
+    {
+        const int numChannels = static_cast<int>(currentSpec.numChannels);
+
+        if (drift.isActive() != driftActive)
+        {
+            driftActive = !driftActive;
+            const double sampleRate = currentSpec.sampleRate;
+
+            forEachMode([this, numChannels, sampleRate](auto& filters)
+            {
+                using Stages = typename std::decay_t<decltype(filters)>::Stages;
+                auto& chain = refreshCutoffSections<Stages>(filters.chain, filters.generation, sampleRate);
+                auto& driftChain = refreshCutoffSections<Stages>(filters.driftChain, filters.driftGeneration, sampleRate);
+
+                if (driftActive)
+                    DSP::transferCascadeState(chain, driftChain, numChannels);
+                else
+                    DSP::transferCascadeState(driftChain, chain, numChannels);
+            });
+        }
+
+        if (narrowDrift.isActive() != narrowDriftActive)
+        {
+            narrowDriftActive = !narrowDriftActive;
+            const double internalRate = multirate.getInternalSampleRate();
+
+            forEachMode([this, numChannels, internalRate](auto& filters)
+            {
+                using Stages = typename std::decay_t<decltype(filters)>::Stages;
+
+                if constexpr (Stages::isBandLimited)
+                {
+                    auto& chain = refreshCutoffSections<Stages>(filters.narrowChain, filters.narrowGeneration, internalRate);
+                    auto& driftChain = refreshCutoffSections<Stages>(filters.narrowDriftChain, filters.narrowDriftGeneration,
+                                                                     internalRate);
+
+                    if (narrowDriftActive)
+                        DSP::transferCascadeState(chain, driftChain, numChannels);
+                    else
+                        DSP::transferCascadeState(driftChain, chain, numChannels);
+                }
+            });
+        }
+    }
+
+    //==============================================================================
+    /** (Re)starts the cutoff ramps at the rate the cutoff sections run at. */
+    void prepareCutoffRamps()
+    {
+        const double rampRate = multirateEnabled ? multirate.getInternalSampleRate() : currentSpec.sampleRate;
+        const int controlInterval = juce::jmax(16, juce::roundToInt(rampRate * cutoffControlSeconds));
+
+        cutoffs.prepare(rampRate, controlInterval, cutoffRampSeconds);
+        samplesUntilCutoffTick = 0;
+        advanceCutoffGeneration();
+    }
+
+    /** Ticks the cutoff ramp when a control interval is due and returns how many
+     *  samples can run before the next tick (all of them when no ramp is active).
+     *  The interval carries over block boundaries, so ramp time does not depend
+     *  on the host block size.
+     */
+    int nextCutoffSegment(int numSamplesLeft)
+    {
+        if (!cutoffs.isSmoothing())
+        {
+            samplesUntilCutoffTick = 0;  // A new ramp starts on its first sample
+            return numSamplesLeft;
+        }
+
+        if (samplesUntilCutoffTick == 0)
+        {
+            cutoffs.tick();
+            advanceCutoffGeneration();
+            samplesUntilCutoffTick = cutoffs.getControlInterval();
+        }
+
+        const int segmentSize = juce::jmin(samplesUntilCutoffTick, numSamplesLeft);
+        samplesUntilCutoffTick -= segmentSize;
+        return segmentSize;
+    }
+
+    /** Brings a chain's Low Cut / High Cut stages up to date.
+     * 
+     * Skipped entirely unless the cutoffs moved since this chain was last
+     * designed (and compiled out for chains without such stages); filter
+     * state is kept, so a sweep does not click. Works for both topologies.
+     * A chain that was never designed since prepare() gets all its sections
+     * here (plain arithmetic, no allocation), which is what makes preparing
+     * unused modes free.
+     */
+    template <typename Stages, typename Cascade>
+    Cascade& refreshCutoffSections(Cascade& chain, juce::uint32& chainGeneration, double sampleRate)
+    {
+        if (chainGeneration == undesignedGeneration)
+        {
+            Stages::design(chain, sampleRate,
+                           static_cast<SampleType>(cutoffs.getCurrentValue(lowCutIndex)),
+                           static_cast<SampleType>(cutoffs.getCurrentValue(highCutIndex)));
+            chainGeneration = cutoffGeneration;
+            return chain;
+        }
+
+        if constexpr (Stages::isTunable)
+        {
+            if (chainGeneration != cutoffGeneration)
+            {
+                Stages::retune(chain, sampleRate,
+                               static_cast<SampleType>(cutoffs.getCurrentValue(lowCutIndex)),
+                               static_cast<SampleType>(cutoffs.getCurrentValue(highCutIndex)));
+                chainGeneration = cutoffGeneration;
+            }
+        }
+
+        return chain;
+    }
+
+    /** Marks a cutoff change; never lands on undesignedGeneration, even after wrapping. */
+    void advanceCutoffGeneration()
+    {
+        if (++cutoffGeneration == undesignedGeneration)
+            ++cutoffGeneration;
+    }
+
+    // Fused filter chains: every mode's cascades, one ModeFilters per Modes entry (filter, then codec modes)
+    typename Modes::template Map<ModeFilters> modeFilters;
+
+    // Multirate path (band-limited modes at the decimated rate) and latency alignment
+    DSP::MultirateBand<SampleType> multirate;
+    DSP::BlockDelay<SampleType> alignmentDelay;          ///< Dry / Radio delayed by the multirate latency
+    juce::AudioBuffer<SampleType> delayedDry;
+    bool multirateEnabled = false;
+
+    // Saturation and noise on the wet signal, and the dry signal delayed to meet them
+    DSP::Saturation<SampleType> saturation;
+    DSP::NoiseGenerator<SampleType> noise;
+    DSP::BlockDelay<SampleType> wetStageDryDelay;        ///< Multirate plus saturation latency
+    juce::AudioBuffer<SampleType> wetStageDry;
+
+    // Output gain and limiter, after the blend
+    DSP::OutputStage<SampleType> outputStage;
+
+    // Impulse response mode: the convolution engine in use, swapped in from the message thread
+    DSP::ImpulseResponseSlot<SampleType> impulseResponse;
+
+    // Codec modes processed in place below full mix: the wet signal, kept apart from the dry one
+    juce::AudioBuffer<SampleType> codecBuffer;
+    std::vector<const SampleType*> codecInput;                 ///< Offset channel pointers for processCodecMode()
+    std::vector<SampleType*> codecOutput;
+
+    // Tuning drift: one modulator per rate (the state-variable twins live in modeFilters)
+    DSP::DriftModulator<SampleType> drift;
+    DSP::DriftModulator<SampleType> narrowDrift;
+    static constexpr std::uint32_t driftSeed = 0x9e3779b9;
+    std::vector<SampleType> driftScale;                        ///< Per-sample cutoff multipliers
+    std::vector<const SampleType*> driftInput;                 ///< Offset channel pointers for processDrifting()
+    std::vector<SampleType*> driftOutput;
+    bool driftActive = false, narrowDriftActive = false;  ///< Which topology each rate currently runs
+
+    // Mode transitions: only while switching does a second chain run
+    static constexpr double modeWarmupSeconds = 0.005;    ///< Incoming chain runs unheard (start-up transient)
+    double modeCrossfadeSeconds = 0.01;
+    DSP::ModeCrossfade<SampleType> modeFade;                   ///< At the host rate
+    DSP::ModeCrossfade<SampleType> narrowModeFade;             ///< At the internal rate (Telephone <-> Custom, multirate)
+    juce::AudioBuffer<SampleType> transitionBuffer;            ///< Incoming mode's output
+    juce::AudioBuffer<SampleType> narrowTransitionBuffer;
+    std::vector<SampleType*> narrowIncoming, narrowOutgoing;   ///< Channel pointers inside the narrowband callback
+    int activeMode = 0, targetMode = 0;                   ///< Equal unless a transition is running
+    bool modeSettled = false;                             ///< False until the first block after prepare() / reset()
+
+    // Silence detection: the tail decides how long silent input is still processed
+    static constexpr double maxTailSeconds = 10.0;        ///< Cap for unstable/degenerate designs
+    std::atomic<double> tailSeconds { 0.0 };              ///< Published for the host (any thread)
+    int tailSamples = 0;
+    int silentSamples = 0;                                ///< Silent input since the last sound (capped at the tail)
+    float driftDepth = 0.0f;                              ///< Drift target in octaves (stretches the tail)
+    bool tailNeedsUpdate = true;
+    bool asleep = false;
+
+    // Low Cut / High Cut: control-rate ramps plus a change counter per chain
+    static constexpr int lowCutIndex = 0;
+    static constexpr int highCutIndex = 1;
+    static constexpr double cutoffControlSeconds = 0.001;  ///< ~1 kHz coefficient update rate while ramping
+    static constexpr double cutoffRampSeconds = 0.05;     ///< 50 ms, as for the other smoothed parameters
+    DSP::ControlRateSmoother<2> cutoffs;
+    std::vector<SampleType*> narrowSegment;                    ///< Offset channel pointers inside the narrowband callback
+    int samplesUntilCutoffTick = 0;
+    static constexpr juce::uint32 undesignedGeneration = 0;  ///< A chain's generation before its first design
+    juce::uint32 cutoffGeneration = 1;                    ///< Bumped on every cutoff change (see ModeFilters)
+
+    // Force Mono: one summed channel stands in for all of them
+    juce::AudioBuffer<SampleType> monoBuffer;
+    bool forceMono = false;
 
-    // Pre-allocated temporary buffer for wet signal (avoids real-time allocations)
-    juce::AudioBuffer<float> tempBuffer;
+    // Optional stage timing (owned by the caller, see setProfile())
+    DSP::BlockProfile* profile = nullptr;
 
     // Stored audio specification
-    juce::dsp::ProcessSpec currentSpec;
+    juce::dsp::ProcessSpec currentSpec { 44100.0, 512, 2 };
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DSPChain)
 };
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+
+//==============================================================================
+/**
+ * DesignCache - Process-wide cache of immutable filter designs
+ *
+ * Filter designs depend only on their parameters (sample rate, band edges,
+ * preset), so every instance running at the same rate needs exactly the
+ * same values. get() returns the design for a key, computing it with the
+ * given function the first time and handing out the same shared, const
+ * object afterwards: a session of 200 instances designs once and keeps one
+ * copy.
+ *
+ * Entries are held weakly, so a design is freed once the last filter using
+ * it is re-prepared or destroyed (e.g. after a sample-rate change) and the
+ * cache never pins memory for rates nobody runs at any more.
+ *
+ * One cache per (Key, Value) type, shared by the whole process (see
+ * getShared()); Key needs operator<.
+ *
+ * Real-Time Safety: ❌ (prepare-time only)
+ * - get() locks and may allocate and design; call it from prepare(), never
+ *   from process(). Holding the returned pointer is free.
+ */
+namespace DSP {
+
+template <typename Key, typename Value>
+class DesignCache
+{
+public:
+    /** The process-wide cache for this Key/Value pair. */
+    static DesignCache& getShared()
+    {
+        static DesignCache cache;
+        return cache;
+    }
+
+    /** The shared design for key, made by makeDesign() (returning a Value) if nobody holds one. */
+    template <typename MakeDesign>
+    std::shared_ptr<const Value> get(const Key& key, MakeDesign&& makeDesign)
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+
+        if (auto found = entries.find(key); found != entries.end())
+            if (auto design = found->second.lock())
+                return design;
+
+        // A new design: drop the entries nobody holds any more while we are here
+        for (auto it = entries.begin(); it != entries.end();)
+            it = it->second.expired() ? entries.erase(it) : std::next(it);
+
+        auto design = std::make_shared<const Value>(makeDesign());
+        entries[key] = design;
+        return design;
+    }
+
+    /** Number of designs currently alive (for tests and diagnostics). */
+    int getNumLiveDesigns() const
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+
+        int count = 0;
+        for (const auto& entry : entries)
+            count += entry.second.expired() ? 0 : 1;
+        return count;
+    }
+
+private:
+    DesignCache() = default;
+
+    mutable std::mutex mutex;
+    std::map<Key, std::weak_ptr<const Value>> entries;
+};
+
+} // namespace DSP
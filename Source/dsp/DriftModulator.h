@@ -0,0 +1,190 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+//==============================================================================
+/**
+ * DriftModulator - Per-sample cutoff multiplier for tuning drift / wobble
+ *
+ * Renders scale = 2^(depth * m) per sample, where m in [-1, 1] is half a
+ * sine LFO and half a slow random wander (smoothstep between random points,
+ * one per LFO period), so the filters both wobble and drift off pitch. The
+ * result is meant for StateVariableCascade's cutoffScale input; depth is in
+ * octaves.
+ *
+ * Cheap enough to run every sample without a table: the LFO is a rotating
+ * phasor (no sin() calls), the wander is a cubic and 2^x is a short
+ * polynomial, all evaluated every 8 samples and interpolated linearly in
+ * between (the rates involved are a few Hz). Depth changes are ramped
+ * (linear, 50 ms), and a ramp down to zero ends on exactly 1.0, so the
+ * caller can switch back to a static filter once isActive() turns false.
+ *
+ * Real-Time Safety: ✅
+ * - No allocation, no locks, no system calls
+ * - Deterministic per seed (xorshift), so renders are repeatable
+ */
+namespace DSP {
+
+template <typename SampleType>
+class DriftModulator
+{
+public:
+    DriftModulator() = default;
+
+    /** Sets the rate everything runs at; keeps the current depth, phase and seed. */
+    void prepare(double newSampleRate)
+    {
+        sampleRate = std::max(newSampleRate, 1.0);
+        rampSamples = std::max(1, static_cast<int>(rampSeconds * sampleRate));
+        updateRate();
+    }
+
+    /** Restarts the LFO and the wander from a seed; depth jumps to its target. */
+    void reset(std::uint32_t newSeed = 1)
+    {
+        seed = newSeed != 0 ? newSeed : 1;
+        sine = 0.0;
+        cosine = 1.0;
+        wanderFrom = wanderTo = 0.0;
+        wanderPosition = 0.0;
+        depth = targetDepth;
+        depthStep = 0.0;
+        depthRampLeft = 0;
+        previousScale = nextScale = 1.0;
+        samplesUntilUpdate = 0;
+    }
+
+    /** Depth in octaves (0 = off) and LFO rate in Hz; depth changes are ramped. */
+    void setParameters(SampleType depthOctaves, SampleType rateHz)
+    {
+        const double newDepth = std::max(static_cast<double>(depthOctaves), 0.0);
+        if (newDepth != targetDepth)
+        {
+            targetDepth = newDepth;
+            depthRampLeft = rampSamples;
+            depthStep = (targetDepth - depth) / rampSamples;
+        }
+
+        const double newRate = std::max(static_cast<double>(rateHz), 0.001);
+        if (newRate != rate)
+        {
+            rate = newRate;
+            updateRate();
+        }
+    }
+
+    /** True while the output can differ from 1.0 (depth, its target or the last output). */
+    bool isActive() const
+    {
+        return depth > 0.0 || targetDepth > 0.0 || previousScale != 1.0 || nextScale != 1.0;
+    }
+
+    //==============================================================================
+    /** Writes numSamples cutoff multipliers. */
+    void render(SampleType* scale, int numSamples)
+    {
+        for (int n = 0; n < numSamples;)
+        {
+            if (samplesUntilUpdate == 0)
+            {
+                previousScale = nextScale;
+                nextScale = advance();
+                samplesUntilUpdate = updateInterval;
+            }
+
+            // Counts down to exactly nextScale (so a finished ramp ends on 1.0)
+            const int count = std::min(samplesUntilUpdate, numSamples - n);
+            const double step = (nextScale - previousScale) * (1.0 / updateInterval);
+            samplesUntilUpdate -= count;
+
+            for (int i = 0; i < count; ++i)
+                scale[n + i] = static_cast<SampleType>(nextScale - step * (samplesUntilUpdate + count - 1 - i));
+
+            n += count;
+        }
+
+        // Keep the phasor on the unit circle (rounding drifts it slowly)
+        const double gain = (3.0 - (sine * sine + cosine * cosine)) * 0.5;
+        sine *= gain;
+        cosine *= gain;
+    }
+
+private:
+    /** Moves everything on by one update interval and returns the multiplier there. */
+    double advance()
+    {
+        // Wander: smoothstep from one random point to the next
+        wanderPosition += wanderIncrement;
+        if (wanderPosition >= 1.0)
+        {
+            wanderPosition -= std::floor(wanderPosition);
+            wanderFrom = wanderTo;
+            wanderTo = nextRandom();
+        }
+
+        const double t = wanderPosition;
+        const double wander = wanderFrom + (wanderTo - wanderFrom) * t * t * (3.0 - 2.0 * t);
+
+        // LFO: rotate the phasor
+        const double s = sine * rotationCos + cosine * rotationSin;
+        cosine = cosine * rotationCos - sine * rotationSin;
+        sine = s;
+
+        if (depthRampLeft > 0)
+        {
+            depthRampLeft = std::max(depthRampLeft - updateInterval, 0);
+            depth = depthRampLeft == 0 ? targetDepth : targetDepth - depthStep * depthRampLeft;
+        }
+
+        return depth > 0.0 ? exp2Approx(depth * 0.5 * (sine + wander)) : 1.0;
+    }
+
+    void updateRate()
+    {
+        const double angle = 2.0 * 3.141592653589793 * rate * updateInterval / sampleRate;
+        rotationSin = std::sin(angle);
+        rotationCos = std::cos(angle);
+        wanderIncrement = rate * updateInterval / sampleRate;
+    }
+
+    /** Uniform in [-1, 1] (xorshift32). */
+    double nextRandom()
+    {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        return seed * (2.0 / 4294967295.0) - 1.0;
+    }
+
+    /** 2^x for |x| <= a few octaves: 2^x = (e^(x ln2 / 2))^2, degree-5 Taylor, exact at 0. */
+    static double exp2Approx(double x)
+    {
+        const double y = x * (0.6931471805599453 * 0.5);
+        const double e = 1.0 + y * (1.0 + y * (0.5 + y * (1.0 / 6.0 + y * (1.0 / 24.0 + y * (1.0 / 120.0)))));
+        return e * e;
+    }
+
+    static constexpr int updateInterval = 8;   ///< Samples between exact evaluations (linear in between)
+    static constexpr double rampSeconds = 0.05;
+
+    double sampleRate = 44100.0;
+    double rate = 0.5;
+    int rampSamples = 1;
+
+    double sine = 0.0, cosine = 1.0;
+    double rotationSin = 0.0, rotationCos = 1.0;
+
+    double wanderFrom = 0.0, wanderTo = 0.0;
+    double wanderPosition = 0.0, wanderIncrement = 0.0;
+    std::uint32_t seed = 1;
+
+    double depth = 0.0, targetDepth = 0.0, depthStep = 0.0;
+    int depthRampLeft = 0;
+
+    double previousScale = 1.0, nextScale = 1.0;
+    int samplesUntilUpdate = 0;
+};
+
+} // namespace DSP
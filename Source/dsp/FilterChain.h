@@ -0,0 +1,321 @@
+#pragma once
+
+#include "BiquadCascade.h"
+#include "StateVariableCascade.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <utility>
+
+//==============================================================================
+/**
+ * FilterChain - Compile-time description of a fused filter chain
+ *
+ * A chain is a type list of stages, e.g.
+ *
+ *     using Telephone = Chain<HighPass<LowCutVoicing>, LowPass<HighCutVoicing>>;
+ *
+ * where each stage names a response (HighPass, LowPass, Peak) and a voicing:
+ * a struct of static constexpr values giving its frequency, q (and gain for
+ * Peak) and whether the frequency follows a parameter (StageControl). From
+ * that list the chain knows, at compile time,
+ *
+ *   - how many sections it has, so process() calls the cascade kernel
+ *     instantiated for exactly that count (sections in registers, section
+ *     loop unrolled, no per-block switch on the section count)
+ *   - how to design every section for a sample rate, in either topology
+ *     (BiquadCascade, or StateVariableCascade for tuning drift)
+ *   - which sections follow Low Cut / High Cut, so retune() redesigns only
+ *     those and compiles to nothing for a chain without any
+ *   - whether its band is bounded by the High Cut (isBandLimited), i.e.
+ *     whether it can run inside the multirate band
+ *   - the band it keeps (getPassband(), e.g. for the editor's spectrum)
+ *
+ * Chains in series are joined with JoinChains<A, B>. A new preset is a new
+ * type list (see ModeChains.h), not a new filter class.
+ *
+ * Real-Time Safety: ✅
+ * - Designs are plain value computations; nothing here allocates
+ */
+namespace DSP {
+
+/** Where a stage takes its frequency from. */
+enum class StageControl
+{
+    Fixed,      ///< Voicing::frequency
+    LowCut,     ///< The Low Cut parameter
+    HighCut     ///< The High Cut parameter
+};
+
+/** Which side of the passband a stage bounds (see Chain::getPassband()). */
+enum class PassbandEdge
+{
+    None,       ///< Shapes the band without bounding it (e.g. a peak)
+    Lower,      ///< High-pass: the band starts at its frequency
+    Upper       ///< Low-pass: the band ends at its frequency
+};
+
+//==============================================================================
+/** What every stage kind shares: the voicing and how the frequency is chosen. */
+template <typename Voicing>
+struct ChainStage
+{
+    static constexpr StageControl control = Voicing::control;
+
+    /** The stage's frequency for the given cutoffs, kept in 10 Hz .. 0.45 x sampleRate. */
+    template <typename SampleType>
+    static SampleType frequency(double sampleRate, SampleType lowCut, SampleType highCut)
+    {
+        const auto value = control == StageControl::LowCut  ? lowCut
+                         : control == StageControl::HighCut ? highCut
+                                                            : static_cast<SampleType>(Voicing::frequency);
+
+        return std::clamp(value, SampleType(10), static_cast<SampleType>(sampleRate * 0.45));
+    }
+};
+
+/** Second-order high-pass; the voicing supplies frequency and q. */
+template <typename Voicing>
+struct HighPass : ChainStage<Voicing>
+{
+    static constexpr PassbandEdge edge = PassbandEdge::Lower;
+
+    template <typename SampleType>
+    static BiquadCoefficients<SampleType> makeBiquad(double sampleRate, SampleType frequency)
+    {
+        return BiquadCoefficients<SampleType>::makeHighPass(sampleRate, frequency, static_cast<SampleType>(Voicing::q));
+    }
+
+    template <typename SampleType>
+    static StateVariableCoefficients<SampleType> makeStateVariable(double sampleRate, SampleType frequency)
+    {
+        return StateVariableCoefficients<SampleType>::makeHighPass(sampleRate, frequency, static_cast<SampleType>(Voicing::q));
+    }
+};
+
+/** Second-order low-pass; the voicing supplies frequency and q. */
+template <typename Voicing>
+struct LowPass : ChainStage<Voicing>
+{
+    static constexpr PassbandEdge edge = PassbandEdge::Upper;
+
+    template <typename SampleType>
+    static BiquadCoefficients<SampleType> makeBiquad(double sampleRate, SampleType frequency)
+    {
+        return BiquadCoefficients<SampleType>::makeLowPass(sampleRate, frequency, static_cast<SampleType>(Voicing::q));
+    }
+
+    template <typename SampleType>
+    static StateVariableCoefficients<SampleType> makeStateVariable(double sampleRate, SampleType frequency)
+    {
+        return StateVariableCoefficients<SampleType>::makeLowPass(sampleRate, frequency, static_cast<SampleType>(Voicing::q));
+    }
+};
+
+/** Peaking EQ; the voicing supplies frequency, q and the linear gain. */
+template <typename Voicing>
+struct Peak : ChainStage<Voicing>
+{
+    static constexpr PassbandEdge edge = PassbandEdge::None;
+
+    template <typename SampleType>
+    static BiquadCoefficients<SampleType> makeBiquad(double sampleRate, SampleType frequency)
+    {
+        return BiquadCoefficients<SampleType>::makePeak(sampleRate, frequency, static_cast<SampleType>(Voicing::q),
+                                                        static_cast<SampleType>(Voicing::gain));
+    }
+
+    template <typename SampleType>
+    static StateVariableCoefficients<SampleType> makeStateVariable(double sampleRate, SampleType frequency)
+    {
+        return StateVariableCoefficients<SampleType>::makePeak(sampleRate, frequency, static_cast<SampleType>(Voicing::q),
+                                                               static_cast<SampleType>(Voicing::gain));
+    }
+};
+
+//==============================================================================
+template <typename... Stages>
+struct Chain
+{
+    static constexpr int numSections = static_cast<int>(sizeof...(Stages));
+    static_assert(numSections >= 1 && numSections <= BiquadCascade<float>::maxSections,
+                  "A chain runs in one cascade: 1..maxSections stages");
+
+    /** True if any stage follows Low Cut or High Cut. */
+    static constexpr bool isTunable = ((Stages::control != StageControl::Fixed) || ...);
+
+    /** True if a stage follows High Cut, so nothing above it needs the full rate. */
+    static constexpr bool isBandLimited = ((Stages::control == StageControl::HighCut) || ...);
+
+    //==============================================================================
+    template <typename SampleType>
+    static std::array<BiquadCoefficients<SampleType>, numSections> designSections(double sampleRate,
+                                                                                  SampleType lowCut, SampleType highCut)
+    {
+        return {{ Stages::makeBiquad(sampleRate, Stages::frequency(sampleRate, lowCut, highCut))... }};
+    }
+
+    template <typename SampleType>
+    static std::array<StateVariableCoefficients<SampleType>, numSections> designStateVariableSections(
+        double sampleRate, SampleType lowCut, SampleType highCut)
+    {
+        return {{ Stages::makeStateVariable(sampleRate, Stages::frequency(sampleRate, lowCut, highCut))... }};
+    }
+
+    /** Designs every section into a cascade of either topology and sizes its state. */
+    template <typename Cascade, typename SampleType>
+    static void prepare(Cascade& cascade, int maxChannels, double sampleRate, SampleType lowCut, SampleType highCut)
+    {
+        design(cascade, sampleRate, lowCut, highCut);
+        cascade.prepare(maxChannels);
+    }
+
+    /** Designs every section into a cascade, keeping its state (no allocation). */
+    template <typename Cascade, typename SampleType>
+    static void design(Cascade& cascade, double sampleRate, SampleType lowCut, SampleType highCut)
+    {
+        const auto sections = designFor(cascade, sampleRate, lowCut, highCut);
+        cascade.setSections(sections.data(), numSections);
+    }
+
+    /** Redesigns only the Low Cut / High Cut stages, keeping the filter state. */
+    template <typename Cascade, typename SampleType>
+    static void retune(Cascade& cascade, double sampleRate, SampleType lowCut, SampleType highCut)
+    {
+        retuneStages(cascade, sampleRate, lowCut, highCut, std::index_sequence_for<Stages...>());
+    }
+
+    /** Samples the whole chain rings for after its input stops (sum of the section decays). */
+    template <typename SampleType>
+    static double getDecaySamples(double sampleRate, SampleType lowCut, SampleType highCut, double decayDb)
+    {
+        double decaySamples = 0.0;
+        for (const auto& section : designSections(sampleRate, lowCut, highCut))
+            decaySamples += section.getDecaySamples(decayDb);
+
+        return decaySamples;
+    }
+
+    /** The band the chain keeps: highest high-pass to lowest low-pass frequency
+     *  (0 / Nyquist where no stage bounds that side).
+     */
+    template <typename SampleType>
+    static std::pair<SampleType, SampleType> getPassband(double sampleRate, SampleType lowCut, SampleType highCut)
+    {
+        auto lower = SampleType(0);
+        auto upper = static_cast<SampleType>(sampleRate * 0.5);
+
+        const auto bound = [&](PassbandEdge edge, SampleType frequency)
+        {
+            if (edge == PassbandEdge::Lower)
+                lower = std::max(lower, frequency);
+            else if (edge == PassbandEdge::Upper)
+                upper = std::min(upper, frequency);
+        };
+
+        (bound(Stages::edge, Stages::frequency(sampleRate, lowCut, highCut)), ...);
+        return { lower, upper };
+    }
+
+    //==============================================================================
+    /** The cascade kernel for exactly numSections sections (see BiquadCascade::process). */
+    template <typename SampleType>
+    static void process(BiquadCascade<SampleType>& cascade, const SampleType* const* input, SampleType* const* output,
+                        int numChannels, int numSamples, SampleType mix)
+    {
+        cascade.template process<numSections>(input, output, numChannels, numSamples, mix);
+    }
+
+    /** The state-variable kernel for exactly numSections sections, cutoffs scaled per sample. */
+    template <typename SampleType>
+    static void process(StateVariableCascade<SampleType>& cascade, const SampleType* const* input, SampleType* const* output,
+                        int numChannels, int numSamples, SampleType mix, const SampleType* cutoffScale)
+    {
+        cascade.template process<numSections>(input, output, numChannels, numSamples, mix, cutoffScale);
+    }
+
+private:
+    template <typename SampleType>
+    static auto designFor(const BiquadCascade<SampleType>&, double sampleRate, SampleType lowCut, SampleType highCut)
+    {
+        return designSections(sampleRate, lowCut, highCut);
+    }
+
+    template <typename SampleType>
+    static auto designFor(const StateVariableCascade<SampleType>&, double sampleRate, SampleType lowCut, SampleType highCut)
+    {
+        return designStateVariableSections(sampleRate, lowCut, highCut);
+    }
+
+    template <typename Stage, typename SampleType>
+    static auto designStage(const BiquadCascade<SampleType>&, double sampleRate, SampleType frequency)
+    {
+        return Stage::makeBiquad(sampleRate, frequency);
+    }
+
+    template <typename Stage, typename SampleType>
+    static auto designStage(const StateVariableCascade<SampleType>&, double sampleRate, SampleType frequency)
+    {
+        return Stage::makeStateVariable(sampleRate, frequency);
+    }
+
+    template <typename Cascade, typename SampleType, std::size_t... Index>
+    static void retuneStages(Cascade& cascade, double sampleRate, SampleType lowCut, SampleType highCut,
+                             std::index_sequence<Index...>)
+    {
+        (retuneStage<Stages, static_cast<int>(Index)>(cascade, sampleRate, lowCut, highCut), ...);
+    }
+
+    template <typename Stage, int Section, typename Cascade, typename SampleType>
+    static void retuneStage(Cascade& cascade, double sampleRate, SampleType lowCut, SampleType highCut)
+    {
+        if constexpr (Stage::control != StageControl::Fixed)
+            cascade.setCoefficients(Section, designStage<Stage>(cascade, sampleRate,
+                                                                Stage::frequency(sampleRate, lowCut, highCut)));
+    }
+};
+
+//==============================================================================
+template <typename First, typename Second>
+struct JoinedChain;
+
+template <typename... FirstStages, typename... SecondStages>
+struct JoinedChain<Chain<FirstStages...>, Chain<SecondStages...>>
+{
+    using Type = Chain<FirstStages..., SecondStages...>;
+};
+
+/** First's stages followed by Second's, as one chain (one fused pass). */
+template <typename First, typename Second>
+using JoinChains = typename JoinedChain<First, Second>::Type;
+
+//==============================================================================
+/** An ordered set of chains, e.g. one per value of a mode parameter. */
+template <typename... Chains>
+struct ChainList
+{
+    static constexpr int size = static_cast<int>(sizeof...(Chains));
+
+    template <std::size_t Index>
+    using At = std::tuple_element_t<Index, std::tuple<Chains...>>;
+
+    /** std::tuple of Holder<Chain> for every chain, in order (per-chain state). */
+    template <template <typename> class Holder>
+    using Map = std::tuple<Holder<Chains>...>;
+};
+
+template <typename First, typename Second>
+struct JoinedChainList;
+
+template <typename... FirstChains, typename... SecondChains>
+struct JoinedChainList<ChainList<FirstChains...>, ChainList<SecondChains...>>
+{
+    using Type = ChainList<FirstChains..., SecondChains...>;
+};
+
+/** First's chains followed by Second's, as one list. */
+template <typename First, typename Second>
+using JoinChainLists = typename JoinedChainList<First, Second>::Type;
+
+} // namespace DSP
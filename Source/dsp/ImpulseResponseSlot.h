@@ -0,0 +1,228 @@
+#pragma once
+
+#include "PartitionedConvolver.h"
+#include "ModeCrossfade.h"
+#include "SPSCQueue.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+//==============================================================================
+/**
+ * ImpulseResponseSlot - Lock-free hand-over of convolution engines to the audio thread
+ *
+ * The message thread builds a PartitionedConvolver for a new impulse
+ * response (FFTs, allocation) and submit()s it; the audio thread picks it up
+ * at the start of its next block in update() and crossfades from the engine
+ * it was running. Nothing is allocated, freed or locked on the audio thread:
+ *
+ *     submit()  --> pending (one atomic pointer, latest wins)
+ *     update()  <-- takes pending, starts the crossfade
+ *               --> retired queue (SPSCQueue) once the old engine is out
+ *     submit() / releaseRetired() delete the retired engines
+ *
+ * A submission the audio thread never took is replaced (and deleted) by the
+ * next one, so loading files quickly only ever keeps the latest. A new
+ * engine starts from empty history: it runs unheard for a warm-up (the
+ * response length, up to 50 ms) before it is faded in, so a short response
+ * has its full history by then and a long one is already well underway.
+ *
+ * Real-Time Safety: ✅
+ * - update(), process() and reset() allocate and free nothing; submit() and
+ *   releaseRetired() (message thread) do the freeing
+ */
+namespace DSP {
+
+template <typename SampleType>
+class ImpulseResponseSlot
+{
+public:
+    using Engine = PartitionedConvolver<SampleType>;
+
+    ImpulseResponseSlot() = default;
+
+    ~ImpulseResponseSlot()
+    {
+        delete pending.exchange(nullptr, std::memory_order_acquire);
+        delete current;
+        delete incoming;
+        releaseRetired();
+    }
+
+    /** Sizes the crossfade buffer (not real-time safe; engines are kept). */
+    void prepare(double newSampleRate, int maxBlockSize, int numChannels)
+    {
+        sampleRate = newSampleRate;
+        blockSize = std::max(maxBlockSize, 1);
+        scratch.assign(static_cast<size_t>(std::max(numChannels, 1) * blockSize), SampleType(0));
+        scratchChannels.assign(static_cast<size_t>(std::max(numChannels, 1)), nullptr);
+        offsetInput.assign(scratchChannels.size(), nullptr);
+        offsetOutput.assign(scratchChannels.size(), nullptr);
+    }
+
+    //==============================================================================
+    /** Message thread: hands a freshly prepared engine to the audio thread. */
+    void submit(std::unique_ptr<Engine> engine)
+    {
+        releaseRetired();
+
+        // Still waiting from an earlier submit: the audio thread never saw it
+        if (engine != nullptr)
+            delete pending.exchange(engine.release(), std::memory_order_acq_rel);
+    }
+
+    /** Message thread: deletes the engines the audio thread has finished with. */
+    void releaseRetired()
+    {
+        Engine* engine = nullptr;
+        while (retired.pop(engine))
+            delete engine;
+    }
+
+    //==============================================================================
+    /** Audio thread, once per block: adopts a submitted engine.
+     *
+     * While running (the chain is processing this mode) the new engine is
+     * crossfaded in; otherwise it replaces the old one at once. Returns true
+     * if the engine (and with it the response length) changed.
+     */
+    bool update(bool running)
+    {
+        // One change at a time, and only with room to retire the outgoing engine
+        if (incoming != nullptr || pending.load(std::memory_order_relaxed) == nullptr
+            || retired.size() >= retired.capacity())
+            return false;
+
+        auto* engine = pending.exchange(nullptr, std::memory_order_acq_rel);
+        if (engine == nullptr)
+            return false;
+
+        if (running && current != nullptr)
+        {
+            incoming = engine;
+
+            const double warmupSeconds = std::min(incoming->getLength() / sampleRate, maxWarmupSeconds);
+            fade.prepare(sampleRate, warmupSeconds, fadeSeconds);
+            fade.start();
+            return true;
+        }
+
+        retire(current);
+        current = engine;
+        return true;
+    }
+
+    /** Audio thread: convolves with the current engine (crossfading to a new one),
+     *  or copies the input when no response is loaded. Same contract as
+     *  PartitionedConvolver::process().
+     */
+    void process(const SampleType* const* input, SampleType* const* output,
+                 int numChannels, int numSamples, SampleType mix)
+    {
+        if (current == nullptr)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                if (output[ch] != input[ch])
+                    std::copy(input[ch], input[ch] + numSamples, output[ch]);
+            return;
+        }
+
+        if (incoming == nullptr)
+        {
+            current->process(input, output, numChannels, numSamples, mix);
+            return;
+        }
+
+        // Channels beyond the prepared count are left as they are (never the case in DSPChain)
+        numChannels = std::min(numChannels, static_cast<int>(scratchChannels.size()));
+
+        for (int start = 0; start < numSamples;)
+        {
+            const int count = std::min(blockSize, numSamples - start);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                offsetInput[(size_t) ch] = input[ch] + start;
+                offsetOutput[(size_t) ch] = output[ch] + start;
+                scratchChannels[(size_t) ch] = scratch.data() + ch * blockSize;
+            }
+
+            // Incoming first: the output may be the input
+            incoming->process(offsetInput.data(), scratchChannels.data(), numChannels, count, mix);
+            current->process(offsetInput.data(), offsetOutput.data(), numChannels, count, mix);
+            fade.process(offsetOutput.data(), scratchChannels.data(), numChannels, count);
+            start += count;
+
+            if (!fade.isActive())
+            {
+                finishFade();
+
+                if (start < numSamples)
+                {
+                    for (int ch = 0; ch < numChannels; ++ch)
+                    {
+                        offsetInput[(size_t) ch] = input[ch] + start;
+                        offsetOutput[(size_t) ch] = output[ch] + start;
+                    }
+
+                    current->process(offsetInput.data(), offsetOutput.data(), numChannels, numSamples - start, mix);
+                }
+                return;
+            }
+        }
+    }
+
+    /** Audio thread: clears the history, completing any crossfade at once. */
+    void reset()
+    {
+        if (incoming != nullptr)
+            finishFade();
+
+        if (current != nullptr)
+            current->reset();
+    }
+
+    /** Audio thread: length of the response in use (the longer one while fading), 0 if none. */
+    int getLengthInSamples() const
+    {
+        return std::max(current != nullptr ? current->getLength() : 0,
+                        incoming != nullptr ? incoming->getLength() : 0);
+    }
+
+private:
+    void finishFade()
+    {
+        fade.stop();
+        retire(current);
+        current = incoming;
+        incoming = nullptr;
+    }
+
+    /** update() only adopts an engine with room in the queue, so this never drops one. */
+    void retire(Engine* engine)
+    {
+        if (engine != nullptr)
+            retired.push(engine);
+    }
+
+    //==============================================================================
+    static constexpr double maxWarmupSeconds = 0.05;
+    static constexpr double fadeSeconds = 0.02;
+
+    std::atomic<Engine*> pending { nullptr };            ///< Latest submission not yet taken
+    SPSCQueue<Engine*, 4> retired;
+
+    // Audio thread only
+    Engine* current = nullptr;
+    Engine* incoming = nullptr;
+    ModeCrossfade<SampleType> fade;
+    std::vector<SampleType> scratch;                     ///< Incoming engine's output, blockSize per channel
+    std::vector<SampleType*> scratchChannels;
+    std::vector<const SampleType*> offsetInput;
+    std::vector<SampleType*> offsetOutput;
+    double sampleRate = 44100.0;
+    int blockSize = 1;
+};
+
+} // namespace DSP
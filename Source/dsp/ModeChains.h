@@ -0,0 +1,110 @@
+#pragma once
+
+#include "FilterChain.h"
+#include "Codec.h"
+#include "../utils/DSPDefines.h"
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
+//==============================================================================
+/**
+ * ModeChains - The filter chain behind every Mode, as type lists
+ *
+ * Voicings are the fixed numbers of each stage; stages that follow Low Cut /
+ * High Cut use their frequency only as the default. DSPChain builds its
+ * per-mode filters and its per-block dispatch table from ModeChainList, so
+ * adding a mode is one more voicing or two, one Chain<...> alias and one
+ * entry in the list (plus its name in the Mode parameter).
+ *
+ * The codec modes come after the impulse response in DSP::Mode and have a
+ * list of their own (CodecModeChainList): each is a filter chain followed by
+ * a DSP::Codec (CodecChain), which DSPChain runs after that chain's filters.
+ */
+namespace DSP {
+
+namespace Voicing {
+
+/** Telephone high-pass: follows Low Cut, gentle slope. */
+struct TelephoneLowCut
+{
+    static constexpr StageControl control = StageControl::LowCut;
+    static constexpr double frequency = TELEPHONE_LOW_CUT_HZ;
+    static constexpr double q = 1.0;
+};
+
+/** Telephone low-pass: follows High Cut, gentle slope. */
+struct TelephoneHighCut
+{
+    static constexpr StageControl control = StageControl::HighCut;
+    static constexpr double frequency = TELEPHONE_HIGH_CUT_HZ;
+    static constexpr double q = 1.0;
+};
+
+/** Radio rumble filter: 100 Hz, very gentle slope. */
+struct RadioRumble
+{
+    static constexpr StageControl control = StageControl::Fixed;
+    static constexpr double frequency = 100.0;
+    static constexpr double q = 0.7;
+};
+
+/** Radio presence peak: +6 dB (2x) around 3.5 kHz, moderate width. */
+struct RadioPresence
+{
+    static constexpr StageControl control = StageControl::Fixed;
+    static constexpr double frequency = 3500.0;
+    static constexpr double q = 2.0;
+    static constexpr double gain = 2.0;
+};
+
+} // namespace Voicing
+
+//==============================================================================
+/** Narrowband voice: HP (Low Cut) + LP (High Cut). */
+using TelephoneChain = Chain<HighPass<Voicing::TelephoneLowCut>, LowPass<Voicing::TelephoneHighCut>>;
+
+/** Bright voice: HP 100 Hz + 3.5 kHz presence peak. */
+using RadioChain = Chain<HighPass<Voicing::RadioRumble>, Peak<Voicing::RadioPresence>>;
+
+/** Telephone then Radio, fused into one four-section pass. */
+using CustomChain = JoinChains<TelephoneChain, RadioChain>;
+
+/** Indexed by the Mode parameter (see DSP::Mode): the filter modes. */
+using ModeChainList = ChainList<TelephoneChain, RadioChain, CustomChain>;
+
+//==============================================================================
+/** A filter chain, then a codec of the given law (see DSP::Codec).
+ *
+ * The band it reports stops at the codec's Nyquist (4 kHz); everything
+ * else is the chain's own.
+ */
+template <typename Filters, CodecLaw Law>
+struct CodecChain : Filters
+{
+    static constexpr CodecLaw law = Law;
+
+    template <typename SampleType>
+    static std::pair<SampleType, SampleType> getPassband(double sampleRate, SampleType lowCut, SampleType highCut)
+    {
+        auto band = Filters::template getPassband<SampleType>(sampleRate, lowCut, highCut);
+        band.second = std::min(band.second, static_cast<SampleType>(CODEC_SAMPLE_RATE_HZ * 0.5));
+        return band;
+    }
+};
+
+/** True for a CodecChain. */
+template <typename ModeChain, typename = void>
+constexpr bool hasCodec = false;
+
+template <typename ModeChain>
+constexpr bool hasCodec<ModeChain, std::void_t<decltype(ModeChain::law)>> = true;
+
+/** G.711 phone lines: the telephone band, coded at 8 kHz. */
+using MuLawChain = CodecChain<TelephoneChain, CodecLaw::MuLaw>;
+using ALawChain = CodecChain<TelephoneChain, CodecLaw::ALaw>;
+
+/** The codec modes, from DSP::Mode::MuLaw on. */
+using CodecModeChainList = ChainList<MuLawChain, ALawChain>;
+
+} // namespace DSP
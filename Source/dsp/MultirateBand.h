@@ -0,0 +1,503 @@
+#pragma once
+
+#include "SIMDVector.h"
+#include "DesignCache.h"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+//==============================================================================
+/**
+ * HalfBandFilter - Linear-phase half-band FIR for 2x decimation/interpolation
+ *
+ * Kaiser-windowed half-band lowpass: every even-offset tap except the centre
+ * is zero, and the centre tap is 0.5, so a 2x polyphase decimator or
+ * interpolator only multiplies by the (symmetric) odd-offset taps:
+ * (K + 1) multiplies per decimated sample, or per interpolated pair.
+ *
+ * The length is chosen per stage from the passband edge and the stage's
+ * input rate, so early stages (wide transition band) are only a few taps
+ * long and only the last stage before the internal rate needs a steep
+ * response. The tap loops run on SIMDVector over blocks of outputs.
+ *
+ * That search is by far the most expensive part of preparing a chain, so
+ * its result is shared through DesignCache: filters designed for the same
+ * rate and band (every instance of a session) share one set of taps.
+ */
+namespace DSP {
+
+template <typename SampleType>
+class HalfBandFilter
+{
+public:
+    /** Designs the filter.
+     *
+     * @param inputRate      Sample rate before decimation / after interpolation
+     * @param passbandEdgeHz Highest frequency that must pass unaffected
+     * @param attenuationDb  Stopband attenuation target
+     */
+    void design(double inputRate, double passbandEdgeHz, double attenuationDb = 70.0)
+    {
+        shape = Cache::getShared().get({ inputRate, passbandEdgeHz, attenuationDb }, [&]
+        {
+            return search(inputRate, passbandEdgeHz, attenuationDb);
+        });
+    }
+
+    /** Group delay in samples at the filter's (higher) rate. Always odd. */
+    int getCentre() const { return shape != nullptr ? shape->centre : 1; }
+
+    /** Number of input samples of history each phase needs. */
+    int getHistoryLength() const { return 2 * getCentre(); }
+
+    //==============================================================================
+    /** 2:1 decimation. 'x' points at the first new input sample and must be
+     *  preceded by getHistoryLength() samples of history; numInput is even.
+     *  y[m] = sum_k h[k] * x[2m + 1 - k]
+     */
+    void decimate(const SampleType* x, int numInput, SampleType* y) const
+    {
+        const auto& taps = shape->taps;
+        const int K = static_cast<int>(taps.size()) - 1;
+        SampleType odd[tileSize + maxTaps * 2];
+
+        for (int base = 0; base < numInput / 2; base += tileSize)
+        {
+            const int n = std::min(tileSize, numInput / 2 - base);
+
+            // Odd polyphase branch, de-interleaved so the tap loops run unit-stride
+            const auto* first = x + 2 * (base - 2 * K - 1) + 1;
+            for (int i = 0; i < n + 2 * K + 1; ++i)
+                odd[i] = first[2 * i];
+
+            // Even branch has a single non-zero tap: the 0.5 centre
+            for (int i = 0; i < n; ++i)
+                y[base + i] = SampleType(0.5) * x[2 * (base + i - K)];
+
+            accumulate(odd, n, K, y + base);
+        }
+    }
+
+    /** 1:2 interpolation. 'x' points at the first new input sample and must be
+     *  preceded by getHistoryLength() / 2 samples of history.
+     *  Writes 2 * numInput samples to y.
+     */
+    void interpolate(const SampleType* x, int numInput, SampleType* y) const
+    {
+        const auto& taps = shape->taps;
+        const int K = static_cast<int>(taps.size()) - 1;
+        SampleType even[tileSize];
+
+        for (int base = 0; base < numInput; base += tileSize)
+        {
+            const int n = std::min(tileSize, numInput - base);
+
+            std::fill(even, even + n, SampleType(0));
+            accumulate(x + base - 2 * K - 1, n, K, even);
+
+            for (int i = 0; i < n; ++i)
+            {
+                y[2 * (base + i)] = SampleType(2) * even[i];
+                y[2 * (base + i) + 1] = x[base + i - K];
+            }
+        }
+    }
+
+    /** Longest supported filter (odd-offset taps); ample for 90+ dB at the narrowest stage. */
+    static constexpr int maxTaps = 32;
+
+private:
+    static constexpr int tileSize = 64;
+    static constexpr int pointsPerSidelobe = 8;
+    static constexpr double pi = 3.141592653589793238;
+
+    /** One designed filter: the unique taps and the centre they imply. */
+    struct Shape
+    {
+        std::vector<SampleType> taps;  ///< Odd-offset taps, nearest to the centre first
+        int centre = 1;
+    };
+
+    /** Keyed by (input rate, passband edge, attenuation). */
+    using Cache = DesignCache<std::tuple<double, double, double>, Shape>;
+
+    /** acc[i] += sum_j taps[j] * (branch[i + K + 1 + j] + branch[i + K - j]).
+     *  Each output vector stays in a register across all taps.
+     */
+    void accumulate(const SampleType* branch, int n, int K, SampleType* acc) const
+    {
+        const auto& taps = shape->taps;
+        using Vector = SIMDVector<SampleType>;
+        constexpr int width = Vector::size;
+
+        int i = 0;
+        for (; i + width <= n; i += width)
+        {
+            auto sum = Vector::loadUnaligned(acc + i);
+            for (int j = 0; j <= K; ++j)
+                sum = sum + Vector::expand(taps[(size_t) j])
+                                * (Vector::loadUnaligned(branch + i + K + 1 + j) + Vector::loadUnaligned(branch + i + K - j));
+            sum.storeUnaligned(acc + i);
+        }
+
+        for (; i < n; ++i)
+            for (int j = 0; j <= K; ++j)
+                acc[i] += taps[(size_t) j] * (branch[i + K + 1 + j] + branch[i + K - j]);
+    }
+
+    /** The shortest filter (and its best window shape) meeting the attenuation target. */
+    static Shape search(double inputRate, double passbandEdgeHz, double attenuationDb)
+    {
+        const double maxStopbandGain = std::pow(10.0, -attenuationDb / 20.0);
+
+        // Stopband starts at the passband edge mirrored around fs/4. Early stages
+        // have huge transition bands where the Kaiser length/beta formulas are far
+        // too pessimistic, so search for the shortest filter (and its best window
+        // shape) that actually meets the target. Runs in prepare(), not per block.
+        const double stopbandStart = std::min(0.5 - passbandEdgeHz / inputRate, 0.49);
+        Shape result;
+
+        for (int K = 0; K < maxTaps; ++K)
+        {
+            double bestBeta = 0.0, bestGain = 1.0;
+            for (double beta = 0.0; beta <= 14.0; beta += 0.25)
+            {
+                designTaps(result, K, beta);
+                const double gain = stopbandGain(result, stopbandStart);
+                if (gain < bestGain)
+                {
+                    bestGain = gain;
+                    bestBeta = beta;
+                }
+            }
+
+            designTaps(result, K, bestBeta);
+            if (bestGain <= maxStopbandGain)
+                break;
+        }
+
+        return result;
+    }
+
+    /** Kaiser-windowed half-band of length 4K + 3, odd taps normalised to sum to 0.5. */
+    static void designTaps(Shape& result, int K, double beta)
+    {
+        auto& taps = result.taps;
+        result.centre = 2 * K + 1;
+        const int centre = result.centre;
+
+        // Unique odd-offset taps, offsets 1, 3, 5, ... from the centre
+        taps.assign(static_cast<size_t>(K + 1), SampleType(0));
+        double sum = 0.0;
+        for (int j = 0; j <= K; ++j)
+        {
+            const int offset = 2 * j + 1;
+            const double sinc = std::sin(pi * offset * 0.5) / (pi * offset);
+            const double x = static_cast<double>(offset) / (centre + 1);  // 0 at the centre, 1 past the ends
+            const double window = besselI0(beta * std::sqrt(std::max(0.0, 1.0 - x * x))) / besselI0(beta);
+            taps[(size_t) j] = static_cast<SampleType>(sinc * window);
+            sum += 2.0 * sinc * window;
+        }
+
+        // Unity DC gain together with the 0.5 centre tap
+        for (auto& t : taps)
+            t = static_cast<SampleType>(t * (0.5 / sum));
+    }
+
+    /** Worst |H(f)| between 'from' (normalised to the input rate) and Nyquist.
+     *
+     * Sampled at pointsPerSidelobe points per 1 / (4K + 3), the sidelobe
+     * spacing, so the peaks of long (steep) filters are not stepped over.
+     * cos((2j + 1) w) comes from a recurrence, one multiply-add per tap.
+     */
+    static double stopbandGain(const Shape& result, double from)
+    {
+        const auto& taps = result.taps;
+        const auto length = static_cast<double>(4 * taps.size() - 1);
+        const int numPoints = std::max(64, static_cast<int>(std::ceil((0.5 - from) * length * pointsPerSidelobe)));
+        double worst = 0.0;
+
+        for (int i = 0; i <= numPoints; ++i)
+        {
+            const double w = 2.0 * pi * (from + (0.5 - from) * i / numPoints);
+            const double twoCos2w = 2.0 * std::cos(2.0 * w);
+            double previous = std::cos(w), current = std::cos(3.0 * w);  // cos(-w) = cos(w)
+            double h = 0.5 + 2.0 * taps[0] * previous;
+
+            for (size_t j = 1; j < taps.size(); ++j)
+            {
+                h += 2.0 * taps[j] * current;
+                const double next = twoCos2w * current - previous;
+                previous = current;
+                current = next;
+            }
+
+            worst = std::max(worst, std::abs(h));
+        }
+        return worst;
+    }
+
+    static double besselI0(double x)
+    {
+        double sum = 1.0, term = 1.0;
+        for (int k = 1; k < 50 && term > 1.0e-12 * sum; ++k)
+        {
+            term *= (x * 0.5 / k) * (x * 0.5 / k);
+            sum += term;
+        }
+        return sum;
+    }
+
+    std::shared_ptr<const Shape> shape;  ///< Shared with every filter of the same design
+};
+
+//==============================================================================
+/**
+ * MultirateBand - Run a narrowband process at a decimated internal rate
+ *
+ * Decimates by 2 until the internal rate would drop below minInternalRate,
+ * hands the narrowband block to a callback (e.g. a BiquadCascade designed at
+ * getInternalSampleRate()), and interpolates back to the host rate.
+ *
+ * Host blocks of any size are accepted: input is processed in whole groups
+ * of 'factor' samples (leftovers wait for the next block) and the output is
+ * served from a small FIFO primed with factor - 1 samples, which is part of
+ * the constant latency reported by getLatencySamples().
+ *
+ * Real-Time Safety: ✅
+ * - All buffers allocated in prepare(), never in process()
+ */
+template <typename SampleType>
+class MultirateBand
+{
+public:
+    /** Plans the stages and allocates all buffers.
+     *
+     * The band passed through untouched runs up to 0.375 x the internal rate
+     * (about 4.1-4.5 kHz for an 11-12 kHz internal rate); content above that
+     * is removed by the half-band stages.
+     *
+     * @param minInternalRate Lowest acceptable internal sample rate
+     */
+    void prepare(double sampleRate, int maxBlockSize, int numChannelsToUse, double minInternalRate)
+    {
+        numChannels = std::max(numChannelsToUse, 1);
+        maxBlock = std::max(maxBlockSize, 1);
+
+        numStages = 0;
+        while (sampleRate / (1 << (numStages + 1)) >= minInternalRate && numStages < maxStages)
+            ++numStages;
+
+        factor = 1 << numStages;
+        internalRate = sampleRate / factor;
+
+        // Each stage pair delays by 2 * centre - 1 at its own rate; the
+        // output FIFO adds factor - 1, which cancels the -1 terms exactly
+        latency = 0;
+        for (int s = 0; s < numStages; ++s)
+        {
+            stages[s].design(sampleRate / (1 << s), passbandFraction * internalRate);
+            latency += 2 * stages[s].getCentre() * (1 << s);
+        }
+
+        const int maxGroupSamples = maxBlock + factor;
+        channelState.assign(static_cast<size_t>(numChannels), {});
+        for (auto& cs : channelState)
+        {
+            for (int s = 0; s < numStages; ++s)
+            {
+                const int stageInput = maxGroupSamples >> s;
+                cs.decimatorWork[s].assign(static_cast<size_t>(stages[s].getHistoryLength() + stageInput), SampleType(0));
+                cs.interpolatorWork[s].assign(static_cast<size_t>(stages[s].getHistoryLength() / 2 + stageInput / 2 + 1), SampleType(0));
+            }
+            cs.narrow.assign(static_cast<size_t>(maxGroupSamples / factor + 1), SampleType(0));
+            cs.produced.assign(static_cast<size_t>(maxGroupSamples), SampleType(0));
+            cs.pending.assign(static_cast<size_t>(factor), SampleType(0));
+            cs.queue.assign(static_cast<size_t>(2 * factor), SampleType(0));
+        }
+
+        narrowPointers.assign(static_cast<size_t>(numChannels), nullptr);
+        inputChunk.assign(static_cast<size_t>(numChannels), nullptr);
+        outputChunk.assign(static_cast<size_t>(numChannels), nullptr);
+        reset();
+    }
+
+    void reset()
+    {
+        for (auto& cs : channelState)
+        {
+            for (int s = 0; s < numStages; ++s)
+            {
+                std::fill(cs.decimatorWork[s].begin(), cs.decimatorWork[s].end(), SampleType(0));
+                std::fill(cs.interpolatorWork[s].begin(), cs.interpolatorWork[s].end(), SampleType(0));
+            }
+            std::fill(cs.queue.begin(), cs.queue.end(), SampleType(0));
+        }
+
+        numPending = 0;
+        numQueued = factor - 1;  // Primed FIFO (silence) = the grouping latency
+    }
+
+    int getNumStages() const { return numStages; }
+    double getInternalSampleRate() const { return internalRate; }
+
+    /** Constant latency of process() in host samples. */
+    int getLatencySamples() const { return latency; }
+
+    //==============================================================================
+    /** Decimates input, calls narrowband(channels, numChannels, numSamples) at the
+     *  internal rate, and writes the interpolated result to output.
+     *
+     * Each output channel may alias its own input channel. Blocks longer than
+     * the prepared maximum are split, so process() never overruns its buffers.
+     */
+    template <typename NarrowbandProcess>
+    void process(const SampleType* const* input, SampleType* const* output,
+                 int numChannelsToProcess, int numSamples, NarrowbandProcess&& narrowband)
+    {
+        numChannelsToProcess = std::min(numChannelsToProcess, numChannels);
+
+        for (int start = 0; start < numSamples; start += maxBlock)
+        {
+            for (int ch = 0; ch < numChannelsToProcess; ++ch)
+            {
+                inputChunk[(size_t) ch] = input[ch] + start;
+                outputChunk[(size_t) ch] = output[ch] + start;
+            }
+
+            processChunk(inputChunk.data(), outputChunk.data(), numChannelsToProcess,
+                         std::min(maxBlock, numSamples - start), narrowband);
+        }
+    }
+
+private:
+    static constexpr int maxStages = 5;
+    static constexpr double passbandFraction = 0.375;
+
+    template <typename NarrowbandProcess>
+    void processChunk(const SampleType* const* input, SampleType* const* output,
+                      int numChannelsToProcess, int numSamples, NarrowbandProcess& narrowband)
+    {
+        const int available = numPending + numSamples;
+        const int groupSamples = (available / factor) * factor;
+        const int newPending = available - groupSamples;
+        const int numNarrow = groupSamples / factor;
+
+        // 1. Decimate (all channels read before any output is written)
+        for (int ch = 0; ch < numChannelsToProcess; ++ch)
+        {
+            auto& cs = channelState[(size_t) ch];
+            auto& work0 = cs.decimatorWork[0];
+            const int history0 = numStages > 0 ? stages[0].getHistoryLength() : 0;
+
+            // Stage-0 input = pending leftovers + this block
+            auto* in0 = numStages > 0 ? work0.data() + history0 : cs.narrow.data();
+            std::copy(cs.pending.data(), cs.pending.data() + numPending, in0);
+            std::copy(input[ch], input[ch] + numSamples, in0 + numPending);
+
+            const SampleType* stageInput = in0;
+            int stageCount = groupSamples;
+            for (int s = 0; s < numStages; ++s)
+            {
+                const bool last = s == numStages - 1;
+                auto* next = last ? cs.narrow.data()
+                                  : cs.decimatorWork[s + 1].data() + stages[s + 1].getHistoryLength();
+
+                stages[s].decimate(stageInput, stageCount, next);
+
+                // Keep history (and the leftover samples for stage 0) for the next block
+                auto& work = cs.decimatorWork[s];
+                const int history = stages[s].getHistoryLength();
+                if (s == 0)
+                    std::copy(in0 + groupSamples, in0 + available, cs.pending.data());
+                std::copy(work.data() + stageCount, work.data() + stageCount + history, work.data());
+
+                stageInput = next;
+                stageCount /= 2;
+            }
+
+            narrowPointers[(size_t) ch] = cs.narrow.data();
+        }
+
+        numPending = newPending;
+
+        // 2. Narrowband processing at the internal rate
+        if (numNarrow > 0)
+            narrowband(narrowPointers.data(), numChannelsToProcess, numNarrow);
+
+        // 3. Interpolate back up and serve the block from the FIFO
+        const int newQueued = numQueued + groupSamples - numSamples;
+        for (int ch = 0; ch < numChannelsToProcess; ++ch)
+        {
+            auto& cs = channelState[(size_t) ch];
+
+            const SampleType* stageInput = cs.narrow.data();
+            int stageCount = numNarrow;
+            for (int s = numStages - 1; s >= 0; --s)
+            {
+                auto& work = cs.interpolatorWork[s];
+                const int history = stages[s].getHistoryLength() / 2;
+                std::copy(stageInput, stageInput + stageCount, work.data() + history);
+
+                auto* next = s == 0 ? cs.produced.data()
+                                    : cs.interpolatorWork[s - 1].data() + stages[s - 1].getHistoryLength() / 2;
+                stages[s].interpolate(work.data() + history, stageCount, next);
+                std::copy(work.data() + stageCount, work.data() + stageCount + history, work.data());
+
+                stageInput = next;
+                stageCount *= 2;
+            }
+
+            const auto* produced = numStages > 0 ? cs.produced.data() : cs.narrow.data();
+
+            // Output = queued samples followed by the freshly produced ones
+            auto* out = output[ch];
+            const int fromQueue = std::min(numQueued, numSamples);
+            std::copy(cs.queue.data(), cs.queue.data() + fromQueue, out);
+            std::copy(produced, produced + (numSamples - fromQueue), out + fromQueue);
+
+            // Whatever is left becomes the new queue
+            if (fromQueue < numQueued)
+            {
+                std::copy(cs.queue.data() + fromQueue, cs.queue.data() + numQueued, cs.queue.data());
+                std::copy(produced, produced + groupSamples, cs.queue.data() + (numQueued - fromQueue));
+            }
+            else
+            {
+                std::copy(produced + (numSamples - fromQueue), produced + groupSamples, cs.queue.data());
+            }
+        }
+
+        numQueued = newQueued;
+    }
+
+    struct ChannelState
+    {
+        std::vector<SampleType> decimatorWork[maxStages];    ///< history + stage input
+        std::vector<SampleType> interpolatorWork[maxStages]; ///< history + stage input
+        std::vector<SampleType> narrow;    ///< Internal-rate block
+        std::vector<SampleType> produced;  ///< Host-rate output of the last interpolator
+        std::vector<SampleType> pending;   ///< Input samples short of a whole group
+        std::vector<SampleType> queue;     ///< Output FIFO (< 2 * factor samples)
+    };
+
+    HalfBandFilter<SampleType> stages[maxStages];
+    std::vector<ChannelState> channelState;
+    std::vector<SampleType*> narrowPointers;
+    std::vector<const SampleType*> inputChunk;
+    std::vector<SampleType*> outputChunk;
+
+    int numChannels = 1;
+    int maxBlock = 512;
+    int numStages = 0;
+    int factor = 1;
+    double internalRate = 44100.0;
+    int latency = 0;
+
+    int numPending = 0;
+    int numQueued = 0;
+};
+
+} // namespace DSP
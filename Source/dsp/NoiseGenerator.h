@@ -0,0 +1,333 @@
+#pragma once
+
+#include "SIMDVector.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+//==============================================================================
+/**
+ * NoiseGenerator - Radio hiss and vinyl crackle added to a signal
+ *
+ * Hiss: white noise from eight interleaved xorshift32 generators (one per
+ * lane, stepped together, so the compiler turns each step into a few vector
+ * shifts and xors), tilted towards the top end by a two-tap filter
+ * (w[n] - 0.6 w[n-1]: less rumble, more air) and normalised to the level.
+ * No juce::Random, no division or transcendental per sample.
+ *
+ * Crackle: a sparse impulse process. The gap to the next click is drawn
+ * from an exponential distribution (one log per click, ~8 clicks a second),
+ * each click gets a random sign and a heavy-tailed amplitude (u^3, mostly
+ * ticks, now and then a pop), and rings out as a 0.2 ms exponential tail of
+ * the opposite sign so it carries no DC. Between clicks only a decaying
+ * tail (if any) is computed.
+ *
+ * Modes: Off, Hiss, and Vinyl (crackle over hiss 12 dB down). Both
+ * components' gains ramp linearly over 50 ms, so mode and level changes are
+ * click-free and Off is only reached once the ramps are down (isActive()).
+ *
+ * Every channel has its own generators, derived from one seed: reseed()
+ * restarts the exact same noise, whatever the block sizes, so offline
+ * renders are repeatable while two instances with different seeds stay
+ * uncorrelated.
+ *
+ * Real-Time Safety: ✅
+ * - Channel state allocated in prepare(); setMode(), setLevel() and
+ *   process() allocate nothing
+ */
+namespace DSP {
+
+template <typename SampleType>
+class NoiseGenerator
+{
+public:
+    enum Mode : int
+    {
+        Off,
+        Hiss,
+        Vinyl
+    };
+
+    static constexpr double crackleRateHz = 8.0;
+
+    void prepare(double newSampleRate, int numChannelsToUse)
+    {
+        sampleRate = std::max(newSampleRate, 1.0);
+        rampSamples = std::max(1, static_cast<int>(0.05 * sampleRate));
+        clickDecay = static_cast<SampleType>(std::exp(-1.0 / (0.0002 * sampleRate)));
+        clickTailSamples = std::max(1, static_cast<int>(std::ceil(0.0002 * sampleRate * std::log(1.0e6))));  // -120 dB
+        channels.assign(static_cast<size_t>(std::max(numChannelsToUse, 1)), {});
+        reseed(seed);
+    }
+
+    /** Restarts every channel's noise from seed; the gains jump to their targets. */
+    void reseed(std::uint32_t newSeed)
+    {
+        seed = newSeed;
+
+        for (size_t ch = 0; ch < channels.size(); ++ch)
+        {
+            auto& state = channels[ch];
+            std::uint32_t mixer = seed ^ (0x9e3779b9u * static_cast<std::uint32_t>(ch + 1));
+
+            for (auto& lane : state.lanes)
+                lane = nextSeed(mixer);
+
+            state.clickRandom = nextSeed(mixer);
+            state.numBuffered = 0;
+            state.previousWhite = SampleType(0);
+            state.clickTail = SampleType(0);
+            state.tailSamplesLeft = 0;
+            state.samplesUntilClick = drawClickGap(state.clickRandom);
+        }
+
+        hiss.snap();
+        crackle.snap();
+    }
+
+    /** Off, Hiss or Vinyl; the change is ramped. */
+    void setMode(int newMode)
+    {
+        mode = std::clamp(newMode, static_cast<int>(Off), static_cast<int>(Vinyl));
+        updateTargets();
+    }
+
+    /** Hiss level (RMS) in dB full scale; the change is ramped. */
+    void setLevel(float levelDb)
+    {
+        level = static_cast<SampleType>(std::pow(10.0, levelDb / 20.0));
+        updateTargets();
+    }
+
+    /** False once the mode is Off and the gains have ramped down. */
+    bool isActive() const { return hiss.isActive() || crackle.isActive(); }
+
+    //==============================================================================
+    /** Adds the noise to numSamples of each channel. */
+    void process(SampleType* const* output, int numChannelsToProcess, int numSamples)
+    {
+        numChannelsToProcess = std::min(numChannelsToProcess, static_cast<int>(channels.size()));
+        if (!isActive())
+            return;
+
+        for (int ch = 0; ch < numChannelsToProcess; ++ch)
+        {
+            addHiss(channels[(size_t) ch], output[ch], numSamples);
+            addCrackle(channels[(size_t) ch], output[ch], numSamples);
+        }
+
+        hiss.advance(numSamples);
+        crackle.advance(numSamples);
+    }
+
+private:
+    static constexpr int lanes = 8;
+    static constexpr int chunkSize = 64;
+
+    /** Linear gain ramp, evaluated per sample from the block start. */
+    struct Ramp
+    {
+        SampleType current = SampleType(0), target = SampleType(0), step = SampleType(0);
+
+        void setTarget(SampleType newTarget, int rampLength)
+        {
+            target = newTarget;
+            step = (target - current) / static_cast<SampleType>(rampLength);
+        }
+
+        SampleType at(int offset) const
+        {
+            const auto value = current + step * static_cast<SampleType>(offset);
+            return step > 0 ? std::min(value, target) : std::max(value, target);
+        }
+
+        bool isRamping() const { return current != target; }
+        bool isActive() const { return current != SampleType(0) || target != SampleType(0); }
+        void advance(int numSamples) { current = at(numSamples); }
+        void snap() { current = target; }
+    };
+
+    struct ChannelState
+    {
+        std::uint32_t lanes[NoiseGenerator::lanes] = {};
+        SampleType buffered[NoiseGenerator::lanes] = {};  ///< One step's worth, handed out before stepping again
+        int numBuffered = 0;
+        SampleType previousWhite = SampleType(0);         ///< Hiss filter history
+
+        std::uint32_t clickRandom = 1;
+        SampleType clickTail = SampleType(0);             ///< Current tail sample (gain applied)
+        int tailSamplesLeft = 0;
+        int samplesUntilClick = 0;
+    };
+
+    //==============================================================================
+    void updateTargets()
+    {
+        hiss.setTarget(mode == Hiss ? level : mode == Vinyl ? level * SampleType(0.25) : SampleType(0), rampSamples);
+        crackle.setTarget(mode == Vinyl ? level * SampleType(8) : SampleType(0), rampSamples);
+    }
+
+    /** Steps all lanes once; uniform in [-1, 1). */
+    static void stepLanes(std::uint32_t* state, SampleType* white)
+    {
+        constexpr auto scale = static_cast<SampleType>(1.0 / 2147483648.0);
+        for (int lane = 0; lane < lanes; ++lane)
+        {
+            auto x = state[lane];
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            state[lane] = x;
+            white[lane] = static_cast<SampleType>(static_cast<std::int32_t>(x)) * scale;
+        }
+    }
+
+    /** The next numSamples of white noise: whole steps straight into white, any
+     *  remainder through the channel's buffer, so the sequence ignores block sizes.
+     */
+    static void renderWhite(ChannelState& state, SampleType* white, int numSamples)
+    {
+        int n = 0;
+        for (; n < numSamples && state.numBuffered > 0; ++n)
+            white[n] = state.buffered[lanes - state.numBuffered--];
+
+        for (; n + lanes <= numSamples; n += lanes)
+            stepLanes(state.lanes, white + n);
+
+        if (n < numSamples)
+        {
+            stepLanes(state.lanes, state.buffered);
+            state.numBuffered = lanes;
+            for (; n < numSamples; ++n)
+                white[n] = state.buffered[lanes - state.numBuffered--];
+        }
+    }
+
+    void addHiss(ChannelState& state, SampleType* output, int numSamples) const
+    {
+        using Vector = SIMDVector<SampleType>;
+        constexpr int width = Vector::size;
+
+        // Unit RMS after the tilt: 1 / sqrt(1/3 * (1 + 0.6^2))
+        constexpr auto normalise = static_cast<SampleType>(1.4852213144650120);
+        const auto tilt = Vector::expand(SampleType(-0.6));
+
+        SampleType white[chunkSize + 1];
+        SampleType gains[chunkSize];
+
+        for (int start = 0; start < numSamples; start += chunkSize)
+        {
+            const int count = std::min(chunkSize, numSamples - start);
+            white[0] = state.previousWhite;
+            renderWhite(state, white + 1, count);
+            state.previousWhite = white[count];
+
+            if (!hiss.isActive())
+                continue;
+
+            auto* out = output + start;
+            const bool ramping = hiss.isRamping();
+            if (ramping)
+                for (int i = 0; i < count; ++i)
+                    gains[i] = hiss.at(start + i) * normalise;
+
+            const auto steadyGain = Vector::expand(hiss.current * normalise);
+
+            int i = 0;
+            for (; i + width <= count; i += width)
+            {
+                const auto coloured = Vector::loadUnaligned(white + 1 + i) + tilt * Vector::loadUnaligned(white + i);
+                const auto gain = ramping ? Vector::loadUnaligned(gains + i) : steadyGain;
+                (Vector::loadUnaligned(out + i) + coloured * gain).storeUnaligned(out + i);
+            }
+
+            for (; i < count; ++i)
+            {
+                const auto gain = ramping ? gains[i] : hiss.current * normalise;
+                out[i] += (white[i + 1] - SampleType(0.6) * white[i]) * gain;
+            }
+        }
+    }
+
+    void addCrackle(ChannelState& state, SampleType* output, int numSamples) const
+    {
+        for (int n = 0; n < numSamples;)
+        {
+            // Ring out the current tail up to the next click (or the block end)
+            const int end = std::min(numSamples, n + state.samplesUntilClick);
+            state.samplesUntilClick -= end - n;
+
+            // Fixed tail length (not a level threshold), so the result ignores block sizes
+            const int ringCount = std::min(end - n, state.tailSamplesLeft);
+            auto tail = state.clickTail;
+            for (int i = n; i < n + ringCount; ++i)
+            {
+                output[i] += tail;
+                tail *= clickDecay;
+            }
+            state.clickTail = tail;
+            state.tailSamplesLeft -= ringCount;
+
+            n = end;
+            if (n == numSamples)
+                break;
+
+            // A click: random sign, mostly small; the tail takes the DC back out
+            const auto u = uniform(state.clickRandom);
+            const auto sign = (nextRandom(state.clickRandom) & 1u) != 0 ? SampleType(1) : SampleType(-1);
+            const auto amplitude = crackle.at(n) * u * u * u * sign;
+            output[n] += amplitude;
+            state.clickTail = -amplitude * (SampleType(1) - clickDecay);
+            state.tailSamplesLeft = clickTailSamples;
+            state.samplesUntilClick = drawClickGap(state.clickRandom);
+            ++n;
+        }
+    }
+
+    //==============================================================================
+    static std::uint32_t nextRandom(std::uint32_t& x)
+    {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        return x;
+    }
+
+    /** Uniform in (0, 1]. */
+    static SampleType uniform(std::uint32_t& x)
+    {
+        return static_cast<SampleType>((nextRandom(x) >> 8) + 1) * static_cast<SampleType>(1.0 / 16777216.0);
+    }
+
+    /** Samples to the next click: exponential with a mean of sampleRate / crackleRateHz. */
+    int drawClickGap(std::uint32_t& x) const
+    {
+        const double gap = -std::log(static_cast<double>(uniform(x))) * sampleRate / crackleRateHz;
+        return std::clamp(static_cast<int>(gap), 1, 1 << 30);
+    }
+
+    /** A well-mixed non-zero seed per generator (splitmix32 step). */
+    static std::uint32_t nextSeed(std::uint32_t& mixer)
+    {
+        std::uint32_t z = (mixer += 0x9e3779b9u);
+        z = (z ^ (z >> 16)) * 0x85ebca6bu;
+        z = (z ^ (z >> 13)) * 0xc2b2ae35u;
+        z ^= z >> 16;
+        return z != 0 ? z : 1u;
+    }
+
+    //==============================================================================
+    std::vector<ChannelState> channels;
+    Ramp hiss, crackle;
+
+    double sampleRate = 44100.0;
+    int rampSamples = 2205;
+    SampleType clickDecay = SampleType(0.9);
+    int clickTailSamples = 1;
+    SampleType level = SampleType(0);
+    int mode = Off;
+    std::uint32_t seed = 1;
+};
+
+} // namespace DSP
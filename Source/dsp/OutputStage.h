@@ -0,0 +1,403 @@
+#pragma once
+
+#include "BlockDelay.h"
+#include "SIMDVector.h"
+#include "../utils/DSPDefines.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+//==============================================================================
+/**
+ * OutputStage - Output gain and an optional lookahead true-peak limiter
+ *
+ * The gain (OUTPUT_GAIN_MIN_DB to OUTPUT_GAIN_MAX_DB) ramps linearly over
+ * 50 ms. The limiter runs after it and keeps every sample within
+ * LIMITER_CEILING_DB, and the peaks between samples within it too, as far
+ * as a 4x interpolation can see them. It works on the loudest channel, so
+ * the stereo image does not shift:
+ *
+ *     peak      |x| and three interpolated points per sample (12-tap
+ *               polyphase windowed sinc), the largest over all channels
+ *     hold      the largest peak in the last lookahead + 1 samples
+ *               (running max, see below), as a gain: ceiling / peak
+ *     release   the gain rises back over LIMITER_RELEASE_MS, falls at once
+ *     smooth    moving average over the lookahead, so every reduction is
+ *               a ramp that ends exactly when its peak comes out
+ *
+ * The audio is delayed to meet its gain (getLatencySamples(): the lookahead
+ * plus the interpolator's delay) and clamped to the ceiling at the very end,
+ * which only rounding can reach.
+ *
+ * The running max is van Herk / Gil-Werman: the window is cut into blocks
+ * of its own length, and the max over any window is the larger of the
+ * suffix max of the previous block and the prefix max of the current one.
+ * The prefix is one max per sample; the suffixes are one backward pass per
+ * completed block. That is three compares per sample whatever the
+ * lookahead, where a scan would be one per lookahead sample (and a
+ * monotonic deque a data-dependent number). The moving average is a running
+ * sum, recomputed once per lap so it cannot drift. So the limiter costs the
+ * same at any lookahead; the interpolator and the gain are whole
+ * SIMDVectors across samples.
+ *
+ * Real-Time Safety: ✅
+ * - Everything allocated in prepare(); setGain(), setLimiting(), reset()
+ *   and process() allocate nothing
+ * - setLimiting() changes the latency: call it where the host can be told
+ */
+namespace DSP {
+
+template <typename SampleType>
+class OutputStage
+{
+public:
+    static constexpr int interpolatorTaps = 12;                        ///< Per phase
+    static constexpr int interpolatorPhases = 4;
+    static constexpr int interpolatorDelay = interpolatorTaps / 2;     ///< Samples from an input to its peak
+
+    /** Allocates the limiter for numChannels and a lookahead (fixed until the next prepare()). */
+    void prepare(double newSampleRate, int maxBlockSize, int numChannelsToUse,
+                 double lookaheadSeconds = LIMITER_LOOKAHEAD_MS * 0.001)
+    {
+        sampleRate = newSampleRate;
+        numChannels = std::max(numChannelsToUse, 1);
+        maxBlock = std::max(maxBlockSize, 1);
+        lookahead = std::max(1, static_cast<int>(std::lround(lookaheadSeconds * sampleRate)));
+        window = lookahead + 1;
+
+        history.assign(static_cast<size_t>(numChannels * (interpolatorTaps - 1 + maxBlock)), SampleType(0));
+        peaks.assign(static_cast<size_t>(maxBlock), SampleType(0));
+        gains.assign(static_cast<size_t>(maxBlock), SampleType(1));
+        windowBlock.assign(static_cast<size_t>(window), SampleType(0));
+        windowSuffix.assign(static_cast<size_t>(window + 1), SampleType(0));
+        smoothing.assign(static_cast<size_t>(lookahead), SampleType(1));
+        delay.prepare(numChannels, lookahead - 1 + interpolatorDelay);
+        chunkPointers.resize(static_cast<size_t>(numChannels));
+
+        ceiling = static_cast<SampleType>(std::pow(10.0, LIMITER_CEILING_DB / 20.0));
+        release = static_cast<SampleType>(1.0 - std::exp(-1.0 / (LIMITER_RELEASE_MS * 0.001 * sampleRate)));
+        rampLength = std::max(1, static_cast<int>(0.05 * sampleRate));
+        getInterpolator();
+
+        reset();
+    }
+
+    /** Output gain in dB (clamped to the parameter range), ramped over 50 ms. */
+    void setGain(float decibels)
+    {
+        const auto gain = static_cast<SampleType>(
+            std::pow(10.0f, std::clamp(decibels, OUTPUT_GAIN_MIN_DB, OUTPUT_GAIN_MAX_DB) / 20.0f));
+        if (gain == targetGain)
+            return;
+
+        targetGain = gain;
+        gainStep = (targetGain - currentGain) / static_cast<SampleType>(rampLength);
+        rampLeft = rampLength;
+    }
+
+    /** Switches the limiter in or out. Changes getLatencySamples() and clears the limiter. */
+    void setLimiting(bool shouldLimit)
+    {
+        limiting = shouldLimit;
+        resetLimiter();
+    }
+
+    bool isLimiting() const { return limiting; }
+
+    /** Constant delay of process() in samples (0 with the limiter out). */
+    int getLatencySamples() const { return limiting ? lookahead - 1 + interpolatorDelay : 0; }
+
+    /** False only when process() would return the input unchanged (unity gain, no ramp, no limiter). */
+    bool isEngaged() const { return limiting || rampLeft > 0 || currentGain != SampleType(1); }
+
+    /** Jumps to the target gain and clears the limiter. */
+    void reset()
+    {
+        currentGain = targetGain;
+        rampLeft = 0;
+        resetLimiter();
+    }
+
+    //==============================================================================
+    /** Applies the gain, then the limiter, to the channels in place. */
+    void process(SampleType* const* channels, int numChannelsToProcess, int numSamples)
+    {
+        numChannelsToProcess = std::min(numChannelsToProcess, numChannels);
+
+        auto* chunk = chunkPointers.data();
+        for (int start = 0; start < numSamples; start += maxBlock)
+        {
+            const int count = std::min(maxBlock, numSamples - start);
+            for (int ch = 0; ch < numChannelsToProcess; ++ch)
+                chunk[ch] = channels[ch] + start;
+
+            applyGain(chunk, numChannelsToProcess, count);
+
+            if (limiting)
+                limit(chunk, numChannelsToProcess, count);
+        }
+    }
+
+private:
+    //==============================================================================
+    /** The interpolator's fractional phases (1/4, 2/4, 3/4; phase 0 is the sample itself). */
+    struct Interpolator
+    {
+        std::array<std::array<SampleType, interpolatorTaps>, interpolatorPhases - 1> taps {};
+    };
+
+    /** Hann-windowed sinc, each phase normalised to unity gain at DC. Built once, on the first prepare(). */
+    static const Interpolator& getInterpolator()
+    {
+        static const Interpolator interpolator = []
+        {
+            Interpolator result;
+            const double pi = 3.14159265358979323846;
+
+            for (int phase = 1; phase < interpolatorPhases; ++phase)
+            {
+                auto& taps = result.taps[(size_t) (phase - 1)];
+                double sum = 0.0;
+
+                for (int k = 0; k < interpolatorTaps; ++k)
+                {
+                    // Distance from input n - k to the point interpolatorDelay - phase / 4 samples back
+                    const double d = interpolatorDelay - k - static_cast<double>(phase) / interpolatorPhases;
+                    const double window = 0.5 * (1.0 + std::cos(pi * d / interpolatorDelay));
+                    const double tap = std::sin(pi * d) / (pi * d) * window;
+                    taps[(size_t) k] = static_cast<SampleType>(tap);
+                    sum += tap;
+                }
+
+                for (auto& tap : taps)
+                    tap = static_cast<SampleType>(tap / sum);
+            }
+
+            return result;
+        }();
+
+        return interpolator;
+    }
+
+    //==============================================================================
+    void resetLimiter()
+    {
+        std::fill(history.begin(), history.end(), SampleType(0));
+        std::fill(windowBlock.begin(), windowBlock.end(), SampleType(0));
+        std::fill(windowSuffix.begin(), windowSuffix.end(), SampleType(0));
+        std::fill(smoothing.begin(), smoothing.end(), SampleType(1));
+        delay.reset();
+
+        windowPosition = 0;
+        prefixMax = 0;
+        envelope = 1;
+        smoothingPosition = 0;
+        smoothingSum = static_cast<double>(lookahead);
+    }
+
+    /** The output gain, ramping per sample while a change is under way. */
+    void applyGain(SampleType* const* channels, int numChannelsToProcess, int numSamples)
+    {
+        if (rampLeft == 0)
+        {
+            if (currentGain != SampleType(1))
+                for (int ch = 0; ch < numChannelsToProcess; ++ch)
+                    scale(channels[ch], currentGain, numSamples);
+            return;
+        }
+
+        // Per-sample linear ramp; the last step snaps to the target, absorbing the summed rounding of gainStep
+        for (int i = 0; i < numSamples; ++i)
+        {
+            currentGain = rampLeft > 0 ? (--rampLeft == 0 ? targetGain : currentGain + gainStep) : currentGain;
+            gains[(size_t) i] = currentGain;
+        }
+
+        for (int ch = 0; ch < numChannelsToProcess; ++ch)
+            multiply(channels[ch], gains.data(), numSamples);
+    }
+
+    /** Detection, gain and the delayed audio for one chunk (at most maxBlock samples). */
+    void limit(SampleType* const* channels, int numChannelsToProcess, int numSamples)
+    {
+        std::fill(peaks.begin(), peaks.begin() + numSamples, SampleType(0));
+        for (int ch = 0; ch < numChannelsToProcess; ++ch)
+            detectPeaks(channels[ch], history.data() + ch * (interpolatorTaps - 1 + maxBlock), numSamples);
+
+        computeGains(numSamples);
+
+        delay.process(channels, channels, numChannelsToProcess, numSamples);
+        for (int ch = 0; ch < numChannelsToProcess; ++ch)
+        {
+            multiply(channels[ch], gains.data(), numSamples);
+            clamp(channels[ch], numSamples);
+        }
+    }
+
+    /** peaks = max(peaks, |x| and the interpolated points after it), interpolatorDelay samples late. */
+    void detectPeaks(const SampleType* input, SampleType* channelHistory, int numSamples)
+    {
+        using Vector = SIMDVector<SampleType>;
+        constexpr int width = Vector::size;
+        constexpr int newest = interpolatorTaps - 1;
+
+        // The last taps - 1 inputs of the previous chunk stay in front of this one
+        std::copy(input, input + numSamples, channelHistory + newest);
+
+        const auto& taps = getInterpolator().taps;
+        const auto zero = Vector::expand(SampleType(0));
+        SampleType* peak = peaks.data();
+
+        int i = 0;
+        for (; i + width <= numSamples; i += width)
+        {
+            const SampleType* x = channelHistory + newest + i;
+            const auto sample = Vector::loadUnaligned(x - interpolatorDelay);
+            auto largest = Vector::max(Vector::loadUnaligned(peak + i), Vector::max(sample, zero - sample));
+
+            for (const auto& phase : taps)
+            {
+                auto sum = zero;
+                for (int k = 0; k < interpolatorTaps; ++k)
+                    sum = sum + Vector::expand(phase[(size_t) k]) * Vector::loadUnaligned(x - k);
+                largest = Vector::max(largest, Vector::max(sum, zero - sum));
+            }
+
+            largest.storeUnaligned(peak + i);
+        }
+
+        for (; i < numSamples; ++i)
+        {
+            const SampleType* x = channelHistory + newest + i;
+            SampleType largest = std::max(peak[i], std::abs(x[-interpolatorDelay]));
+
+            for (const auto& phase : taps)
+            {
+                SampleType sum = 0;
+                for (int k = 0; k < interpolatorTaps; ++k)
+                    sum += phase[(size_t) k] * x[-k];
+                largest = std::max(largest, std::abs(sum));
+            }
+
+            peak[i] = largest;
+        }
+
+        std::copy(channelHistory + numSamples, channelHistory + numSamples + newest, channelHistory);
+    }
+
+    /** gains = the limiter gain for each peak (hold, release, smooth; see the class notes). */
+    void computeGains(int numSamples)
+    {
+        const double inverseLength = 1.0 / lookahead;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            // Running max over the window: prefix of this block, suffix of the previous one
+            const SampleType value = peaks[(size_t) i];
+            prefixMax = windowPosition == 0 ? value : std::max(prefixMax, value);
+            windowBlock[(size_t) windowPosition] = value;
+            const SampleType held = std::max(prefixMax, windowSuffix[(size_t) windowPosition + 1]);
+
+            if (++windowPosition == window)
+            {
+                for (int j = window - 1; j >= 0; --j)
+                    windowSuffix[(size_t) j] = std::max(windowBlock[(size_t) j], windowSuffix[(size_t) j + 1]);
+                windowPosition = 0;
+            }
+
+            // Falls at once, rises over the release
+            const SampleType target = ceiling / std::max(held, ceiling);
+            envelope = std::min(target, envelope + (target - envelope) * release);
+
+            // Moving average over the lookahead
+            smoothingSum += static_cast<double>(envelope) - static_cast<double>(smoothing[(size_t) smoothingPosition]);
+            smoothing[(size_t) smoothingPosition] = envelope;
+
+            if (++smoothingPosition == lookahead)
+            {
+                smoothingSum = 0.0;
+                for (const SampleType gain : smoothing)
+                    smoothingSum += static_cast<double>(gain);
+                smoothingPosition = 0;
+            }
+
+            gains[(size_t) i] = static_cast<SampleType>(smoothingSum * inverseLength);
+        }
+    }
+
+    //==============================================================================
+    static void scale(SampleType* data, SampleType gain, int numSamples)
+    {
+        using Vector = SIMDVector<SampleType>;
+        constexpr int width = Vector::size;
+        const auto g = Vector::expand(gain);
+
+        int i = 0;
+        for (; i + width <= numSamples; i += width)
+            (Vector::loadUnaligned(data + i) * g).storeUnaligned(data + i);
+
+        for (; i < numSamples; ++i)
+            data[i] *= gain;
+    }
+
+    static void multiply(SampleType* data, const SampleType* gain, int numSamples)
+    {
+        using Vector = SIMDVector<SampleType>;
+        constexpr int width = Vector::size;
+
+        int i = 0;
+        for (; i + width <= numSamples; i += width)
+            (Vector::loadUnaligned(data + i) * Vector::loadUnaligned(gain + i)).storeUnaligned(data + i);
+
+        for (; i < numSamples; ++i)
+            data[i] *= gain[i];
+    }
+
+    void clamp(SampleType* data, int numSamples) const
+    {
+        using Vector = SIMDVector<SampleType>;
+        constexpr int width = Vector::size;
+        const auto high = Vector::expand(ceiling);
+        const auto low = Vector::expand(-ceiling);
+
+        int i = 0;
+        for (; i + width <= numSamples; i += width)
+            Vector::min(Vector::max(Vector::loadUnaligned(data + i), low), high).storeUnaligned(data + i);
+
+        for (; i < numSamples; ++i)
+            data[i] = std::clamp(data[i], -ceiling, ceiling);
+    }
+
+    //==============================================================================
+    // Output gain
+    SampleType currentGain = 1, targetGain = 1, gainStep = 0;
+    int rampLeft = 0;
+    int rampLength = 2205;
+
+    // Limiter
+    std::vector<SampleType> history;         ///< Per channel: taps - 1 previous inputs, then the chunk
+    std::vector<SampleType> peaks;           ///< Largest peak over the channels, per sample of the chunk
+    std::vector<SampleType> gains;           ///< Per-sample gain (the ramp, then the limiter's)
+    std::vector<SampleType> windowBlock;     ///< Running max: the current block of peaks
+    std::vector<SampleType> windowSuffix;    ///< Suffix maxima of the previous block (window + 1, last 0)
+    std::vector<SampleType> smoothing;       ///< Moving average: the last lookahead envelope values
+    BlockDelay<SampleType> delay;            ///< The audio, lookahead - 1 + interpolatorDelay late
+    std::vector<SampleType*> chunkPointers;
+
+    int windowPosition = 0;
+    SampleType prefixMax = 0;
+    SampleType envelope = 1;
+    int smoothingPosition = 0;
+    double smoothingSum = 0.0;
+    bool limiting = false;
+
+    SampleType ceiling = 1, release = 0;
+    double sampleRate = 44100.0;
+    int numChannels = 1;
+    int maxBlock = 512;
+    int lookahead = 1;                       ///< Samples; also the moving average's length
+    int window = 2;                          ///< Running max length: lookahead + 1
+};
+
+} // namespace DSP
@@ -0,0 +1,213 @@
+#pragma once
+
+#include "MultirateBand.h"
+#include <algorithm>
+#include <vector>
+
+//==============================================================================
+/**
+ * Oversampler - Polyphase half-band 2x / 4x oversampling around a process
+ *
+ * The mirror image of MultirateBand: interpolates by 2 per stage up to the
+ * oversampled rate, hands the block to a callback (e.g. a waveshaper, whose
+ * harmonics then have room above the host band instead of aliasing), and
+ * decimates back down. Uses the same HalfBandFilter stages, so each stage is
+ * a polyphase filter (only the odd-offset taps are multiplied) and designs
+ * are shared between instances through DesignCache.
+ *
+ * Stages keep the band up to 20 kHz (or 0.42 x the host rate if lower) and
+ * reject its images by 80 dB. The first stage is the steep one; the second
+ * (4x) has a wide transition band and is only a few taps long.
+ *
+ * Every factor up to maxStages is designed and allocated in prepare(), so
+ * setFactor() is real-time safe. No grouping is needed in this direction (a
+ * block of n samples always becomes n x factor and back), and the latency is
+ * padded by up to factor - 1 samples at the oversampled rate so that it is a
+ * whole number of host samples (see getLatencySamples()).
+ *
+ * Real-Time Safety: ✅
+ * - All buffers allocated in prepare(), never in process()
+ */
+namespace DSP {
+
+template <typename SampleType>
+class Oversampler
+{
+public:
+    static constexpr int maxStages = 2;  ///< Up to 4x
+
+    /** Designs every stage and allocates for blocks of up to maxBlockSize host samples. */
+    void prepare(double sampleRate, int maxBlockSize, int numChannelsToUse)
+    {
+        numChannels = std::max(numChannelsToUse, 1);
+        maxBlock = std::max(maxBlockSize, 1);
+
+        const double passbandEdge = std::min(20000.0, 0.42 * sampleRate);
+        for (int s = 0; s < maxStages; ++s)
+            stages[s].design(sampleRate * (2 << s), passbandEdge, 80.0);
+
+        // Sized for the largest factor, so any factor fits without reallocating
+        channelState.assign(static_cast<size_t>(numChannels), {});
+        for (auto& cs : channelState)
+        {
+            for (int s = 0; s < maxStages; ++s)
+            {
+                const int lowRateSamples = maxBlock << s;
+                cs.upWork[s].assign(static_cast<size_t>(stages[s].getHistoryLength() / 2 + lowRateSamples), SampleType(0));
+                cs.downWork[s].assign(static_cast<size_t>(stages[s].getHistoryLength() + (1 << maxStages)
+                                                          + 2 * lowRateSamples), SampleType(0));
+            }
+        }
+
+        highRatePointers.assign(static_cast<size_t>(numChannels), nullptr);
+        setFactor(factor);
+    }
+
+    /** Selects 1x, 2x or 4x (rounded down to a supported power of two) and clears the state. */
+    void setFactor(int newFactor)
+    {
+        numStages = 0;
+        while ((2 << numStages) <= newFactor && numStages < maxStages)
+            ++numStages;
+
+        factor = 1 << numStages;
+        updateLatency();
+        reset();
+    }
+
+    int getFactor() const { return factor; }
+
+    /** Constant delay of process() in host samples (0 at 1x). */
+    int getLatencySamples() const { return latency; }
+
+    void reset()
+    {
+        for (auto& cs : channelState)
+        {
+            for (int s = 0; s < maxStages; ++s)
+            {
+                std::fill(cs.upWork[s].begin(), cs.upWork[s].end(), SampleType(0));
+                std::fill(cs.downWork[s].begin(), cs.downWork[s].end(), SampleType(0));
+            }
+        }
+    }
+
+    //==============================================================================
+    /** Upsamples the channels, calls highRate(channels, numChannels, numSamples) on
+     *  the oversampled block, and decimates the result back into the channels.
+     *
+     * In place. At 1x the callback runs directly on the channels. Blocks
+     * longer than the prepared maximum are split.
+     */
+    template <typename HighRateProcess>
+    void process(SampleType* const* channels, int numChannelsToProcess, int numSamples, HighRateProcess&& highRate)
+    {
+        numChannelsToProcess = std::min(numChannelsToProcess, numChannels);
+
+        if (numStages == 0)
+        {
+            highRate(channels, numChannelsToProcess, numSamples);
+            return;
+        }
+
+        for (int start = 0; start < numSamples; start += maxBlock)
+            processChunk(channels, start, numChannelsToProcess, std::min(maxBlock, numSamples - start), highRate);
+    }
+
+private:
+    template <typename HighRateProcess>
+    void processChunk(SampleType* const* channels, int offset, int numChannelsToProcess, int numSamples,
+                      HighRateProcess& highRate)
+    {
+        const int top = numStages - 1;
+        const int highRateSamples = numSamples * factor;
+
+        // 1. Interpolate each channel up; the last stage fills the top decimator's input
+        for (int ch = 0; ch < numChannelsToProcess; ++ch)
+        {
+            auto& cs = channelState[(size_t) ch];
+            const auto* input = channels[ch] + offset;
+            std::copy(input, input + numSamples, cs.upWork[0].data() + stages[0].getHistoryLength() / 2);
+            int stageCount = numSamples;
+
+            // Each stage writes straight behind the next stage's history
+            for (int s = 0; s < numStages; ++s)
+            {
+                auto& work = cs.upWork[s];
+                const int history = stages[s].getHistoryLength() / 2;
+
+                auto* next = s == top ? cs.downWork[top].data() + downPrefix(top)
+                                      : cs.upWork[s + 1].data() + stages[s + 1].getHistoryLength() / 2;
+                stages[s].interpolate(work.data() + history, stageCount, next);
+                std::copy(work.data() + stageCount, work.data() + stageCount + history, work.data());
+
+                stageCount *= 2;
+            }
+
+            highRatePointers[(size_t) ch] = cs.downWork[top].data() + downPrefix(top);
+        }
+
+        // 2. The oversampled process, in place
+        highRate(highRatePointers.data(), numChannelsToProcess, highRateSamples);
+
+        // 3. Decimate back down into the channels
+        for (int ch = 0; ch < numChannelsToProcess; ++ch)
+        {
+            auto& cs = channelState[(size_t) ch];
+            int stageCount = highRateSamples;
+
+            for (int s = top; s >= 0; --s)
+            {
+                auto& work = cs.downWork[s];
+                const int history = stages[s].getHistoryLength();
+                const int prefix = downPrefix(s);
+
+                // Reading from 'history' rather than 'prefix' delays this stage by the padding
+                auto* next = s == 0 ? channels[ch] + offset
+                                    : cs.downWork[s - 1].data() + downPrefix(s - 1);
+                stages[s].decimate(work.data() + history, stageCount, next);
+                std::copy(work.data() + stageCount, work.data() + stageCount + prefix, work.data());
+
+                stageCount /= 2;
+            }
+        }
+    }
+
+    /** Samples kept ahead of a decimator's new input: its history plus the padding (top stage only). */
+    int downPrefix(int stage) const
+    {
+        return stages[stage].getHistoryLength() + (stage == numStages - 1 ? padding : 0);
+    }
+
+    /** Each stage pair delays by 2 * centre - 1 samples at its oversampled rate; the
+     *  padding at the top rate rounds the total up to whole host samples.
+     */
+    void updateLatency()
+    {
+        int topRateDelay = 0;
+        for (int s = 0; s < numStages; ++s)
+            topRateDelay += (2 * stages[s].getCentre() - 1) << (numStages - 1 - s);
+
+        padding = (factor - topRateDelay % factor) % factor;
+        latency = (topRateDelay + padding) / factor;
+    }
+
+    struct ChannelState
+    {
+        std::vector<SampleType> upWork[maxStages];    ///< history + stage input (lower rate)
+        std::vector<SampleType> downWork[maxStages];  ///< history + padding + stage input (higher rate)
+    };
+
+    HalfBandFilter<SampleType> stages[maxStages];
+    std::vector<ChannelState> channelState;
+    std::vector<SampleType*> highRatePointers;
+
+    int numChannels = 1;
+    int maxBlock = 512;
+    int numStages = 0;
+    int factor = 1;
+    int padding = 0;
+    int latency = 0;
+};
+
+} // namespace DSP
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "../utils/DSPDefines.h"
+#include <cstdint>
+
+//==============================================================================
+/**
+ * ParameterSnapshot - Typed copy of every plugin parameter for one block
+ *
+ * Plain value type handed from the processor to DSPChain once per block.
+ * Besides the values it carries one dirty bit per parameter (set when the
+ * value changed since the previous snapshot), so the chain can skip
+ * retargeting ramps and modulators for everything that did not move.
+ *
+ * The Index order is also the bit order; parameterIds gives the APVTS ID
+ * of each index (see ParameterCache, which fills snapshots in).
+ *
+ * Real-Time Safety: ✅
+ * - Trivially copyable, no allocation
+ */
+namespace DSP {
+
+struct ParameterSnapshot
+{
+    enum Index : int
+    {
+        Mode,
+        Mix,
+        LowCut,
+        HighCut,
+        Drift,
+        DriftRate,
+        Enabled,
+        Multirate,
+        ForceMono,
+        Saturation,
+        SaturationOversampling,
+        NoiseMode,
+        NoiseLevel,
+        CodecBits,
+        PacketLoss,
+        OutputGain,
+        Limiter,
+        NumParameters
+    };
+
+    static constexpr const char* parameterIds[NumParameters] = {
+        "mode", "mix", "lowCut", "highCut", "drift", "driftRate", "enabled", "multirate", "forceMono",
+        "saturation", "saturationOversampling", "noiseMode", "noiseLevel", "codecBits", "packetLoss",
+        "outputGain", "limiter"
+    };
+
+    static constexpr std::uint32_t allDirty = (1u << NumParameters) - 1u;
+
+    //==============================================================================
+    int mode = 0;                              ///< 0 = Telephone, 1 = Radio, 2 = Custom, 3 = IR, 4 = mu-law, 5 = A-law
+    float mix = 1.0f;
+    float lowCut = TELEPHONE_LOW_CUT_HZ;
+    float highCut = TELEPHONE_HIGH_CUT_HZ;
+    float drift = 0.0f;
+    float driftRate = 0.5f;
+    bool enabled = true;
+    bool multirate = false;
+    bool forceMono = false;
+    float saturation = 0.0f;
+    int saturationOversampling = 1;            ///< Factor: 1, 2 or 4 (the parameter is its choice index)
+    int noiseMode = 0;                         ///< 0 = Off, 1 = Hiss, 2 = Vinyl
+    float noiseLevel = NOISE_DEFAULT_LEVEL_DB;
+    int codecBits = 8;                         ///< 2..8 (the parameter is its choice index: 8 bit first)
+    float packetLoss = 0.0f;                   ///< Percent of packets lost
+    float outputGain = 0.0f;                   ///< dB
+    bool limiter = false;
+
+    std::uint32_t dirty = allDirty;            ///< One bit per Index: changed since the last snapshot
+
+    //==============================================================================
+    static constexpr std::uint32_t bit(Index index) { return 1u << index; }
+
+    bool isDirty(Index index) const { return (dirty & bit(index)) != 0; }
+
+    /** True if any of the given bits (e.g. bit(LowCut) | bit(HighCut)) is dirty. */
+    bool isAnyDirty(std::uint32_t bits) const { return (dirty & bits) != 0; }
+
+    /** Stores a raw (denormalised) parameter value in its typed field. */
+    void setValue(Index index, float value)
+    {
+        switch (index)
+        {
+            case Mode:      mode = static_cast<int>(value); break;
+            case Mix:       mix = value; break;
+            case LowCut:    lowCut = value; break;
+            case HighCut:   highCut = value; break;
+            case Drift:     drift = value; break;
+            case DriftRate: driftRate = value; break;
+            case Enabled:   enabled = value >= 0.5f; break;
+            case Multirate: multirate = value >= 0.5f; break;
+            case ForceMono: forceMono = value >= 0.5f; break;
+            case Saturation: saturation = value; break;
+            case SaturationOversampling: saturationOversampling = 1 << static_cast<int>(value); break;
+            case NoiseMode: noiseMode = static_cast<int>(value); break;
+            case NoiseLevel: noiseLevel = value; break;
+            case CodecBits: codecBits = 8 - static_cast<int>(value); break;
+            case PacketLoss: packetLoss = value; break;
+            case OutputGain: outputGain = value; break;
+            case Limiter: limiter = value >= 0.5f; break;
+            case NumParameters: break;
+        }
+    }
+};
+
+} // namespace DSP
@@ -0,0 +1,414 @@
+#pragma once
+
+#include "RealFFT.h"
+#include "SIMDVector.h"
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+//==============================================================================
+/**
+ * PartitionedConvolver - Zero-latency non-uniform partitioned convolution
+ *
+ * Convolves every channel with one (mono) impulse response, split into
+ * pieces that grow with their distance from the start:
+ *
+ *     taps  [0, B)          head: direct-form FIR, per sample
+ *           [B, rB)         level 0: FFT partitions of B samples
+ *           [rB, r²B)       level 1: partitions of rB samples
+ *           ...             the last level takes whatever is left
+ *
+ * B is the head size and r the level ratio (1: a single uniform level).
+ * Each level is a uniformly partitioned overlap-save convolver whose first
+ * partition starts one of its blocks into the response, so its output for
+ * a block is due exactly when that block of input is complete: nothing in
+ * the chain waits for a block to fill, and the latency is zero whatever B
+ * is. The head costs B multiply-adds per sample; the levels cost a few
+ * FFTs per block and one complex multiply-add per partition and bin.
+ *
+ * The larger the level, the fewer partitions per second of response, so a
+ * long response costs O(log length) levels instead of thousands of small
+ * partitions. A level's spectral multiply-adds for every partition but the
+ * first only need older input, so they are spread over its block (a share
+ * at every head block) instead of landing in the one callback where the
+ * block completes; that callback only does the FFTs and the first
+ * partition. Spectra are split real/imaginary and padded to whole
+ * SIMDVectors, so those multiply-adds and the head FIR run on vectors.
+ *
+ * The response is transformed once, in prepare(), which is also where all
+ * channel state is allocated: build it off the audio thread (see
+ * ImpulseResponseSlot for the hand-over).
+ *
+ * Real-Time Safety: ✅
+ * - process() and reset() allocate nothing; prepare() allocates everything
+ */
+namespace DSP {
+
+template <typename SampleType>
+class PartitionedConvolver
+{
+public:
+    static constexpr int defaultHeadSize = 64;
+    static constexpr int defaultLevelRatio = 8;
+    static constexpr int maxLevelBlockSize = 8192;   ///< Caps the FFT size (and the work in one callback)
+
+    /** Transforms the impulse response and allocates state for numChannels channels.
+     *
+     * headSize and levelRatio are rounded up to powers of two (headSize 8 to
+     * 1024); a levelRatio of 1 makes every partition headSize long.
+     * Not real-time safe.
+     */
+    void prepare(const float* impulse, int impulseLength, int numChannelsToUse,
+                 int headSize = defaultHeadSize, int levelRatio = defaultLevelRatio)
+    {
+        length = std::max(impulseLength, 0);
+        headLength = nextPowerOfTwo(std::clamp(headSize, 8, 1024));
+        ratio = nextPowerOfTwo(std::max(levelRatio, 1));
+
+        // Head taps, reversed, so the FIR reads the window forwards
+        headTaps.assign(static_cast<size_t>(headLength), SampleType(0));
+        for (int k = 0; k < std::min(headLength, length); ++k)
+            headTaps[(size_t) (headLength - 1 - k)] = static_cast<SampleType>(impulse[k]);
+
+        planLevels(impulse);
+
+        const int numChannels = std::max(numChannelsToUse, 1);
+        channels.assign(static_cast<size_t>(numChannels), {});
+        for (auto& state : channels)
+        {
+            state.headWindow.assign(static_cast<size_t>(2 * headLength), SampleType(0));
+            state.levels.resize(levels.size());
+
+            for (size_t l = 0; l < levels.size(); ++l)
+            {
+                const auto& level = levels[l];
+                auto& levelState = state.levels[l];
+                const auto spectrumSize = static_cast<size_t>(level.numPartitions * level.stride);
+
+                levelState.window.assign(static_cast<size_t>(2 * level.blockSize), SampleType(0));
+                levelState.fdlRe.assign(spectrumSize, SampleType(0));
+                levelState.fdlIm.assign(spectrumSize, SampleType(0));
+                levelState.accRe.assign(static_cast<size_t>(level.stride), SampleType(0));
+                levelState.accIm.assign(static_cast<size_t>(level.stride), SampleType(0));
+                levelState.output.assign(static_cast<size_t>(level.blockSize), SampleType(0));
+            }
+        }
+
+        const int largestBlock = levels.empty() ? headLength : levels.back().blockSize;
+        period = largestBlock;
+        timeScratch.assign(static_cast<size_t>(2 * largestBlock), SampleType(0));
+        headOutput.assign(static_cast<size_t>(headLength), SampleType(0));
+
+        reset();
+    }
+
+    /** Impulse response length in samples (how long the output rings). */
+    int getLength() const { return length; }
+
+    int getHeadSize() const { return headLength; }
+    int getNumLevels() const { return static_cast<int>(levels.size()); }
+    int getNumChannels() const { return static_cast<int>(channels.size()); }
+
+    /** FFT partitions over all levels. */
+    int getNumPartitions() const
+    {
+        int total = 0;
+        for (const auto& level : levels)
+            total += level.numPartitions;
+        return total;
+    }
+
+    /** Clears every channel's history (the response itself is kept). */
+    void reset()
+    {
+        for (auto& state : channels)
+        {
+            std::fill(state.headWindow.begin(), state.headWindow.end(), SampleType(0));
+
+            for (auto& levelState : state.levels)
+            {
+                std::fill(levelState.window.begin(), levelState.window.end(), SampleType(0));
+                std::fill(levelState.fdlRe.begin(), levelState.fdlRe.end(), SampleType(0));
+                std::fill(levelState.fdlIm.begin(), levelState.fdlIm.end(), SampleType(0));
+                std::fill(levelState.accRe.begin(), levelState.accRe.end(), SampleType(0));
+                std::fill(levelState.accIm.begin(), levelState.accIm.end(), SampleType(0));
+                std::fill(levelState.output.begin(), levelState.output.end(), SampleType(0));
+                levelState.newest = 0;
+            }
+        }
+
+        position = 0;
+    }
+
+    //==============================================================================
+    /** Convolves the input and blends: output = dry * (1 - mix) + wet * mix.
+     *
+     * input and output may be the same channels. Channels beyond the
+     * prepared count are passed through dry.
+     */
+    void process(const SampleType* const* input, SampleType* const* output,
+                 int numChannels, int numSamples, SampleType mix)
+    {
+        const int numConvolved = std::min(numChannels, static_cast<int>(channels.size()));
+
+        for (int ch = numConvolved; ch < numChannels; ++ch)
+            if (output[ch] != input[ch])
+                std::copy(input[ch], input[ch] + numSamples, output[ch]);
+
+        for (int start = 0; start < numSamples;)
+        {
+            const int offset = position % headLength;
+            const int count = std::min(numSamples - start, headLength - offset);
+
+            for (int ch = 0; ch < numConvolved; ++ch)
+                processChunk(channels[(size_t) ch], input[ch] + start, output[ch] + start, offset, count, mix);
+
+            position += count;
+            start += count;
+
+            if (position % headLength == 0)
+                completeHeadBlock(numConvolved);
+
+            if (position == period)
+                position = 0;
+        }
+    }
+
+private:
+    /** One level: a uniformly partitioned convolver, shared by every channel. */
+    struct Level
+    {
+        int blockSize = 0;                           ///< Partition length (and its offset into the response)
+        int numPartitions = 0;
+        int stride = 0;                              ///< Bins per spectrum, padded to whole vectors
+        int shareSize = 0;                           ///< Partitions accumulated per head block
+        RealFFT<SampleType> fft;                     ///< 2 x blockSize
+        std::vector<SampleType> kernelRe, kernelIm;  ///< numPartitions spectra, scaled for the inverse
+    };
+
+    struct LevelState
+    {
+        std::vector<SampleType> window;              ///< Previous block | current block (overlap-save input)
+        std::vector<SampleType> fdlRe, fdlIm;        ///< Input spectra, a ring of numPartitions
+        std::vector<SampleType> accRe, accIm;        ///< Next block's output spectrum, being accumulated
+        std::vector<SampleType> output;              ///< This block's output
+        int newest = 0;                              ///< Ring slot of the latest spectrum
+    };
+
+    struct ChannelState
+    {
+        std::vector<SampleType> headWindow;          ///< Previous head block | current head block
+        std::vector<LevelState> levels;
+    };
+
+    //==============================================================================
+    /** Splits the response after the head into levels and transforms every partition. */
+    void planLevels(const float* impulse)
+    {
+        using Vector = SIMDVector<SampleType>;
+
+        levels.clear();
+        int blockSize = headLength;
+
+        while (blockSize < length)
+        {
+            // Each level covers [blockSize, next) unless it is the last one
+            const int next = blockSize * ratio;
+            const bool last = ratio == 1 || next > maxLevelBlockSize || length <= 2 * next;
+            const int end = last ? length : next;
+
+            levels.emplace_back();
+            auto& level = levels.back();
+            level.blockSize = blockSize;
+            level.numPartitions = (end - blockSize + blockSize - 1) / blockSize;
+            level.stride = (blockSize + 1 + Vector::size - 1) / Vector::size * Vector::size;
+
+            const int subBlocks = blockSize / headLength;
+            level.shareSize = (level.numPartitions - 1 + subBlocks - 1) / subBlocks;
+
+            int order = 0;
+            while ((1 << order) < 2 * blockSize)
+                ++order;
+            level.fft.prepare(order);
+
+            const auto spectrumSize = static_cast<size_t>(level.numPartitions * level.stride);
+            level.kernelRe.assign(spectrumSize, SampleType(0));
+            level.kernelIm.assign(spectrumSize, SampleType(0));
+
+            // Partition q: taps [blockSize (q + 1), blockSize (q + 2)), zero-padded to 2 x blockSize
+            std::vector<SampleType> padded(static_cast<size_t>(2 * blockSize));
+            const auto scale = SampleType(1) / static_cast<SampleType>(blockSize);  // inverse() returns blockSize x
+
+            for (int q = 0; q < level.numPartitions; ++q)
+            {
+                std::fill(padded.begin(), padded.end(), SampleType(0));
+                const int first = blockSize * (q + 1);
+                for (int k = 0; k < std::min(blockSize, length - first); ++k)
+                    padded[(size_t) k] = static_cast<SampleType>(impulse[first + k]) * scale;
+
+                level.fft.forward(padded.data(), level.kernelRe.data() + q * level.stride,
+                                  level.kernelIm.data() + q * level.stride);
+            }
+
+            if (last)
+                break;
+
+            blockSize = next;
+        }
+    }
+
+    //==============================================================================
+    /** count samples of one channel within the current head block, starting at offset. */
+    void processChunk(ChannelState& state, const SampleType* input, SampleType* output,
+                      int offset, int count, SampleType mix)
+    {
+        using Vector = SIMDVector<SampleType>;
+        constexpr int width = Vector::size;
+
+        // Input into the head window and every level's window (before output is written: it may alias)
+        SampleType* current = state.headWindow.data() + headLength + offset;
+        std::copy(input, input + count, current);
+
+        for (size_t l = 0; l < levels.size(); ++l)
+        {
+            const int blockSize = levels[l].blockSize;
+            std::copy(current, current + count, state.levels[l].window.data() + blockSize + position % blockSize);
+        }
+
+        // Head: y[i] = sum over m of reversed tap m times window[offset + i + 1 + m]
+        SampleType* wet = headOutput.data();
+        std::fill(wet, wet + count, SampleType(0));
+        const SampleType* window = state.headWindow.data() + offset + 1;
+
+        for (int m = 0; m < headLength; ++m)
+        {
+            const SampleType tap = headTaps[(size_t) m];
+            const auto tapVector = Vector::expand(tap);
+            const SampleType* x = window + m;
+
+            int i = 0;
+            for (; i + width <= count; i += width)
+                (Vector::loadUnaligned(wet + i) + tapVector * Vector::loadUnaligned(x + i)).storeUnaligned(wet + i);
+
+            for (; i < count; ++i)
+                wet[i] += tap * x[i];
+        }
+
+        // Levels: their output for this stretch was computed when the previous block completed
+        for (size_t l = 0; l < levels.size(); ++l)
+        {
+            const SampleType* levelOutput = state.levels[l].output.data() + position % levels[l].blockSize;
+            for (int i = 0; i < count; ++i)
+                wet[i] += levelOutput[i];
+        }
+
+        if (mix >= SampleType(1))
+        {
+            std::copy(wet, wet + count, output);
+            return;
+        }
+
+        for (int i = 0; i < count; ++i)
+            output[i] = current[i] + mix * (wet[i] - current[i]);
+    }
+
+    /** A head block is complete: slide the head window and advance every level. */
+    void completeHeadBlock(int numChannels)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto& window = channels[(size_t) ch].headWindow;
+            std::copy(window.begin() + headLength, window.end(), window.begin());
+        }
+
+        for (size_t l = 0; l < levels.size(); ++l)
+        {
+            const auto& level = levels[l];
+            const int subBlocks = level.blockSize / headLength;
+            const int done = (position % level.blockSize) / headLength;   // 0: the level's block is complete
+            const int share = done == 0 ? subBlocks : done;
+
+            const int firstPartition = 1 + (share - 1) * level.shareSize;
+            const int endPartition = std::min(level.numPartitions, 1 + share * level.shareSize);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                auto& levelState = channels[(size_t) ch].levels[l];
+
+                // Partitions 1.. only need spectra from before this block
+                for (int q = firstPartition; q < endPartition; ++q)
+                {
+                    const int slot = (levelState.newest - (q - 1) + level.numPartitions) % level.numPartitions;
+                    multiplyAdd(levelState.fdlRe.data() + slot * level.stride, levelState.fdlIm.data() + slot * level.stride,
+                                level.kernelRe.data() + q * level.stride, level.kernelIm.data() + q * level.stride,
+                                levelState.accRe.data(), levelState.accIm.data(), level.stride);
+                }
+
+                if (done == 0)
+                    completeLevelBlock(levels[l], levelState);
+            }
+        }
+    }
+
+    /** The level's block is complete: transform it, add partition 0 and produce the next block's output. */
+    void completeLevelBlock(Level& level, LevelState& state)
+    {
+        const int blockSize = level.blockSize;
+
+        state.newest = (state.newest + 1) % level.numPartitions;
+        SampleType* newestRe = state.fdlRe.data() + state.newest * level.stride;
+        SampleType* newestIm = state.fdlIm.data() + state.newest * level.stride;
+        level.fft.forward(state.window.data(), newestRe, newestIm);
+
+        multiplyAdd(newestRe, newestIm, level.kernelRe.data(), level.kernelIm.data(),
+                    state.accRe.data(), state.accIm.data(), level.stride);
+
+        // Overlap-save: the second half is the valid part
+        level.fft.inverse(state.accRe.data(), state.accIm.data(), timeScratch.data());
+        std::copy(timeScratch.begin() + blockSize, timeScratch.begin() + 2 * blockSize, state.output.begin());
+
+        std::fill(state.accRe.begin(), state.accRe.end(), SampleType(0));
+        std::fill(state.accIm.begin(), state.accIm.end(), SampleType(0));
+        std::copy(state.window.begin() + blockSize, state.window.end(), state.window.begin());
+    }
+
+    /** acc += x * h over count bins (a whole number of vectors). */
+    static void multiplyAdd(const SampleType* xRe, const SampleType* xIm, const SampleType* hRe, const SampleType* hIm,
+                            SampleType* accRe, SampleType* accIm, int count)
+    {
+        using Vector = SIMDVector<SampleType>;
+
+        for (int k = 0; k < count; k += Vector::size)
+        {
+            const auto xr = Vector::loadUnaligned(xRe + k), xi = Vector::loadUnaligned(xIm + k);
+            const auto hr = Vector::loadUnaligned(hRe + k), hi = Vector::loadUnaligned(hIm + k);
+
+            (Vector::loadUnaligned(accRe + k) + xr * hr - xi * hi).storeUnaligned(accRe + k);
+            (Vector::loadUnaligned(accIm + k) + xr * hi + xi * hr).storeUnaligned(accIm + k);
+        }
+    }
+
+    static int nextPowerOfTwo(int value)
+    {
+        int power = 1;
+        while (power < value)
+            power *= 2;
+        return power;
+    }
+
+    //==============================================================================
+    std::vector<Level> levels;
+    std::vector<SampleType> headTaps;                ///< Reversed
+    std::vector<ChannelState> channels;
+
+    std::vector<SampleType> timeScratch;
+    std::vector<SampleType> headOutput;              ///< Wet signal of the current chunk
+
+    int length = 0;
+    int headLength = defaultHeadSize;
+    int ratio = defaultLevelRatio;
+    int position = 0;                                ///< Samples into the largest block
+    int period = defaultHeadSize;
+};
+
+} // namespace DSP
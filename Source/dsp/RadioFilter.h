@@ -2,6 +2,8 @@
 
 #include <juce_dsp/juce_dsp.h>
 #include <juce_audio_basics/juce_audio_basics.h>
+#include "ModeChains.h"
+#include <array>
 
 //==============================================================================
 /**
@@ -28,14 +30,41 @@
  * Real-Time Safety: ✅
  * - No allocations in process()
  * - All filter state pre-allocated in prepare()
- * - Thread-safe via JUCE DSP module
+ * - Both sections fused into one pass, channels in SIMD lanes (BiquadCascade)
+ * - Stages declared as a type list (DSP::RadioChain, see ModeChains.h)
+ * 
+ * Templated on the sample type (float or double), as are the section designs.
  */
+template <typename SampleType>
 class RadioFilter
 {
 public:
     RadioFilter() = default;
     ~RadioFilter() = default;
 
+    //==============================================================================
+    /** Stage list of this filter (and of DSPChain's Radio mode); fixed, no cutoff parameters. */
+    using Stages = DSP::RadioChain;
+
+    /** Designs the two sections (high-pass, then presence peak) for a sample rate.
+     * 
+     * The same designs DSPChain fuses into its own cascades.
+     */
+    static std::array<DSP::BiquadCoefficients<SampleType>, 2> designSections(double sampleRate)
+    {
+        return Stages::designSections(sampleRate, SampleType(0), SampleType(0));
+    }
+
+    /** The same two sections as state-variable (TPT) filters.
+     * 
+     * Used by DSPChain when tuning drift is on: the SVF topology can have its
+     * cutoffs modulated every sample (see DSP::StateVariableCascade).
+     */
+    static std::array<DSP::StateVariableCoefficients<SampleType>, 2> designStateVariableSections(double sampleRate)
+    {
+        return Stages::designStateVariableSections(sampleRate, SampleType(0), SampleType(0));
+    }
+
     //==============================================================================
     /** Initializes filters for the given audio specification.
      * 
@@ -47,49 +76,45 @@ public:
     void prepare(const juce::dsp::ProcessSpec& spec)
     {
         currentSampleRate = spec.sampleRate;
-        
-        // Create high-pass filter at 100 Hz (remove rumble)
-        auto highPassCoeffs = juce::dsp::IIR::Coefficients<float>::makeHighPass(
-            spec.sampleRate, 
-            100.0f,   // 100 Hz cutoff (gentle rumble removal)
-            0.7f      // Q = 0.7 (very gentle slope)
-        );
-        highPassFilter.coefficients = highPassCoeffs;
-        highPassFilter.prepare(spec);
 
-        // Create peaking filter for presence boost around 3.5 kHz
-        auto peakingCoeffs = juce::dsp::IIR::Coefficients<float>::makePeakFilter(
-            spec.sampleRate,
-            3500.0f,  // Centre frequency at 3.5 kHz (presence peak)
-            2.0f,     // Q = 2.0 (moderate width for presence)
-            2.0f      // Gain = 2.0x (+6dB boost in amplitude)
-        );
-        peakingFilter.coefficients = peakingCoeffs;
-        peakingFilter.prepare(spec);
+        Stages::prepare(cascade, static_cast<int>(spec.numChannels), spec.sampleRate, SampleType(0), SampleType(0));
     }
 
     //==============================================================================
     /** Processes an audio buffer through both filters.
      * 
      * Applies the high-pass filter first (remove rumble),
-     * then the presence peak filter (add clarity and brightness),
+     * then the presence peak filter (add clarity and brightness), fused per sample,
      * creating the characteristic bright "radio voice" effect.
      * 
      * Real-Time Safe: No allocations, only reads/writes to pre-allocated state.
      * 
      * @param buffer The audio buffer to process in-place
      */
-    void process(juce::AudioBuffer<float>& buffer)
+    void process(juce::AudioBuffer<SampleType>& buffer)
+    {
+        process(buffer, buffer);
+    }
+
+    /** Out-of-place processing (ProcessContextNonReplacing-style).
+     * 
+     * Reads the input and writes the filtered signal straight into output,
+     * leaving the input untouched, so callers that need both the dry and the
+     * wet signal do not have to copy the input first.
+     * 
+     * Real-Time Safe: No allocations, only reads/writes to pre-allocated state.
+     * 
+     * @param input  Source audio (not modified)
+     * @param output Destination for the wet signal (same size as input)
+     */
+    void process(const juce::AudioBuffer<SampleType>& input, juce::AudioBuffer<SampleType>& output)
     {
-        // Convert AudioBuffer to AudioBlock for DSP processing
-        juce::dsp::AudioBlock<float> audioBlock(buffer);
-        juce::dsp::ProcessContextReplacing<float> context(audioBlock);
-        
-        // Apply high-pass filter first (removes low rumble and noise)
-        highPassFilter.process(context);
+        jassert(input.getNumChannels() == output.getNumChannels());
+        jassert(input.getNumSamples() == output.getNumSamples());
 
-        // Apply presence peak filter second (adds brightness/clarity)
-        peakingFilter.process(context);
+        Stages::process(cascade, input.getArrayOfReadPointers(), output.getArrayOfWritePointers(),
+                        juce::jmin(input.getNumChannels(), output.getNumChannels()),
+                        juce::jmin(input.getNumSamples(), output.getNumSamples()), SampleType(1));
     }
 
     //==============================================================================
@@ -104,8 +129,7 @@ public:
      */
     void reset()
     {
-        highPassFilter.reset();
-        peakingFilter.reset();
+        cascade.reset();
     }
 
     //==============================================================================
@@ -113,9 +137,8 @@ public:
     double getSampleRate() const { return currentSampleRate; }
 
 private:
-    // High-pass filter for rumble removal + presence peak for brightness
-    juce::dsp::IIR::Filter<float> highPassFilter;  ///< 100 Hz high-pass for rumble removal
-    juce::dsp::IIR::Filter<float> peakingFilter;   ///< 3500 Hz peak (+6 dB) for presence
+    // High-pass (100 Hz) for rumble removal + presence peak (3500 Hz, +6 dB)
+    DSP::BiquadCascade<SampleType> cascade;
 
     double currentSampleRate = 44100.0;
 
@@ -0,0 +1,221 @@
+#pragma once
+
+#include "SIMDVector.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+//==============================================================================
+/**
+ * RealFFT - Power-of-two FFT of real signals, split real/imaginary spectra
+ *
+ * A real block of N samples is packed into N/2 complex values (even samples
+ * real, odd samples imaginary), transformed by an iterative radix-2 FFT of
+ * half the size and split into the N/2 + 1 bins of the real spectrum; the
+ * inverse runs the same steps backwards. Spectra are kept as separate real
+ * and imaginary arrays, so the butterflies, and a caller's spectral
+ * multiply-adds, run on whole SIMDVectors.
+ *
+ * Twiddles and the bit-reversal table are computed once, in prepare().
+ * Templated on the sample type like every kernel here (juce::dsp::FFT is
+ * float only), and free of JUCE.
+ *
+ * Real-Time Safety: ✅
+ * - Tables and work buffers allocated in prepare(); forward() and inverse()
+ *   allocate nothing
+ */
+namespace DSP {
+
+template <typename SampleType>
+class RealFFT
+{
+public:
+    /** Prepares for blocks of 2^order samples (order >= 2). */
+    void prepare(int order)
+    {
+        size = 1 << std::max(order, 2);
+        const int half = size / 2;
+
+        // Bit reversal of the half-size complex transform
+        reversed.resize(static_cast<size_t>(half));
+        int bits = 0;
+        while ((1 << bits) < half)
+            ++bits;
+
+        for (int i = 0; i < half; ++i)
+        {
+            int r = 0;
+            for (int b = 0; b < bits; ++b)
+                r |= ((i >> b) & 1) << (bits - 1 - b);
+            reversed[(size_t) i] = r;
+        }
+
+        // Butterfly twiddles, one contiguous run per stage (span h at offset h - 1)
+        stageRe.assign(static_cast<size_t>(std::max(half - 1, 1)), SampleType(0));
+        stageIm.assign(stageRe.size(), SampleType(0));
+        for (int h = 1; h < half; h *= 2)
+        {
+            for (int j = 0; j < h; ++j)
+            {
+                const double angle = -pi * j / h;
+                stageRe[(size_t) (h - 1 + j)] = static_cast<SampleType>(std::cos(angle));
+                stageIm[(size_t) (h - 1 + j)] = static_cast<SampleType>(std::sin(angle));
+            }
+        }
+
+        // Split twiddles exp(-2 pi i k / N) for the real/complex conversion
+        splitRe.resize(static_cast<size_t>(half + 1));
+        splitIm.resize(static_cast<size_t>(half + 1));
+        for (int k = 0; k <= half; ++k)
+        {
+            const double angle = -2.0 * pi * k / size;
+            splitRe[(size_t) k] = static_cast<SampleType>(std::cos(angle));
+            splitIm[(size_t) k] = static_cast<SampleType>(std::sin(angle));
+        }
+
+        workRe.assign(static_cast<size_t>(half), SampleType(0));
+        workIm.assign(static_cast<size_t>(half), SampleType(0));
+    }
+
+    /** Block length N (the spectrum has N / 2 + 1 bins). */
+    int getSize() const { return size; }
+
+    //==============================================================================
+    /** Spectrum of size real samples into re / im (size / 2 + 1 bins each). */
+    void forward(const SampleType* input, SampleType* re, SampleType* im)
+    {
+        const int half = size / 2;
+
+        for (int n = 0; n < half; ++n)
+        {
+            const auto r = static_cast<size_t>(reversed[(size_t) n]);
+            workRe[r] = input[2 * n];
+            workIm[r] = input[2 * n + 1];
+        }
+
+        transform(workRe.data(), workIm.data());
+
+        // Z[k] holds the even and odd samples' spectra: X[k] = E[k] + W^k O[k]
+        re[0] = workRe[0] + workIm[0];
+        im[0] = SampleType(0);
+        re[half] = workRe[0] - workIm[0];
+        im[half] = SampleType(0);
+
+        for (int k = 1; k <= half / 2; ++k)
+        {
+            const int m = half - k;
+            const SampleType zr = workRe[(size_t) k], zi = workIm[(size_t) k];
+            const SampleType cr = workRe[(size_t) m], ci = -workIm[(size_t) m];  // conj(Z[N/2 - k])
+
+            const SampleType er = SampleType(0.5) * (zr + cr), ei = SampleType(0.5) * (zi + ci);
+            const SampleType dr = SampleType(0.5) * (zr - cr), di = SampleType(0.5) * (zi - ci);
+
+            // O[k] = (Z[k] - conj(Z[N/2 - k])) / 2i
+            const SampleType odr = di, odi = -dr;
+            const SampleType wr = splitRe[(size_t) k], wi = splitIm[(size_t) k];
+            const SampleType tr = wr * odr - wi * odi, ti = wr * odi + wi * odr;
+
+            re[k] = er + tr;
+            im[k] = ei + ti;
+
+            // Bin N/2 - k follows from the same E and O (conjugate symmetry)
+            re[m] = er - tr;
+            im[m] = -(ei - ti);
+        }
+    }
+
+    /** Real signal of a spectrum (size / 2 + 1 bins), scaled by size / 2. */
+    void inverse(const SampleType* re, const SampleType* im, SampleType* output)
+    {
+        const int half = size / 2;
+
+        // Z[k] = E[k] + i O[k], written conjugated and bit-reversed (inverse via the forward transform)
+        for (int k = 0; k < half; ++k)
+        {
+            const int m = half - k;
+            const SampleType xr = re[k], xi = im[k];
+            const SampleType cr = re[m], ci = -im[m];   // conj(X[N/2 - k])
+
+            const SampleType er = SampleType(0.5) * (xr + cr), ei = SampleType(0.5) * (xi + ci);
+            const SampleType dr = SampleType(0.5) * (xr - cr), di = SampleType(0.5) * (xi - ci);
+
+            // O[k] = (X[k] - conj(X[N/2 - k])) conj(W^k) / 2
+            const SampleType wr = splitRe[(size_t) k], wi = -splitIm[(size_t) k];
+            const SampleType odr = dr * wr - di * wi, odi = dr * wi + di * wr;
+
+            const auto r = static_cast<size_t>(reversed[(size_t) k]);
+            workRe[r] = er - odi;
+            workIm[r] = -(ei + odr);
+        }
+
+        transform(workRe.data(), workIm.data());
+
+        for (int n = 0; n < half; ++n)
+        {
+            output[2 * n] = workRe[(size_t) n];
+            output[2 * n + 1] = -workIm[(size_t) n];
+        }
+    }
+
+private:
+    /** In-place radix-2 decimation-in-time FFT of bit-reversed input. */
+    void transform(SampleType* re, SampleType* im) const
+    {
+        using Vector = SIMDVector<SampleType>;
+        constexpr int width = Vector::size;
+        const int half = size / 2;
+
+        for (int h = 1; h < half; h *= 2)
+        {
+            const SampleType* twiddleRe = stageRe.data() + (h - 1);
+            const SampleType* twiddleIm = stageIm.data() + (h - 1);
+
+            for (int group = 0; group < half; group += 2 * h)
+            {
+                SampleType* aRe = re + group;
+                SampleType* aIm = im + group;
+                SampleType* bRe = aRe + h;
+                SampleType* bIm = aIm + h;
+
+                int j = 0;
+                if (h >= width)
+                {
+                    for (; j < h; j += width)
+                    {
+                        const auto wr = Vector::loadUnaligned(twiddleRe + j), wi = Vector::loadUnaligned(twiddleIm + j);
+                        const auto xr = Vector::loadUnaligned(bRe + j), xi = Vector::loadUnaligned(bIm + j);
+                        const auto tr = wr * xr - wi * xi, ti = wr * xi + wi * xr;
+                        const auto ar = Vector::loadUnaligned(aRe + j), ai = Vector::loadUnaligned(aIm + j);
+
+                        (ar + tr).storeUnaligned(aRe + j);
+                        (ai + ti).storeUnaligned(aIm + j);
+                        (ar - tr).storeUnaligned(bRe + j);
+                        (ai - ti).storeUnaligned(bIm + j);
+                    }
+                }
+
+                for (; j < h; ++j)
+                {
+                    const SampleType wr = twiddleRe[j], wi = twiddleIm[j];
+                    const SampleType tr = wr * bRe[j] - wi * bIm[j], ti = wr * bIm[j] + wi * bRe[j];
+                    const SampleType ar = aRe[j], ai = aIm[j];
+
+                    aRe[j] = ar + tr;
+                    aIm[j] = ai + ti;
+                    bRe[j] = ar - tr;
+                    bIm[j] = ai - ti;
+                }
+            }
+        }
+    }
+
+    static constexpr double pi = 3.141592653589793238;
+
+    int size = 4;
+    std::vector<int> reversed;
+    std::vector<SampleType> stageRe, stageIm;   ///< Butterfly twiddles per stage
+    std::vector<SampleType> splitRe, splitIm;   ///< exp(-2 pi i k / N), k = 0 .. N / 2
+    std::vector<SampleType> workRe, workIm;
+};
+
+} // namespace DSP
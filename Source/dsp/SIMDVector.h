@@ -0,0 +1,204 @@
+#pragma once
+
+#include <algorithm>
+
+#if defined(__AVX__)
+ #include <immintrin.h>
+ #define PF_SIMD_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+ #include <emmintrin.h>
+ #define PF_SIMD_SSE2 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+ #include <arm_neon.h>
+ #define PF_SIMD_NEON 1
+#endif
+
+//==============================================================================
+/**
+ * SIMDVector - Minimal portable SIMD register wrapper for the DSP kernels
+ *
+ * One register's worth of float or double lanes (AVX: 8/4, SSE2 and NEON:
+ * 4/2, otherwise a 1-lane scalar fallback) with just the operations the
+ * lane-parallel kernels need. Deliberately JUCE-free so the kernels can be
+ * built into headless tools without the JUCE modules; in spirit it is a
+ * cut-down juce::dsp::SIMDRegister.
+ *
+ * load()/store() require SIMDVector::alignment-aligned pointers;
+ * loadUnaligned()/storeUnaligned() take any pointer (FIR taps over a sliding
+ * window can never be aligned).
+ */
+namespace DSP {
+
+/** Scalar fallback: one lane. */
+template <typename SampleType>
+struct SIMDVector
+{
+    static constexpr int size = 1;
+    static constexpr int alignment = alignof(SampleType);
+
+    SampleType value;
+
+    static SIMDVector load(const SampleType* p)      { return { *p }; }
+    static SIMDVector loadUnaligned(const SampleType* p) { return { *p }; }
+    static SIMDVector expand(SampleType s)           { return { s }; }
+    void store(SampleType* p) const                  { *p = value; }
+    void storeUnaligned(SampleType* p) const         { *p = value; }
+
+    friend SIMDVector operator+(SIMDVector a, SIMDVector b) { return { a.value + b.value }; }
+    friend SIMDVector operator-(SIMDVector a, SIMDVector b) { return { a.value - b.value }; }
+    friend SIMDVector operator*(SIMDVector a, SIMDVector b) { return { a.value * b.value }; }
+    friend SIMDVector operator/(SIMDVector a, SIMDVector b) { return { a.value / b.value }; }
+    static SIMDVector min(SIMDVector a, SIMDVector b) { return { std::min(a.value, b.value) }; }
+    static SIMDVector max(SIMDVector a, SIMDVector b) { return { std::max(a.value, b.value) }; }
+};
+
+#if PF_SIMD_AVX
+template <>
+struct SIMDVector<float>
+{
+    static constexpr int size = 8;
+    static constexpr int alignment = 32;
+
+    __m256 value;
+
+    static SIMDVector load(const float* p)  { return { _mm256_load_ps(p) }; }
+    static SIMDVector loadUnaligned(const float* p) { return { _mm256_loadu_ps(p) }; }
+    static SIMDVector expand(float s)       { return { _mm256_set1_ps(s) }; }
+    void store(float* p) const              { _mm256_store_ps(p, value); }
+    void storeUnaligned(float* p) const     { _mm256_storeu_ps(p, value); }
+
+    friend SIMDVector operator+(SIMDVector a, SIMDVector b) { return { _mm256_add_ps(a.value, b.value) }; }
+    friend SIMDVector operator-(SIMDVector a, SIMDVector b) { return { _mm256_sub_ps(a.value, b.value) }; }
+    friend SIMDVector operator*(SIMDVector a, SIMDVector b) { return { _mm256_mul_ps(a.value, b.value) }; }
+    friend SIMDVector operator/(SIMDVector a, SIMDVector b) { return { _mm256_div_ps(a.value, b.value) }; }
+    static SIMDVector min(SIMDVector a, SIMDVector b) { return { _mm256_min_ps(a.value, b.value) }; }
+    static SIMDVector max(SIMDVector a, SIMDVector b) { return { _mm256_max_ps(a.value, b.value) }; }
+};
+
+template <>
+struct SIMDVector<double>
+{
+    static constexpr int size = 4;
+    static constexpr int alignment = 32;
+
+    __m256d value;
+
+    static SIMDVector load(const double* p) { return { _mm256_load_pd(p) }; }
+    static SIMDVector loadUnaligned(const double* p) { return { _mm256_loadu_pd(p) }; }
+    static SIMDVector expand(double s)      { return { _mm256_set1_pd(s) }; }
+    void store(double* p) const             { _mm256_store_pd(p, value); }
+    void storeUnaligned(double* p) const    { _mm256_storeu_pd(p, value); }
+
+    friend SIMDVector operator+(SIMDVector a, SIMDVector b) { return { _mm256_add_pd(a.value, b.value) }; }
+    friend SIMDVector operator-(SIMDVector a, SIMDVector b) { return { _mm256_sub_pd(a.value, b.value) }; }
+    friend SIMDVector operator*(SIMDVector a, SIMDVector b) { return { _mm256_mul_pd(a.value, b.value) }; }
+    friend SIMDVector operator/(SIMDVector a, SIMDVector b) { return { _mm256_div_pd(a.value, b.value) }; }
+    static SIMDVector min(SIMDVector a, SIMDVector b) { return { _mm256_min_pd(a.value, b.value) }; }
+    static SIMDVector max(SIMDVector a, SIMDVector b) { return { _mm256_max_pd(a.value, b.value) }; }
+};
+
+#elif PF_SIMD_SSE2
+template <>
+struct SIMDVector<float>
+{
+    static constexpr int size = 4;
+    static constexpr int alignment = 16;
+
+    __m128 value;
+
+    static SIMDVector load(const float* p)  { return { _mm_load_ps(p) }; }
+    static SIMDVector loadUnaligned(const float* p) { return { _mm_loadu_ps(p) }; }
+    static SIMDVector expand(float s)       { return { _mm_set1_ps(s) }; }
+    void store(float* p) const              { _mm_store_ps(p, value); }
+    void storeUnaligned(float* p) const     { _mm_storeu_ps(p, value); }
+
+    friend SIMDVector operator+(SIMDVector a, SIMDVector b) { return { _mm_add_ps(a.value, b.value) }; }
+    friend SIMDVector operator-(SIMDVector a, SIMDVector b) { return { _mm_sub_ps(a.value, b.value) }; }
+    friend SIMDVector operator*(SIMDVector a, SIMDVector b) { return { _mm_mul_ps(a.value, b.value) }; }
+    friend SIMDVector operator/(SIMDVector a, SIMDVector b) { return { _mm_div_ps(a.value, b.value) }; }
+    static SIMDVector min(SIMDVector a, SIMDVector b) { return { _mm_min_ps(a.value, b.value) }; }
+    static SIMDVector max(SIMDVector a, SIMDVector b) { return { _mm_max_ps(a.value, b.value) }; }
+};
+
+template <>
+struct SIMDVector<double>
+{
+    static constexpr int size = 2;
+    static constexpr int alignment = 16;
+
+    __m128d value;
+
+    static SIMDVector load(const double* p) { return { _mm_load_pd(p) }; }
+    static SIMDVector loadUnaligned(const double* p) { return { _mm_loadu_pd(p) }; }
+    static SIMDVector expand(double s)      { return { _mm_set1_pd(s) }; }
+    void store(double* p) const             { _mm_store_pd(p, value); }
+    void storeUnaligned(double* p) const    { _mm_storeu_pd(p, value); }
+
+    friend SIMDVector operator+(SIMDVector a, SIMDVector b) { return { _mm_add_pd(a.value, b.value) }; }
+    friend SIMDVector operator-(SIMDVector a, SIMDVector b) { return { _mm_sub_pd(a.value, b.value) }; }
+    friend SIMDVector operator*(SIMDVector a, SIMDVector b) { return { _mm_mul_pd(a.value, b.value) }; }
+    friend SIMDVector operator/(SIMDVector a, SIMDVector b) { return { _mm_div_pd(a.value, b.value) }; }
+    static SIMDVector min(SIMDVector a, SIMDVector b) { return { _mm_min_pd(a.value, b.value) }; }
+    static SIMDVector max(SIMDVector a, SIMDVector b) { return { _mm_max_pd(a.value, b.value) }; }
+};
+
+#elif PF_SIMD_NEON
+template <>
+struct SIMDVector<float>
+{
+    static constexpr int size = 4;
+    static constexpr int alignment = 16;
+
+    float32x4_t value;
+
+    static SIMDVector load(const float* p)  { return { vld1q_f32(p) }; }
+    static SIMDVector loadUnaligned(const float* p) { return { vld1q_f32(p) }; }
+    static SIMDVector expand(float s)       { return { vdupq_n_f32(s) }; }
+    void store(float* p) const              { vst1q_f32(p, value); }
+    void storeUnaligned(float* p) const     { vst1q_f32(p, value); }
+
+    friend SIMDVector operator+(SIMDVector a, SIMDVector b) { return { vaddq_f32(a.value, b.value) }; }
+    friend SIMDVector operator-(SIMDVector a, SIMDVector b) { return { vsubq_f32(a.value, b.value) }; }
+    friend SIMDVector operator*(SIMDVector a, SIMDVector b) { return { vmulq_f32(a.value, b.value) }; }
+ #if defined(__aarch64__) || defined(_M_ARM64)
+    friend SIMDVector operator/(SIMDVector a, SIMDVector b) { return { vdivq_f32(a.value, b.value) }; }
+ #else
+    friend SIMDVector operator/(SIMDVector a, SIMDVector b)
+    {
+        // ARMv7 has no vector divide: reciprocal estimate plus two Newton steps
+        auto r = vrecpeq_f32(b.value);
+        r = vmulq_f32(vrecpsq_f32(b.value, r), r);
+        r = vmulq_f32(vrecpsq_f32(b.value, r), r);
+        return { vmulq_f32(a.value, r) };
+    }
+ #endif
+    static SIMDVector min(SIMDVector a, SIMDVector b) { return { vminq_f32(a.value, b.value) }; }
+    static SIMDVector max(SIMDVector a, SIMDVector b) { return { vmaxq_f32(a.value, b.value) }; }
+};
+
+ #if defined(__aarch64__) || defined(_M_ARM64)
+template <>
+struct SIMDVector<double>
+{
+    static constexpr int size = 2;
+    static constexpr int alignment = 16;
+
+    float64x2_t value;
+
+    static SIMDVector load(const double* p) { return { vld1q_f64(p) }; }
+    static SIMDVector loadUnaligned(const double* p) { return { vld1q_f64(p) }; }
+    static SIMDVector expand(double s)      { return { vdupq_n_f64(s) }; }
+    void store(double* p) const             { vst1q_f64(p, value); }
+    void storeUnaligned(double* p) const    { vst1q_f64(p, value); }
+
+    friend SIMDVector operator+(SIMDVector a, SIMDVector b) { return { vaddq_f64(a.value, b.value) }; }
+    friend SIMDVector operator-(SIMDVector a, SIMDVector b) { return { vsubq_f64(a.value, b.value) }; }
+    friend SIMDVector operator*(SIMDVector a, SIMDVector b) { return { vmulq_f64(a.value, b.value) }; }
+    friend SIMDVector operator/(SIMDVector a, SIMDVector b) { return { vdivq_f64(a.value, b.value) }; }
+    static SIMDVector min(SIMDVector a, SIMDVector b) { return { vminq_f64(a.value, b.value) }; }
+    static SIMDVector max(SIMDVector a, SIMDVector b) { return { vmaxq_f64(a.value, b.value) }; }
+};
+ #endif
+#endif
+
+} // namespace DSP
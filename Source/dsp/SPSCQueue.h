@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+//==============================================================================
+/**
+ * SPSCQueue - Wait-free single-producer / single-consumer ring buffer
+ *
+ * A fixed array of Capacity slots (a power of two) with one atomic index
+ * per side: the producer (typically the audio thread) only advances the
+ * write index, the consumer (typically a UI timer) only the read index.
+ * push() and pop() are a copy plus one acquire load and one release store,
+ * whatever the other thread is doing; a full queue makes push() return
+ * false instead of waiting, so the producer decides what a drop means.
+ *
+ * Exactly one thread may push and exactly one (other) thread may pop.
+ *
+ * Real-Time Safety: ✅
+ * - Storage is part of the object; no allocation, no locks
+ */
+namespace DSP {
+
+template <typename Type, std::size_t Capacity>
+class SPSCQueue
+{
+public:
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    SPSCQueue() = default;
+
+    //==============================================================================
+    /** Producer: appends a copy of item, or returns false if the queue is full. */
+    bool push(const Type& item)
+    {
+        const auto write = writeIndex.load(std::memory_order_relaxed);
+
+        if (write - readIndex.load(std::memory_order_acquire) == Capacity)
+            return false;
+
+        slots[write & mask] = item;
+        writeIndex.store(write + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** Consumer: moves the oldest item into item, or returns false if the queue is empty. */
+    bool pop(Type& item)
+    {
+        const auto read = readIndex.load(std::memory_order_relaxed);
+
+        if (read == writeIndex.load(std::memory_order_acquire))
+            return false;
+
+        item = slots[read & mask];
+        readIndex.store(read + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** Items waiting (exact on either side's own thread, a snapshot anywhere else). */
+    std::size_t size() const
+    {
+        return writeIndex.load(std::memory_order_acquire) - readIndex.load(std::memory_order_acquire);
+    }
+
+    static constexpr std::size_t capacity() { return Capacity; }
+
+private:
+    static constexpr std::size_t mask = Capacity - 1;
+
+    std::array<Type, Capacity> slots {};
+
+    // Each index on its own cache line, so the two threads do not share one
+    alignas(64) std::atomic<std::size_t> writeIndex { 0 };
+    alignas(64) std::atomic<std::size_t> readIndex { 0 };
+};
+
+} // namespace DSP
@@ -0,0 +1,270 @@
+#pragma once
+
+#include "BlockDelay.h"
+#include "ModeCrossfade.h"
+#include "Oversampler.h"
+#include "SIMDVector.h"
+#include "../utils/DSPDefines.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+//==============================================================================
+/**
+ * Saturation - Soft-clip drive stage, optionally oversampled
+ *
+ * The waveshaper is a Padé approximant of tanh, c(27 + c²)/(27 + 9c²) with
+ * the input clamped to ±3 where the curve meets ±1 with zero slope. It is a
+ * handful of multiply-adds and one division per sample and runs on whole
+ * SIMDVectors, so no std::tanh is evaluated per sample.
+ *
+ * Drive (0-1) maps to 0-SATURATION_MAX_DRIVE_DB (24 dB) into the clipper,
+ * normalised so full scale still comes out at full scale, and is blended in
+ * with the drive amount so that zero drive is exactly the input. Drive changes ramp over 50 ms, in
+ * steps of rampStepSamples host samples.
+ *
+ * At 2x / 4x the shaper runs inside an Oversampler so its harmonics have
+ * room above the host band instead of folding back. With zero drive the
+ * oversampling is skipped entirely: a plain delay of the same latency takes
+ * its place, so the latency reported to the host never depends on the drive.
+ * Switching between the two paths resets the incoming one, lets it warm up
+ * and crossfades (the drive is held at zero until the switch is complete, so
+ * both sides carry the same signal).
+ *
+ * Real-Time Safety: ✅
+ * - Everything allocated in prepare(); setDrive() and process() allocate nothing
+ * - setOversampling() changes the latency: call it where the host can be told
+ */
+namespace DSP {
+
+template <typename SampleType>
+class Saturation
+{
+public:
+    static constexpr int rampStepSamples = 32;
+
+    void prepare(double newSampleRate, int maxBlockSize, int numChannelsToUse)
+    {
+        sampleRate = newSampleRate;
+        numChannels = std::max(numChannelsToUse, 1);
+        maxBlock = std::max(maxBlockSize, 1);
+
+        oversampler.prepare(sampleRate, maxBlock, numChannels);
+
+        // The idle delay must cover the latency of every factor
+        int maxLatency = 0;
+        for (int candidate = 1; candidate <= (1 << Oversampler<SampleType>::maxStages); candidate *= 2)
+        {
+            oversampler.setFactor(candidate);
+            maxLatency = std::max(maxLatency, oversampler.getLatencySamples());
+        }
+        idleDelay.prepare(numChannels, 0, maxLatency);
+        maxLatencySamples = maxLatency;
+
+        scratch.assign(static_cast<size_t>(numChannels * maxBlock), SampleType(0));
+        scratchPointers.resize(static_cast<size_t>(numChannels));
+        chunkPointers.resize(static_cast<size_t>(numChannels));
+        for (int ch = 0; ch < numChannels; ++ch)
+            scratchPointers[(size_t) ch] = scratch.data() + ch * maxBlock;
+
+        rampStep = SampleType(1) / static_cast<SampleType>(std::max(1.0, 0.05 * sampleRate));
+        setOversampling(factor);
+    }
+
+    /** Selects 1x, 2x or 4x. Changes getLatencySamples() and restarts the stage from silence. */
+    void setOversampling(int newFactor)
+    {
+        oversampler.setFactor(newFactor);
+        factor = oversampler.getFactor();
+        idleDelay.setDelay(oversampler.getLatencySamples());
+        transition.prepare(sampleRate, (2 * oversampler.getLatencySamples()) / sampleRate, 0.01);
+        reset();
+    }
+
+    int getOversampling() const { return factor; }
+
+    /** Drive amount, 0 to 1. */
+    void setDrive(SampleType amount) { targetDrive = std::clamp(amount, SampleType(0), SampleType(1)); }
+
+    /** Constant delay of process() in host samples (0 at 1x). */
+    int getLatencySamples() const { return factor > 1 ? oversampler.getLatencySamples() : 0; }
+
+    /** The largest latency any factor has at the prepared sample rate. */
+    int getMaxLatencySamples() const { return maxLatencySamples; }
+
+    /** False only when process() would return the input unchanged (1x, zero drive, not ramping). */
+    bool isEngaged() const { return factor > 1 || targetDrive > 0 || currentDrive > 0; }
+
+    /** Clears the state. Cleared state suits either path, so the stage restarts
+     *  directly in the one the drive calls for, at the target drive.
+     */
+    void reset()
+    {
+        oversampler.reset();
+        idleDelay.reset();
+        transition.stop();
+        oversampling = targetDrive > 0;
+        currentDrive = targetDrive;
+        updateShape();
+    }
+
+    //==============================================================================
+    /** Saturates the channels in place. */
+    void process(SampleType* const* channels, int numChannelsToProcess, int numSamples)
+    {
+        numChannelsToProcess = std::min(numChannelsToProcess, numChannels);
+
+        if (factor == 1)
+        {
+            if (isEngaged())
+                shapeBlock(channels, numChannelsToProcess, numSamples);
+            return;
+        }
+
+        auto* chunk = chunkPointers.data();
+        for (int start = 0; start < numSamples; start += maxBlock)
+        {
+            const int count = std::min(maxBlock, numSamples - start);
+            for (int ch = 0; ch < numChannelsToProcess; ++ch)
+                chunk[ch] = channels[ch] + start;
+
+            processChunk(chunk, numChannelsToProcess, count);
+        }
+    }
+
+    //==============================================================================
+    /** The waveshaper on one value (also the normalisation of the block version). */
+    static SampleType softClip(SampleType x)
+    {
+        const SampleType c = std::clamp(x, SampleType(-3), SampleType(3));
+        const SampleType c2 = c * c;
+        return c * (SampleType(27) + c2) / (SampleType(27) + SampleType(9) * c2);
+    }
+
+private:
+    void processChunk(SampleType* const* channels, int numChannelsToProcess, int numSamples)
+    {
+        // Oversample only while there is drive to apply; switch paths once any previous switch is done
+        const bool wantOversampling = targetDrive > 0 || currentDrive > 0;
+        if (!transition.isActive() && wantOversampling != oversampling)
+        {
+            oversampling = wantOversampling;
+            if (oversampling)
+                oversampler.reset();
+            else
+                idleDelay.reset();
+
+            transition.start();
+        }
+
+        if (!transition.isActive())
+        {
+            runPath(oversampling, channels, numChannelsToProcess, numSamples);
+            return;
+        }
+
+        // Both paths: outgoing in place, incoming on a copy
+        for (int ch = 0; ch < numChannelsToProcess; ++ch)
+            std::copy(channels[ch], channels[ch] + numSamples, scratchPointers[(size_t) ch]);
+
+        runPath(!oversampling, channels, numChannelsToProcess, numSamples);
+        runPath(oversampling, scratchPointers.data(), numChannelsToProcess, numSamples);
+        transition.process(channels, scratchPointers.data(), numChannelsToProcess, numSamples);
+    }
+
+    void runPath(bool useOversampling, SampleType* const* channels, int numChannelsToProcess, int numSamples)
+    {
+        if (!useOversampling)
+        {
+            idleDelay.process(channels, channels, numChannelsToProcess, numSamples);
+            return;
+        }
+
+        oversampler.process(channels, numChannelsToProcess, numSamples,
+                            [this](SampleType* const* highRate, int numHighRateChannels, int numHighRateSamples)
+                            {
+                                shapeBlock(highRate, numHighRateChannels, numHighRateSamples);
+                            });
+    }
+
+    /** Shapes a block at the current rate, ramping the drive every rampStepSamples host samples. */
+    void shapeBlock(SampleType* const* channels, int numChannelsToProcess, int numSamples)
+    {
+        const int stepLength = rampStepSamples * factor;
+
+        for (int start = 0; start < numSamples; start += stepLength)
+        {
+            const int count = std::min(stepLength, numSamples - start);
+
+            // The drive is held while the paths are switching (it is zero throughout)
+            if (currentDrive != targetDrive && !transition.isActive())
+            {
+                const SampleType step = rampStep * static_cast<SampleType>(count / factor);
+                currentDrive = currentDrive < targetDrive ? std::min(targetDrive, currentDrive + step)
+                                                          : std::max(targetDrive, currentDrive - step);
+                updateShape();
+            }
+
+            if (currentDrive > 0)
+                for (int ch = 0; ch < numChannelsToProcess; ++ch)
+                    shape(channels[ch] + start, count);
+        }
+    }
+
+    /** x + drive * (softClip(gain * x) * makeup - x), in place. */
+    void shape(SampleType* data, int numSamples) const
+    {
+        using Vector = SIMDVector<SampleType>;
+        constexpr int width = Vector::size;
+
+        const auto g = Vector::expand(gain);
+        const auto m = Vector::expand(makeup);
+        const auto a = Vector::expand(currentDrive);
+        const auto limit = Vector::expand(SampleType(3));
+        const auto negativeLimit = Vector::expand(SampleType(-3));
+        const auto c27 = Vector::expand(SampleType(27));
+        const auto c9 = Vector::expand(SampleType(9));
+
+        int i = 0;
+        for (; i + width <= numSamples; i += width)
+        {
+            const auto x = Vector::loadUnaligned(data + i);
+            const auto c = Vector::min(Vector::max(g * x, negativeLimit), limit);
+            const auto c2 = c * c;
+            const auto clipped = c * (c27 + c2) / (c27 + c9 * c2);
+            (x + a * (clipped * m - x)).storeUnaligned(data + i);
+        }
+
+        for (; i < numSamples; ++i)
+            data[i] += currentDrive * (softClip(gain * data[i]) * makeup - data[i]);
+    }
+
+    void updateShape()
+    {
+        gain = std::pow(SampleType(10), currentDrive * static_cast<SampleType>(SATURATION_MAX_DRIVE_DB) / SampleType(20));
+        makeup = SampleType(1) / softClip(gain);
+    }
+
+    //==============================================================================
+    Oversampler<SampleType> oversampler;
+    BlockDelay<SampleType> idleDelay;   ///< Stands in for the oversampler while there is no drive
+    ModeCrossfade<SampleType> transition;
+    std::vector<SampleType> scratch;
+    std::vector<SampleType*> scratchPointers;
+    std::vector<SampleType*> chunkPointers;
+
+    double sampleRate = 44100.0;
+    int numChannels = 1;
+    int maxBlock = 512;
+    int factor = 1;
+    int maxLatencySamples = 0;
+    bool oversampling = false;
+
+    SampleType targetDrive = SampleType(0);
+    SampleType currentDrive = SampleType(0);
+    SampleType rampStep = SampleType(0);
+    SampleType gain = SampleType(1);
+    SampleType makeup = SampleType(1);
+};
+
+} // namespace DSP
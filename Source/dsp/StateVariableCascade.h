@@ -0,0 +1,500 @@
+#pragma once
+
+#include "StateVariableCoefficients.h"
+#include "SIMDVector.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+//==============================================================================
+/**
+ * StateVariableCascade - Fused chain of TPT state-variable sections with
+ * per-sample cutoff modulation
+ *
+ * The zero-delay-feedback counterpart of BiquadCascade: the same layout
+ * (channels in SIMD lanes, small tiles transposed to [frame][lane] on the
+ * stack, kernels instantiated per section count, blend folded into the last
+ * stage, in place or out of place), but each section is a trapezoidal SVF.
+ * The SVF stays stable and well behaved when its cutoff moves every sample,
+ * which a direct-form biquad does not, and retuning it is cheap:
+ *
+ *   - process() takes an optional cutoffScale array, one multiplier per
+ *     sample shared by every channel and section (e.g. DriftModulator).
+ *     Without it the gains are computed once per block and the kernel costs
+ *     about the same as the biquad one.
+ *   - With it, each tile is tuned up front across frames in SIMD lanes:
+ *     tan() via StateVariableCoefficients::tanApprox() and one divide per
+ *     frame and section. All channel groups then share the tuned tile.
+ *
+ * getFreeResponse() / setFreeResponse() describe the state as the next two
+ * output samples the section would produce on silence, which is the same for
+ * any realisation of the same filter. transferCascadeState() uses this to
+ * hand the state of a BiquadCascade to a StateVariableCascade with the same
+ * sections (and back) without a click.
+ *
+ * Real-Time Safety: ✅
+ * - State storage allocated in prepare(), never in process()
+ * - No locks, no system calls
+ */
+namespace DSP {
+
+template <typename SampleType>
+class StateVariableCascade
+{
+public:
+    using Vector = SIMDVector<SampleType>;
+    using Coefficients = StateVariableCoefficients<SampleType>;
+
+    static constexpr int lanes = Vector::size;
+    static constexpr int maxSections = 4;
+    static constexpr int tileSize = 32;
+
+    StateVariableCascade() = default;
+
+    //==============================================================================
+    /** Allocates state for up to maxChannels channels and clears it. */
+    void prepare(int maxChannels)
+    {
+        numGroups = (std::max(maxChannels, 1) + lanes - 1) / lanes;
+        state.assign(static_cast<size_t>(numGroups * maxSections * 2 * lanes), SampleType(0));
+    }
+
+    /** Replaces the whole section list (1..maxSections entries). Clears nothing. */
+    void setSections(const Coefficients* newSections, int count)
+    {
+        numSections = std::max(1, std::min(count, maxSections));
+        for (int s = 0; s < numSections; ++s)
+            setCoefficients(s, newSections[s]);
+    }
+
+    /** Updates one section's coefficients, keeping its state. */
+    void setCoefficients(int section, const Coefficients& newCoefficients)
+    {
+        if (section < 0 || section >= numSections)
+            return;
+
+        sections[section] = newCoefficients;
+        staticGains[section] = tune(newCoefficients, newCoefficients.omega);
+    }
+
+    const Coefficients& getCoefficients(int section) const { return sections[section]; }
+    int getNumSections() const { return numSections; }
+
+    /** Clears the integrator state of every section and channel. */
+    void reset()
+    {
+        std::fill(state.begin(), state.end(), SampleType(0));
+    }
+
+    //==============================================================================
+    /** Filters numChannels non-interleaved channels in place, blending
+     *  dry * (1 - mix) + wet * mix into the output of the last section.
+     *
+     * @param cutoffScale Optional per-sample cutoff multiplier (numSamples
+     *                    values, applied to every section), nullptr = static
+     */
+    void process(SampleType* const* channels, int numChannels, int numSamples,
+                 SampleType mix = SampleType(1), const SampleType* cutoffScale = nullptr)
+    {
+        process(channels, channels, numChannels, numSamples, mix, cutoffScale);
+    }
+
+    /** Out-of-place version: reads input, writes the blended result to output.
+     *
+     * Each output channel may alias its own input channel, but not another one.
+     */
+    void process(const SampleType* const* input, SampleType* const* output,
+                 int numChannels, int numSamples, SampleType mix = SampleType(1),
+                 const SampleType* cutoffScale = nullptr)
+    {
+        if (cutoffScale != nullptr)
+            dispatchBlend<true>(input, output, numChannels, numSamples, mix, cutoffScale);
+        else
+            dispatchBlend<false>(input, output, numChannels, numSamples, mix, cutoffScale);
+    }
+
+    /** process() with the section count fixed at compile time (it must equal
+     *  getNumSections()), so no switch on the count runs per block; see DSP::Chain.
+     */
+    template <int NumSections>
+    void process(const SampleType* const* input, SampleType* const* output,
+                 int numChannels, int numSamples, SampleType mix = SampleType(1),
+                 const SampleType* cutoffScale = nullptr)
+    {
+        static_assert(NumSections >= 1 && NumSections <= maxSections, "Section count out of range");
+
+        if (cutoffScale != nullptr)
+        {
+            if (mix < SampleType(1))
+                processAllGroups<NumSections, true, true>(input, output, numChannels, numSamples, mix, cutoffScale);
+            else
+                processAllGroups<NumSections, true, false>(input, output, numChannels, numSamples, mix, cutoffScale);
+        }
+        else
+        {
+            if (mix < SampleType(1))
+                processAllGroups<NumSections, false, true>(input, output, numChannels, numSamples, mix, cutoffScale);
+            else
+                processAllGroups<NumSections, false, false>(input, output, numChannels, numSamples, mix, cutoffScale);
+        }
+    }
+
+    //==============================================================================
+    /** The next two outputs of one section on silence, from its stored state
+     *  (unmodulated tuning). Channels beyond prepare() read as silent.
+     */
+    void getFreeResponse(int channel, int section, SampleType& y0, SampleType& y1) const
+    {
+        y0 = y1 = SampleType(0);
+        if (const auto* s = stateFor(channel, section))
+            freeResponse(section, s[0], s[lanes], y0, y1);
+    }
+
+    /** Sets one section's state so that its next two outputs on silence are
+     *  y0 and y1 (and so its whole future output matches the source filter).
+     */
+    void setFreeResponse(int channel, int section, SampleType y0, SampleType y1)
+    {
+        auto* s = stateFor(channel, section);
+        if (s == nullptr)
+            return;
+
+        // Outputs are linear in (ic1, ic2): solve the 2x2 system in double
+        SampleType p0, p1, q0, q1;
+        freeResponse(section, SampleType(1), SampleType(0), p0, p1);
+        freeResponse(section, SampleType(0), SampleType(1), q0, q1);
+
+        const double det = static_cast<double>(p0) * q1 - static_cast<double>(q0) * p1;
+        const double scale = std::abs(static_cast<double>(p0) * q1) + std::abs(static_cast<double>(q0) * p1);
+
+        // Unobservable section (e.g. a peak with unity gain): its state has no effect
+        if (std::abs(det) <= 1.0e-9 * scale)
+        {
+            s[0] = s[lanes] = SampleType(0);
+            return;
+        }
+
+        s[0] = static_cast<SampleType>((y0 * static_cast<double>(q1) - static_cast<double>(q0) * y1) / det);
+        s[lanes] = static_cast<SampleType>((static_cast<double>(p0) * y1 - y0 * static_cast<double>(p1)) / det);
+    }
+
+private:
+    //==============================================================================
+    /** Gains for one section at one tuning (twoG = 2 * g, see processGroupTile()). */
+    struct Gains
+    {
+        SampleType twoG = 0, a1 = 1, a2 = 0;
+    };
+
+    /** Per-frame gains of one tile, tuned in SIMD lanes across frames. */
+    struct TileGains
+    {
+        alignas(Vector::alignment) SampleType twoG[maxSections][tileSize];
+        alignas(Vector::alignment) SampleType a1[maxSections][tileSize];
+        alignas(Vector::alignment) SampleType a2[maxSections][tileSize];
+    };
+
+    static Gains tune(const Coefficients& c, SampleType omega)
+    {
+        const auto g = Coefficients::tanApprox(std::min(std::max(omega, minOmega()), Coefficients::maxOmega));
+        const auto a1 = 1 / (1 + g * (g + c.k));
+        return { g + g, a1, g * a1 };
+    }
+
+    template <int NumSections>
+    void tuneTile(const SampleType* cutoffScale, int len, TileGains& gains) const
+    {
+        alignas(Vector::alignment) SampleType scale[tileSize];
+        std::copy(cutoffScale, cutoffScale + len, scale);
+        std::fill(scale + len, scale + tileSize, SampleType(1));
+
+        const auto constant = [](SampleType c) { return Vector::expand(c); };
+        const auto one = constant(1);
+        const auto lowest = constant(minOmega());
+        const auto highest = constant(Coefficients::maxOmega);
+
+        for (int s = 0; s < NumSections; ++s)
+        {
+            const auto omega = constant(sections[s].omega);
+            const auto k = constant(sections[s].k);
+
+            for (int n = 0; n < len; n += lanes)
+            {
+                const auto w = Vector::min(Vector::max(omega * Vector::load(scale + n), lowest), highest);
+                const auto g = Coefficients::tanApprox(w, constant);
+                const auto a1 = one / (one + g * (g + k));
+
+                (g + g).store(gains.twoG[s] + n);
+                a1.store(gains.a1[s] + n);
+                (g * a1).store(gains.a2[s] + n);
+            }
+        }
+    }
+
+    //==============================================================================
+    template <bool Modulated>
+    void dispatchBlend(const SampleType* const* input, SampleType* const* output,
+                       int numChannels, int numSamples, SampleType mix, const SampleType* cutoffScale)
+    {
+        if (mix < SampleType(1))
+            dispatch<Modulated, true>(input, output, numChannels, numSamples, mix, cutoffScale);
+        else
+            dispatch<Modulated, false>(input, output, numChannels, numSamples, mix, cutoffScale);
+    }
+
+    template <bool Modulated, bool Blend>
+    void dispatch(const SampleType* const* input, SampleType* const* output,
+                  int numChannels, int numSamples, SampleType mix, const SampleType* cutoffScale)
+    {
+        switch (numSections)
+        {
+            case 1:  processAllGroups<1, Modulated, Blend>(input, output, numChannels, numSamples, mix, cutoffScale); break;
+            case 2:  processAllGroups<2, Modulated, Blend>(input, output, numChannels, numSamples, mix, cutoffScale); break;
+            case 3:  processAllGroups<3, Modulated, Blend>(input, output, numChannels, numSamples, mix, cutoffScale); break;
+            default: processAllGroups<4, Modulated, Blend>(input, output, numChannels, numSamples, mix, cutoffScale); break;
+        }
+    }
+
+    /** Tiles outside, channel groups inside, so every group shares one tuned tile. */
+    template <int NumSections, bool Modulated, bool Blend>
+    void processAllGroups(const SampleType* const* input, SampleType* const* output,
+                          int numChannels, int numSamples, SampleType mix, const SampleType* cutoffScale)
+    {
+        numChannels = std::min(numChannels, numGroups * lanes);
+        TileGains gains {};
+
+        for (int start = 0; start < numSamples; start += tileSize)
+        {
+            const int len = std::min(tileSize, numSamples - start);
+
+            if (Modulated)
+                tuneTile<NumSections>(cutoffScale + start, len, gains);
+
+            for (int first = 0, group = 0; first < numChannels; first += lanes, ++group)
+            {
+                auto* groupState = state.data() + group * maxSections * 2 * lanes;
+                const int activeLanes = std::min(lanes, numChannels - first);
+
+                if (activeLanes == 1)
+                    processScalarTile<NumSections, Modulated, Blend>(input[first] + start, output[first] + start,
+                                                                     len, mix, groupState, gains);
+                else
+                    processGroupTile<NumSections, Modulated, Blend>(input + first, output + first, activeLanes,
+                                                                    start, len, mix, groupState, gains);
+            }
+        }
+
+        // Flush tiny state values so silent input decays to true zero (no denormals)
+        const auto used = static_cast<size_t>(((numChannels + lanes - 1) / lanes) * maxSections * 2 * lanes);
+        for (size_t i = 0; i < used; ++i)
+            state[i] = snapToZero(state[i]);
+    }
+
+    /** State layout per group: [section][ic1 lanes..., ic2 lanes...] */
+    template <int NumSections, bool Modulated, bool Blend>
+    void processGroupTile(const SampleType* const* input, SampleType* const* output, int activeLanes,
+                          int start, int len, SampleType mix, SampleType* groupState, const TileGains& gains)
+    {
+        Vector twoG[NumSections], a1[NumSections], a2[NumSections];
+        Vector m0[NumSections], m1[NumSections], halfM2[NumSections];
+        Vector ic1[NumSections], ic2[NumSections];
+
+        for (int s = 0; s < NumSections; ++s)
+        {
+            twoG[s] = Vector::expand(staticGains[s].twoG);
+            a1[s] = Vector::expand(staticGains[s].a1);
+            a2[s] = Vector::expand(staticGains[s].a2);
+            m0[s] = Vector::expand(sections[s].m0);
+            m1[s] = Vector::expand(sections[s].m1);
+            halfM2[s] = Vector::expand(sections[s].m2 * SampleType(0.5));
+            ic1[s] = loadLanes(groupState + (2 * s) * lanes);
+            ic2[s] = loadLanes(groupState + (2 * s + 1) * lanes);
+        }
+
+        const auto wetGain = Vector::expand(mix);
+        const auto dryGain = Vector::expand(SampleType(1) - mix);
+
+        alignas(Vector::alignment) SampleType tile[tileSize][lanes];
+
+        // Transpose in: channel-major -> [frame][lane], unused lanes run on silence
+        for (int l = 0; l < lanes; ++l)
+        {
+            const auto* src = l < activeLanes ? input[l] + start : nullptr;
+            for (int n = 0; n < len; ++n)
+                tile[n][l] = src != nullptr ? src[n] : SampleType(0);
+        }
+
+        // Whole chain per frame, blend folded into the last stage
+        for (int n = 0; n < len; ++n)
+        {
+            const auto dry = Vector::load(tile[n]);
+            auto x = dry;
+
+            for (int s = 0; s < NumSections; ++s)
+            {
+                if (Modulated)
+                {
+                    twoG[s] = Vector::expand(gains.twoG[s][n]);
+                    a1[s] = Vector::expand(gains.a1[s][n]);
+                    a2[s] = Vector::expand(gains.a2[s][n]);
+                }
+
+                // Trapezoidal SVF, rearranged to keep the recursion short:
+                // v2 = ic2 + g * v1 = (ic2 + ic2') / 2 and ic2' = ic2 + 2g * v1
+                const auto v1 = (a1[s] * ic1[s]) + (a2[s] * (x - ic2[s]));
+                const auto nextIc2 = ic2[s] + (twoG[s] * v1);
+                x = (m0[s] * x) + (m1[s] * v1) + (halfM2[s] * (ic2[s] + nextIc2));
+                ic1[s] = v1 + v1 - ic1[s];
+                ic2[s] = nextIc2;
+            }
+
+            if (Blend)
+                x = (dry * dryGain) + (x * wetGain);
+
+            x.store(tile[n]);
+        }
+
+        // Transpose out
+        for (int l = 0; l < activeLanes; ++l)
+        {
+            auto* dst = output[l] + start;
+            for (int n = 0; n < len; ++n)
+                dst[n] = tile[n][l];
+        }
+
+        for (int s = 0; s < NumSections; ++s)
+        {
+            storeLanes(ic1[s], groupState + (2 * s) * lanes);
+            storeLanes(ic2[s], groupState + (2 * s + 1) * lanes);
+        }
+    }
+
+    template <int NumSections, bool Modulated, bool Blend>
+    void processScalarTile(const SampleType* input, SampleType* output, int len,
+                           SampleType mix, SampleType* groupState, const TileGains& gains) const
+    {
+        SampleType ic1[NumSections], ic2[NumSections];
+        for (int s = 0; s < NumSections; ++s)
+        {
+            ic1[s] = groupState[(2 * s) * lanes];
+            ic2[s] = groupState[(2 * s + 1) * lanes];
+        }
+
+        const auto dryGain = SampleType(1) - mix;
+
+        for (int n = 0; n < len; ++n)
+        {
+            const auto dry = input[n];
+            auto x = dry;
+
+            for (int s = 0; s < NumSections; ++s)
+            {
+                const auto& c = sections[s];
+                const auto twoG = Modulated ? gains.twoG[s][n] : staticGains[s].twoG;
+                const auto a1 = Modulated ? gains.a1[s][n] : staticGains[s].a1;
+                const auto a2 = Modulated ? gains.a2[s][n] : staticGains[s].a2;
+
+                const auto v1 = (a1 * ic1[s]) + (a2 * (x - ic2[s]));
+                const auto nextIc2 = ic2[s] + (twoG * v1);
+                x = (c.m0 * x) + (c.m1 * v1) + (c.m2 * SampleType(0.5) * (ic2[s] + nextIc2));
+                ic1[s] = v1 + v1 - ic1[s];
+                ic2[s] = nextIc2;
+            }
+
+            output[n] = Blend ? (dry * dryGain) + (x * mix) : x;
+        }
+
+        for (int s = 0; s < NumSections; ++s)
+        {
+            groupState[(2 * s) * lanes] = ic1[s];
+            groupState[(2 * s + 1) * lanes] = ic2[s];
+        }
+    }
+
+    //==============================================================================
+    /** Two output samples of a section on silence, starting from (ic1, ic2). */
+    void freeResponse(int section, SampleType ic1, SampleType ic2, SampleType& y0, SampleType& y1) const
+    {
+        const auto& c = sections[section];
+        const auto& gains = staticGains[section];
+        SampleType* outputs[] = { &y0, &y1 };
+
+        for (auto* y : outputs)
+        {
+            const auto v1 = (gains.a1 * ic1) - (gains.a2 * ic2);
+            const auto nextIc2 = ic2 + (gains.twoG * v1);
+            *y = (c.m1 * v1) + (c.m2 * SampleType(0.5) * (ic2 + nextIc2));
+            ic1 = v1 + v1 - ic1;
+            ic2 = nextIc2;
+        }
+    }
+
+    /** ic1 of one channel and section (ic2 is 'lanes' further on), or nullptr. */
+    SampleType* stateFor(int channel, int section)
+    {
+        if (channel < 0 || channel >= numGroups * lanes || section < 0 || section >= numSections)
+            return nullptr;
+
+        return state.data() + (channel / lanes) * maxSections * 2 * lanes + (2 * section) * lanes + channel % lanes;
+    }
+
+    const SampleType* stateFor(int channel, int section) const
+    {
+        return const_cast<StateVariableCascade*>(this)->stateFor(channel, section);
+    }
+
+    static Vector loadLanes(const SampleType* laneState)
+    {
+        alignas(Vector::alignment) SampleType tmp[lanes];
+        std::copy(laneState, laneState + lanes, tmp);
+        return Vector::load(tmp);
+    }
+
+    static void storeLanes(Vector v, SampleType* laneState)
+    {
+        alignas(Vector::alignment) SampleType tmp[lanes];
+        v.store(tmp);
+        std::copy(tmp, tmp + lanes, laneState);
+    }
+
+    static SampleType snapToZero(SampleType value)
+    {
+        return (value < SampleType(-1.0e-8) || value > SampleType(1.0e-8)) ? value : SampleType(0);
+    }
+
+    /** Lowest tuning kept after modulation (keeps g and the 2x2 state map away from zero). */
+    static constexpr SampleType minOmega() { return SampleType(1.0e-5); }
+
+    Coefficients sections[maxSections];
+    Gains staticGains[maxSections];
+    int numSections = 1;
+
+    std::vector<SampleType> state;  ///< ic1 / ic2 per group, section and lane
+    int numGroups = 0;
+};
+
+//==============================================================================
+/** Hands the filter state of one cascade to another cascade with the same
+ *  sections in a different topology (BiquadCascade <-> StateVariableCascade),
+ *  so the destination continues the source's output without a click.
+ *
+ * Both must hold the same designs (the state variable side unmodulated).
+ */
+template <typename SampleType,
+          template <typename> class Source,
+          template <typename> class Destination>
+void transferCascadeState(const Source<SampleType>& source, Destination<SampleType>& destination,
+                          int numChannels)
+{
+    const int numSections = std::min(source.getNumSections(), destination.getNumSections());
+
+    for (int ch = 0; ch < numChannels; ++ch)
+        for (int s = 0; s < numSections; ++s)
+        {
+            SampleType y0, y1;
+            source.getFreeResponse(ch, s, y0, y1);
+            destination.setFreeResponse(ch, s, y0, y1);
+        }
+}
+
+} // namespace DSP
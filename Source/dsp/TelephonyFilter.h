@@ -2,6 +2,10 @@
 
 #include <juce_dsp/juce_dsp.h>
 #include <juce_audio_basics/juce_audio_basics.h>
+#include "ModeChains.h"
+#include "MultirateBand.h"
+#include "../utils/DSPDefines.h"
+#include <array>
 
 //==============================================================================
 /**
@@ -23,17 +27,58 @@
  * - Total bandwidth: ~3100 Hz (narrow for voice)
  * - Stability: Verified across 8 kHz - 192 kHz sample rates
  * 
+ * Multirate mode (optional, off by default):
+ * - Decimates to an 11-12 kHz internal rate with half-band stages, runs the
+ *   two sections there and interpolates back (MultirateBand)
+ * - Adds getLatencySamples() of delay; passband within about 0.4 dB of the
+ *   full-rate path up to 3.4 kHz, everything above ~4.5 kHz removed
+ * 
  * Real-Time Safety: ✅
  * - No allocations in process()
  * - All filter state pre-allocated in prepare()
- * - Thread-safe via JUCE DSP module
+ * - Both sections fused into one pass, channels in SIMD lanes (BiquadCascade)
+ * - Stages declared as a type list (DSP::TelephoneChain, see ModeChains.h)
+ * 
+ * Templated on the sample type (float or double), as are the section designs.
  */
+template <typename SampleType>
 class TelephonyFilter
 {
 public:
     TelephonyFilter() = default;
     ~TelephonyFilter() = default;
 
+    //==============================================================================
+    /** Stage list of this filter (and of DSPChain's Telephone mode). */
+    using Stages = DSP::TelephoneChain;
+
+    /** Designs the two sections (high-pass, then low-pass) for a sample rate.
+     * 
+     * The same designs DSPChain fuses into its own cascades and redesigns
+     * (in place, no allocation) when the Low Cut / High Cut parameters move.
+     * Cutoffs are clamped below 0.45 x sampleRate so the design stays stable
+     * at low (e.g. multirate) rates.
+     */
+    static std::array<DSP::BiquadCoefficients<SampleType>, 2> designSections(double sampleRate,
+                                                                            SampleType lowCutHz = DSP::TELEPHONE_LOW_CUT_HZ,
+                                                                            SampleType highCutHz = DSP::TELEPHONE_HIGH_CUT_HZ)
+    {
+        return Stages::designSections(sampleRate, lowCutHz, highCutHz);
+    }
+
+    /** The same two sections as state-variable (TPT) filters.
+     * 
+     * Used by DSPChain when tuning drift is on: the SVF topology can have its
+     * cutoffs modulated every sample (see DSP::StateVariableCascade).
+     */
+    static std::array<DSP::StateVariableCoefficients<SampleType>, 2> designStateVariableSections(
+        double sampleRate,
+        SampleType lowCutHz = DSP::TELEPHONE_LOW_CUT_HZ,
+        SampleType highCutHz = DSP::TELEPHONE_HIGH_CUT_HZ)
+    {
+        return Stages::designStateVariableSections(sampleRate, lowCutHz, highCutHz);
+    }
+
     //==============================================================================
     /** Initializes filters for the given audio specification.
      * 
@@ -45,48 +90,89 @@ public:
     void prepare(const juce::dsp::ProcessSpec& spec)
     {
         currentSampleRate = spec.sampleRate;
-        
-        // Create high-pass filter at 300 Hz
-        auto highPassCoeffs = juce::dsp::IIR::Coefficients<float>::makeHighPass(
-            spec.sampleRate, 
-            300.0f,   // 300 Hz cutoff
-            1.0f      // Q = 1.0 (gentle slope)
-        );
-        highPassFilter.coefficients = highPassCoeffs;
-        highPassFilter.prepare(spec);
-        
-        // Create low-pass filter at 3400 Hz
-        auto lowPassCoeffs = juce::dsp::IIR::Coefficients<float>::makeLowPass(
-            spec.sampleRate, 
-            3400.0f,  // 3400 Hz cutoff
-            1.0f      // Q = 1.0 (gentle slope)
-        );
-        lowPassFilter.coefficients = lowPassCoeffs;
-        lowPassFilter.prepare(spec);
+
+        Stages::prepare(cascade, static_cast<int>(spec.numChannels), spec.sampleRate,
+                        SampleType(DSP::TELEPHONE_LOW_CUT_HZ), SampleType(DSP::TELEPHONE_HIGH_CUT_HZ));
+
+        // Multirate path: same sections, designed at the decimated rate
+        multirate.prepare(spec.sampleRate, static_cast<int>(spec.maximumBlockSize),
+                          static_cast<int>(spec.numChannels), DSP::MULTIRATE_MIN_INTERNAL_RATE_HZ);
+
+        Stages::prepare(narrowCascade, static_cast<int>(spec.numChannels), multirate.getInternalSampleRate(),
+                        SampleType(DSP::TELEPHONE_LOW_CUT_HZ), SampleType(DSP::TELEPHONE_HIGH_CUT_HZ));
     }
 
+    //==============================================================================
+    /** Switches between full-rate and multirate processing.
+     * 
+     * Both paths are prepared up front, so this is real-time safe. The newly
+     * active path starts from cleared state.
+     */
+    void setMultirateEnabled(bool shouldBeEnabled)
+    {
+        if (shouldBeEnabled == multirateEnabled)
+            return;
+
+        multirateEnabled = shouldBeEnabled;
+        reset();
+    }
+
+    bool isMultirateEnabled() const { return multirateEnabled; }
+
+    /** Processing delay in samples (0 unless multirate is enabled). */
+    int getLatencySamples() const { return multirateEnabled ? multirate.getLatencySamples() : 0; }
+
+    /** Rate the multirate path runs the sections at. */
+    double getInternalSampleRate() const { return multirate.getInternalSampleRate(); }
+
     //==============================================================================
     /** Processes an audio buffer through both filters.
      * 
      * Applies the high-pass filter first (remove low rumble),
-     * then the low-pass filter (remove high sibilance),
+     * then the low-pass filter (remove high sibilance), fused per sample,
      * creating the characteristic narrowband telephone voice effect.
      * 
      * Real-Time Safe: No allocations, only reads/writes to pre-allocated state.
      * 
      * @param buffer The audio buffer to process in-place
      */
-    void process(juce::AudioBuffer<float>& buffer)
+    void process(juce::AudioBuffer<SampleType>& buffer)
     {
-        // Convert AudioBuffer to AudioBlock for DSP processing
-        juce::dsp::AudioBlock<float> audioBlock(buffer);
-        juce::dsp::ProcessContextReplacing<float> context(audioBlock);
-        
-        // Apply high-pass filter first (removes low frequencies)
-        highPassFilter.process(context);
-
-        // Apply low-pass filter second (removes high frequencies)
-        lowPassFilter.process(context);
+        process(buffer, buffer);
+    }
+
+    /** Out-of-place processing (ProcessContextNonReplacing-style).
+     * 
+     * Reads the input and writes the filtered signal straight into output,
+     * leaving the input untouched, so callers that need both the dry and the
+     * wet signal do not have to copy the input first.
+     * 
+     * Real-Time Safe: No allocations, only reads/writes to pre-allocated state.
+     * 
+     * @param input  Source audio (not modified)
+     * @param output Destination for the wet signal (same size as input)
+     */
+    void process(const juce::AudioBuffer<SampleType>& input, juce::AudioBuffer<SampleType>& output)
+    {
+        jassert(input.getNumChannels() == output.getNumChannels());
+        jassert(input.getNumSamples() == output.getNumSamples());
+
+        const int numChannels = juce::jmin(input.getNumChannels(), output.getNumChannels());
+        const int numSamples = juce::jmin(input.getNumSamples(), output.getNumSamples());
+
+        if (multirateEnabled)
+        {
+            multirate.process(input.getArrayOfReadPointers(), output.getArrayOfWritePointers(),
+                              numChannels, numSamples,
+                              [this](SampleType* const* channels, int numNarrowChannels, int numNarrowSamples)
+                              {
+                                  Stages::process(narrowCascade, channels, channels, numNarrowChannels, numNarrowSamples, SampleType(1));
+                              });
+            return;
+        }
+
+        Stages::process(cascade, input.getArrayOfReadPointers(), output.getArrayOfWritePointers(),
+                        numChannels, numSamples, SampleType(1));
     }
 
     //==============================================================================
@@ -101,8 +187,9 @@ public:
      */
     void reset()
     {
-        highPassFilter.reset();
-        lowPassFilter.reset();
+        cascade.reset();
+        narrowCascade.reset();
+        multirate.reset();
     }
 
     //==============================================================================
@@ -110,9 +197,13 @@ public:
     double getSampleRate() const { return currentSampleRate; }
 
 private:
-    // High-pass and low-pass filters for bandpass effect
-    juce::dsp::IIR::Filter<float> highPassFilter;  ///< 300 Hz high-pass
-    juce::dsp::IIR::Filter<float> lowPassFilter;   ///< 3400 Hz low-pass
+    // High-pass (300 Hz) + low-pass (3400 Hz) sections for bandpass effect
+    DSP::BiquadCascade<SampleType> cascade;
+
+    // Multirate path: resampler plus the same sections at the internal rate
+    DSP::MultirateBand<SampleType> multirate;
+    DSP::BiquadCascade<SampleType> narrowCascade;
+    bool multirateEnabled = false;
 
     double currentSampleRate = 44100.0;
 
@@ -0,0 +1,424 @@
+#pragma once
+
+#include "BiquadCoefficients.h"
+#include "ModeChains.h"
+#include "SIMDVector.h"
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+//==============================================================================
+/**
+ * VoiceBatch - Mode filters for many independent mono streams, streams in SIMD lanes
+ *
+ * DSPChain runs one voice with its channels in SIMD lanes; a server colouring
+ * thousands of calls wants the opposite. A VoiceBatch holds a fixed pool of
+ * mono streams, each with its own mode, cutoffs, mix and filter state, and
+ * runs one stream per lane:
+ *
+ *   - All per-stream data is structure-of-arrays by group of
+ *     SIMDVector::size streams: coefficients [group][section][b0..a2][lane],
+ *     state [group][section][z1, z2][lane], mix [stream]. A group's
+ *     coefficients load straight into registers, one vector per value.
+ *   - process() walks the groups; each is transposed in tiles into an
+ *     interleaved [frame][lane] block (as in BiquadCascade) and pushed
+ *     through its sections one register per frame. Groups with no live
+ *     stream are skipped.
+ *   - A group runs as many sections as its longest chain needs, shorter
+ *     chains padded with pass-through sections, so create() places a
+ *     stream next to streams of the same length where it can (see
+ *     takeFreeSlot()). Groups whose live streams all use mix = 1 skip the
+ *     blend.
+ *
+ * Streams come from a pool sized in prepare(): create() takes a free slot,
+ * destroy() returns it. The slot number is the stream's index into the
+ * input/output pointer arrays of process(); only live slots are read or
+ * written.
+ *
+ * Mode filters are the same ModeChainList designs as DSPChain at the full
+ * rate (no multirate band, drift or mode crossfade: a mode change clears
+ * that stream's state).
+ *
+ * Real-Time Safety: ✅ (after prepare())
+ * - create(), destroy(), setSettings() and process() never allocate or lock
+ * - Not thread-safe: one thread at a time per batch (see VoiceEngine for sharding)
+ */
+namespace DSP {
+
+template <typename SampleType>
+class VoiceBatch
+{
+public:
+    using Vector = SIMDVector<SampleType>;
+    using Coefficients = BiquadCoefficients<SampleType>;
+
+    static constexpr int lanes = Vector::size;
+    static constexpr int maxSections = BiquadCascade<SampleType>::maxSections;
+    static constexpr int tileSize = 32;
+
+    /** Everything that tells one stream's colouring apart. */
+    struct Settings
+    {
+        int mode = static_cast<int>(Mode::Telephone);
+        SampleType lowCut = static_cast<SampleType>(TELEPHONE_LOW_CUT_HZ);
+        SampleType highCut = static_cast<SampleType>(TELEPHONE_HIGH_CUT_HZ);
+        SampleType mix = SampleType(1);
+    };
+
+    VoiceBatch() = default;
+
+    //==============================================================================
+    /** Allocates the pool for maxStreams streams (rounded up to whole groups); all of them free. */
+    void prepare(double newSampleRate, int maxStreams)
+    {
+        sampleRate = newSampleRate;
+        numGroups = (std::max(maxStreams, 1) + lanes - 1) / lanes;
+        const auto capacity = static_cast<size_t>(numGroups * lanes);
+
+        coefficients.assign(static_cast<size_t>(numGroups * maxSections * coefficientsPerSection * lanes), SampleType(0));
+        state.assign(static_cast<size_t>(numGroups * maxSections * 2 * lanes), SampleType(0));
+        mixes.assign(capacity, SampleType(1));
+        modes.assign(capacity, 0);
+        sectionCounts.assign(capacity, 0);
+        alive.assign(capacity, 0);
+
+        groupSections.assign(static_cast<size_t>(numGroups), 0);
+        groupBlends.assign(static_cast<size_t>(numGroups), 0);
+
+        // Searched from the back: lowest slots first among equals, so live streams pack into few groups
+        freeSlots.resize(capacity);
+        for (size_t i = 0; i < capacity; ++i)
+            freeSlots[i] = static_cast<int>(capacity - 1 - i);
+
+        for (int slot = 0; slot < getCapacity(); ++slot)
+            setPassThrough(slot);
+
+        numStreams = 0;
+    }
+
+    int getCapacity() const { return numGroups * lanes; }
+    int getNumStreams() const { return numStreams; }
+    double getSampleRate() const { return sampleRate; }
+
+    bool isAlive(int stream) const
+    {
+        return stream >= 0 && stream < getCapacity() && alive[static_cast<size_t>(stream)] != 0;
+    }
+
+    //==============================================================================
+    /** Takes a free slot for a new stream (cleared state); returns it, or -1 if the pool is full. */
+    int create(const Settings& settings)
+    {
+        if (freeSlots.empty())
+            return -1;
+
+        Coefficients sections[maxSections];
+        const int stream = takeFreeSlot(designMode(sampleRate, std::clamp(settings.mode, 0, ModeChainList::size - 1),
+                                                   settings.lowCut, settings.highCut, sections));
+
+        alive[static_cast<size_t>(stream)] = 1;
+        ++numStreams;
+
+        modes[static_cast<size_t>(stream)] = -1;  // Forces the design and clears the state
+        setSettings(stream, settings);
+        return stream;
+    }
+
+    /** Returns a stream's slot to the pool. Unknown or free slots are ignored. */
+    void destroy(int stream)
+    {
+        if (!isAlive(stream))
+            return;
+
+        alive[static_cast<size_t>(stream)] = 0;
+        --numStreams;
+
+        setPassThrough(stream);
+        updateGroup(stream / lanes);
+        freeSlots.push_back(stream);
+    }
+
+    /** Redesigns one stream. Its filter state is kept unless the mode changes. */
+    void setSettings(int stream, const Settings& settings)
+    {
+        if (!isAlive(stream))
+            return;
+
+        const auto index = static_cast<size_t>(stream);
+        const int mode = std::clamp(settings.mode, 0, ModeChainList::size - 1);
+
+        if (mode != modes[index])
+            clearState(stream);
+
+        Coefficients sections[maxSections];
+        const int count = designMode(sampleRate, mode, settings.lowCut, settings.highCut, sections);
+
+        for (int s = 0; s < maxSections; ++s)
+            setSection(stream, s, sections[s]);
+
+        modes[index] = mode;
+        sectionCounts[index] = count;
+        mixes[index] = std::clamp(settings.mix, SampleType(0), SampleType(1));
+        updateGroup(stream / lanes);
+    }
+
+    /** Clears one stream's filter state. */
+    void reset(int stream)
+    {
+        if (isAlive(stream))
+            clearState(stream);
+    }
+
+    /** Designs a mode's chain into sections (maxSections entries, the unused
+     *  ones left as they are) and returns its section count.
+     */
+    static int designMode(double sampleRate, int mode, SampleType lowCut, SampleType highCut, Coefficients* sections)
+    {
+        return designMode(sampleRate, mode, lowCut, highCut, sections,
+                          std::make_index_sequence<static_cast<size_t>(ModeChainList::size)>());
+    }
+
+    //==============================================================================
+    /** Filters numSamples of every live stream.
+     *
+     * input and output are indexed by stream slot (getCapacity() entries);
+     * entries of free slots are never touched and may be null. A stream's
+     * output may alias its own input.
+     */
+    void process(const SampleType* const* input, SampleType* const* output, int numSamples)
+    {
+        for (int group = 0; group < numGroups; ++group)
+        {
+            const bool blend = groupBlends[static_cast<size_t>(group)] != 0;
+
+            switch (groupSections[static_cast<size_t>(group)])
+            {
+                case 0:  break;  // No live stream
+                case 1:  blend ? processGroup<1, true>(group, input, output, numSamples)
+                               : processGroup<1, false>(group, input, output, numSamples); break;
+                case 2:  blend ? processGroup<2, true>(group, input, output, numSamples)
+                               : processGroup<2, false>(group, input, output, numSamples); break;
+                case 3:  blend ? processGroup<3, true>(group, input, output, numSamples)
+                               : processGroup<3, false>(group, input, output, numSamples); break;
+                default: blend ? processGroup<4, true>(group, input, output, numSamples)
+                               : processGroup<4, false>(group, input, output, numSamples); break;
+            }
+        }
+    }
+
+private:
+    //==============================================================================
+    static constexpr int coefficientsPerSection = 5;  ///< b0, b1, b2, a1, a2
+
+    template <int NumSections, bool Blend>
+    void processGroup(int group, const SampleType* const* input, SampleType* const* output, int numSamples)
+    {
+        const int first = group * lanes;
+        const auto* groupCoefficients = coefficients.data() + group * maxSections * coefficientsPerSection * lanes;
+        auto* groupState = state.data() + group * maxSections * 2 * lanes;
+
+        Vector b0[NumSections], b1[NumSections], b2[NumSections], a1[NumSections], a2[NumSections];
+        Vector z1[NumSections], z2[NumSections];
+
+        for (int s = 0; s < NumSections; ++s)
+        {
+            const auto* c = groupCoefficients + s * coefficientsPerSection * lanes;
+            b0[s] = Vector::loadUnaligned(c);
+            b1[s] = Vector::loadUnaligned(c + lanes);
+            b2[s] = Vector::loadUnaligned(c + 2 * lanes);
+            a1[s] = Vector::loadUnaligned(c + 3 * lanes);
+            a2[s] = Vector::loadUnaligned(c + 4 * lanes);
+            z1[s] = Vector::loadUnaligned(groupState + (2 * s) * lanes);
+            z2[s] = Vector::loadUnaligned(groupState + (2 * s + 1) * lanes);
+        }
+
+        const auto wetGain = Vector::loadUnaligned(mixes.data() + first);
+        const auto dryGain = Vector::expand(SampleType(1)) - wetGain;
+
+        // Free lanes are never written, so they stay silent (and their pass-through state zero)
+        alignas(Vector::alignment) SampleType tile[tileSize][lanes] = {};
+
+        for (int start = 0; start < numSamples; start += tileSize)
+        {
+            const int len = std::min(tileSize, numSamples - start);
+
+            for (int l = 0; l < lanes; ++l)
+            {
+                if (alive[static_cast<size_t>(first + l)] == 0)
+                    continue;
+
+                const auto* src = input[first + l] + start;
+                for (int n = 0; n < len; ++n)
+                    tile[n][l] = src[n];
+            }
+
+            for (int n = 0; n < len; ++n)
+            {
+                const auto dry = Vector::load(tile[n]);
+                auto x = dry;
+
+                for (int s = 0; s < NumSections; ++s)
+                {
+                    const auto y = (x * b0[s]) + z1[s];
+                    z1[s] = (x * b1[s]) - (y * a1[s]) + z2[s];
+                    z2[s] = (x * b2[s]) - (y * a2[s]);
+                    x = y;
+                }
+
+                if (Blend)
+                    x = (dry * dryGain) + (x * wetGain);
+
+                x.store(tile[n]);
+            }
+
+            for (int l = 0; l < lanes; ++l)
+            {
+                if (alive[static_cast<size_t>(first + l)] == 0)
+                    continue;
+
+                auto* dst = output[first + l] + start;
+                for (int n = 0; n < len; ++n)
+                    dst[n] = tile[n][l];
+            }
+        }
+
+        for (int s = 0; s < NumSections; ++s)
+        {
+            storeLanes(z1[s], groupState + (2 * s) * lanes);
+            storeLanes(z2[s], groupState + (2 * s + 1) * lanes);
+        }
+    }
+
+    //==============================================================================
+    template <size_t... Index>
+    static int designMode(double sampleRate, int mode, SampleType lowCut, SampleType highCut, Coefficients* sections,
+                          std::index_sequence<Index...>)
+    {
+        int count = 0;
+        ((static_cast<int>(Index) == mode
+              ? (count = designChain<typename ModeChainList::template At<Index>>(sampleRate, lowCut, highCut, sections))
+              : 0), ...);
+        return count;
+    }
+
+    template <typename Chain>
+    static int designChain(double sampleRate, SampleType lowCut, SampleType highCut, Coefficients* sections)
+    {
+        const auto design = Chain::designSections(sampleRate, lowCut, highCut);
+        std::copy(design.begin(), design.end(), sections);
+        return Chain::numSections;
+    }
+
+    /** Removes and returns the free slot that costs least for a chain of numSections:
+     *  in a group already running that many sections, else one running more (the
+     *  lane rides along for free), else an empty group, else the lowest-numbered one.
+     */
+    int takeFreeSlot(int numSections)
+    {
+        int best = static_cast<int>(freeSlots.size()) - 1;
+        int bestScore = -1;
+
+        for (int i = best; i >= 0 && bestScore < 3; --i)
+        {
+            const int running = groupSections[static_cast<size_t>(freeSlots[static_cast<size_t>(i)] / lanes)];
+            const int score = running == numSections ? 3 : running > numSections ? 2 : running == 0 ? 1 : 0;
+
+            if (score > bestScore)
+            {
+                best = i;
+                bestScore = score;
+            }
+        }
+
+        const int slot = freeSlots[static_cast<size_t>(best)];
+        freeSlots[static_cast<size_t>(best)] = freeSlots.back();
+        freeSlots.pop_back();
+        return slot;
+    }
+
+    void setSection(int stream, int section, const Coefficients& c)
+    {
+        const int group = stream / lanes, lane = stream % lanes;
+        auto* values = coefficients.data() + (group * maxSections + section) * coefficientsPerSection * lanes + lane;
+
+        values[0] = c.b0;
+        values[lanes] = c.b1;
+        values[2 * lanes] = c.b2;
+        values[3 * lanes] = c.a1;
+        values[4 * lanes] = c.a2;
+    }
+
+    void setPassThrough(int stream)
+    {
+        for (int s = 0; s < maxSections; ++s)
+            setSection(stream, s, Coefficients());
+
+        clearState(stream);
+        mixes[static_cast<size_t>(stream)] = SampleType(1);
+        sectionCounts[static_cast<size_t>(stream)] = 0;
+        modes[static_cast<size_t>(stream)] = -1;
+    }
+
+    void clearState(int stream)
+    {
+        const int group = stream / lanes, lane = stream % lanes;
+        auto* groupState = state.data() + group * maxSections * 2 * lanes;
+
+        for (int i = 0; i < maxSections * 2; ++i)
+            groupState[i * lanes + lane] = SampleType(0);
+    }
+
+    /** Recomputes a group's section count and whether any live stream blends. */
+    void updateGroup(int group)
+    {
+        int sections = 0;
+        bool blend = false;
+
+        for (int stream = group * lanes; stream < (group + 1) * lanes; ++stream)
+        {
+            const auto index = static_cast<size_t>(stream);
+            if (alive[index] != 0)
+            {
+                sections = std::max(sections, std::max(1, sectionCounts[index]));
+                blend = blend || mixes[index] < SampleType(1);
+            }
+        }
+
+        groupSections[static_cast<size_t>(group)] = sections;
+        groupBlends[static_cast<size_t>(group)] = blend ? 1 : 0;
+    }
+
+    static void storeLanes(Vector v, SampleType* laneState)
+    {
+        alignas(Vector::alignment) SampleType tmp[lanes];
+        v.store(tmp);
+        for (int l = 0; l < lanes; ++l)
+            laneState[l] = snapToZero(tmp[l]);
+    }
+
+    /** Flushes tiny state values so silent input decays to true zero (no denormals). */
+    static SampleType snapToZero(SampleType value)
+    {
+        return (value < SampleType(-1.0e-8) || value > SampleType(1.0e-8)) ? value : SampleType(0);
+    }
+
+    //==============================================================================
+    double sampleRate = 48000.0;
+    int numGroups = 0;
+    int numStreams = 0;
+
+    std::vector<SampleType> coefficients;   ///< [group][section][b0, b1, b2, a1, a2][lane]
+    std::vector<SampleType> state;          ///< [group][section][z1, z2][lane]
+    std::vector<SampleType> mixes;          ///< Per stream slot
+    std::vector<int> modes;                 ///< Per stream slot; -1 while free
+    std::vector<int> sectionCounts;         ///< Sections of the stream's chain
+    std::vector<unsigned char> alive;       ///< Per stream slot
+
+    std::vector<int> groupSections;         ///< Sections the group runs; 0 = nothing live
+    std::vector<unsigned char> groupBlends; ///< Any live stream in the group with mix < 1
+
+    std::vector<int> freeSlots;             ///< Stack of free slots (capacity reserved in prepare())
+};
+
+} // namespace DSP
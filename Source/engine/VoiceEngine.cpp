@@ -0,0 +1,102 @@
+#include "VoiceEngine.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace {
+
+int resolveThreadCount(int requested) {
+    if (requested > 0)
+        return requested;
+
+    return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+} // namespace
+
+//==============================================================================
+VoiceEngine::VoiceEngine(const Options& options)
+    : sampleRate(options.sampleRate),
+      maxStreams(std::max(1, options.maxStreams)),
+      workers(resolveThreadCount(options.numThreads)) {
+    // Enough shards to balance the threads, but never fewer than a SIMD group of streams each
+    constexpr int lanes = DSP::VoiceBatch<float>::lanes;
+    const int maxShards = (maxStreams + lanes - 1) / lanes;
+    const int numShards = std::clamp(workers.getNumThreads() * std::max(1, options.shardsPerThread), 1, maxShards);
+
+    shardCapacity = (maxStreams + numShards - 1) / numShards;
+    shardCapacity = (shardCapacity + lanes - 1) / lanes * lanes;
+
+    shards.reserve(static_cast<size_t>(numShards));
+    for (int i = 0; i < numShards; ++i) {
+        shards.push_back(std::make_unique<Shard>());
+        shards.back()->batch.prepare(sampleRate, shardCapacity);
+    }
+}
+
+//==============================================================================
+int VoiceEngine::createStream(const Settings& settings) {
+    if (numStreams >= maxStreams)
+        return -1;
+
+    // Emptiest shard first (ties go to the lowest index)
+    int target = 0;
+    for (int i = 1; i < static_cast<int>(shards.size()); ++i)
+        if (shards[(size_t) i]->batch.getNumStreams() < shards[(size_t) target]->batch.getNumStreams())
+            target = i;
+
+    const int slot = shards[(size_t) target]->batch.create(settings);
+    if (slot < 0)
+        return -1;
+
+    ++numStreams;
+    return target * shardCapacity + slot;
+}
+
+void VoiceEngine::destroyStream(int id) {
+    int slot = 0;
+    if (auto* shard = findShard(id, slot); shard != nullptr && shard->batch.isAlive(slot)) {
+        shard->batch.destroy(slot);
+        --numStreams;
+    }
+}
+
+void VoiceEngine::setStreamSettings(int id, const Settings& settings) {
+    int slot = 0;
+    if (auto* shard = findShard(id, slot))
+        shard->batch.setSettings(slot, settings);
+}
+
+void VoiceEngine::resetStream(int id) {
+    int slot = 0;
+    if (auto* shard = findShard(id, slot))
+        shard->batch.reset(slot);
+}
+
+bool VoiceEngine::isStreamAlive(int id) const {
+    int slot = 0;
+    const auto* shard = findShard(id, slot);
+    return shard != nullptr && shard->batch.isAlive(slot);
+}
+
+//==============================================================================
+void VoiceEngine::process(const float* const* input, float* const* output, int numSamples) {
+    if (numSamples <= 0 || numStreams == 0)
+        return;
+
+    auto processShard = [&](int index) {
+        auto& batch = shards[(size_t) index]->batch;
+        if (batch.getNumStreams() > 0)
+            batch.process(input + index * shardCapacity, output + index * shardCapacity, numSamples);
+    };
+
+    workers.run(static_cast<int>(shards.size()), processShard);
+}
+
+VoiceEngine::Shard* VoiceEngine::findShard(int id, int& slot) const {
+    if (id < 0 || id >= getCapacity())
+        return nullptr;
+
+    slot = id % shardCapacity;
+    return shards[(size_t) (id / shardCapacity)].get();
+}
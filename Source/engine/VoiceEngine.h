@@ -0,0 +1,83 @@
+#pragma once
+
+#include "../dsp/VoiceBatch.h"
+#include "WorkerPool.h"
+#include <memory>
+#include <vector>
+
+//==============================================================================
+/**
+ * VoiceEngine - Telephone/radio colouring for thousands of mono voice streams
+ *
+ * The headless, server-side counterpart of the plugin: no JUCE, no
+ * per-stream objects. Streams live in shards, each a DSP::VoiceBatch (SoA
+ * state, one stream per SIMD lane), and process() hands the shards to a
+ * WorkerPool so every core filters its own share of the streams.
+ *
+ * Stream ids are shard * getShardCapacity() + slot, so they index the
+ * input/output pointer arrays of process() directly (getCapacity() entries;
+ * only live ids are touched). createStream() puts a new stream in the
+ * emptiest shard, which keeps the shards balanced as calls come and go.
+ * There are several shards per thread so a slow shard does not hold up a
+ * whole run.
+ *
+ * Everything is allocated in the constructor; creating, destroying and
+ * retuning streams and processing allocate nothing. The control calls must
+ * not overlap process(): call them from the thread that drives it, between
+ * blocks.
+ */
+class VoiceEngine {
+public:
+    using Settings = DSP::VoiceBatch<float>::Settings;
+
+    struct Options {
+        double sampleRate = 8000.0;
+        int maxStreams = 4096;
+        int numThreads = 0;         ///< Threads per process(), the caller included; 0 = all cores
+        int shardsPerThread = 4;
+    };
+
+    explicit VoiceEngine(const Options& options);
+
+    //==========================================================================
+    /** Returns the new stream's id, or -1 if maxStreams are already live. */
+    int createStream(const Settings& settings);
+    void destroyStream(int id);
+
+    /** Retunes a stream; its filter state is kept unless the mode changes. */
+    void setStreamSettings(int id, const Settings& settings);
+    void resetStream(int id);
+    bool isStreamAlive(int id) const;
+
+    int getNumStreams() const { return numStreams; }
+    int getMaxStreams() const { return maxStreams; }
+    int getCapacity() const { return static_cast<int>(shards.size()) * shardCapacity; }
+    int getShardCapacity() const { return shardCapacity; }
+    int getNumThreads() const { return workers.getNumThreads(); }
+    double getSampleRate() const { return sampleRate; }
+
+    //==========================================================================
+    /** Filters numSamples of every live stream, in parallel.
+     *
+     * input[id] / output[id] for every id below getCapacity(); entries of ids
+     * that are not live may be null. A stream's output may alias its input.
+     */
+    void process(const float* const* input, float* const* output, int numSamples);
+
+private:
+    //==========================================================================
+    /** One batch per cache line (or more), so threads never share a line of another's state. */
+    struct alignas(64) Shard {
+        DSP::VoiceBatch<float> batch;
+    };
+
+    Shard* findShard(int id, int& slot) const;
+
+    const double sampleRate;
+    const int maxStreams;
+    WorkerPool workers;
+    int shardCapacity = 0;
+    int numStreams = 0;
+
+    std::vector<std::unique_ptr<Shard>> shards;
+};
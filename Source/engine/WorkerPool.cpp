@@ -0,0 +1,76 @@
+#include "WorkerPool.h"
+
+#include <algorithm>
+
+//==============================================================================
+WorkerPool::WorkerPool(int numThreads) {
+    const int poolThreads = std::max(1, numThreads) - 1;
+    threads.reserve(static_cast<size_t>(poolThreads));
+
+    for (int i = 0; i < poolThreads; ++i)
+        threads.emplace_back([this] { threadLoop(); });
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        quitting = true;
+    }
+    wake.notify_all();
+
+    for (auto& thread : threads)
+        thread.join();
+}
+
+//==============================================================================
+void WorkerPool::runTasks(int numTasks, TaskFn taskToRun, void* context) {
+    if (numTasks <= 0)
+        return;
+
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        task = taskToRun;
+        taskContext = context;
+        taskCount = numTasks;
+        nextTask.store(0, std::memory_order_relaxed);
+        busyThreads = static_cast<int>(threads.size());
+        ++generation;
+    }
+    wake.notify_all();
+
+    // The caller works too instead of just waiting
+    drainTasks();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this] { return busyThreads == 0; });
+}
+
+void WorkerPool::drainTasks() {
+    for (int index = nextTask.fetch_add(1, std::memory_order_relaxed); index < taskCount;
+         index = nextTask.fetch_add(1, std::memory_order_relaxed))
+        task(taskContext, index);
+}
+
+void WorkerPool::threadLoop() {
+    unsigned int seenGeneration = 0;
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return quitting || generation != seenGeneration; });
+
+            if (quitting)
+                return;
+
+            seenGeneration = generation;
+        }
+
+        drainTasks();
+
+        {
+            const std::lock_guard<std::mutex> lock(mutex);
+            if (--busyThreads == 0)
+                finished.notify_one();
+        }
+    }
+}
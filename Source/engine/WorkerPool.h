@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//==============================================================================
+/**
+ * WorkerPool - Fixed set of threads running numbered tasks in parallel
+ *
+ * run(numTasks, fn) calls fn(task) for every task in 0..numTasks-1, spread
+ * over the pool's threads and the calling thread, and returns once all of
+ * them are done. Tasks are claimed through an atomic index (as in the batch
+ * renderer's queue), so uneven tasks balance out; nothing is allocated per
+ * run. Threads sleep on a condition variable between runs.
+ *
+ * One run at a time: run() is not re-entrant and must be called from one
+ * thread (the one driving the engine).
+ */
+class WorkerPool {
+public:
+    /** numThreads counts the caller, so 1 means "run everything on the calling thread". */
+    explicit WorkerPool(int numThreads);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /** Threads taking part in a run, the caller included. */
+    int getNumThreads() const { return static_cast<int>(threads.size()) + 1; }
+
+    template <typename Fn>
+    void run(int numTasks, Fn& fn) {
+        runTasks(numTasks, [](void* context, int task) { (*static_cast<Fn*>(context))(task); }, &fn);
+    }
+
+private:
+    using TaskFn = void (*)(void*, int);
+
+    void runTasks(int numTasks, TaskFn taskToRun, void* context);
+    void drainTasks();
+    void threadLoop();
+
+    std::vector<std::thread> threads;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    unsigned int generation = 0;    ///< Bumped per run; threads wake when it moves
+    int busyThreads = 0;            ///< Pool threads still inside the current run
+    bool quitting = false;
+
+    // The current run (written under the mutex before the threads are woken)
+    TaskFn task = nullptr;
+    void* taskContext = nullptr;
+    int taskCount = 0;
+    std::atomic<int> nextTask { 0 };
+};
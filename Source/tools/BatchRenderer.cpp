@@ -0,0 +1,326 @@
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_core/juce_core.h>
+#include "../dsp/DSPChain.h"
+#include "../utils/DSPDefines.h"
+
+#include <atomic>
+#include <iostream>
+#include <vector>
+
+//==============================================================================
+/**
+ * paranoidFilteroidRender - Headless offline batch renderer
+ *
+ * Runs WAV/AIFF files through DSPChain without a host. Files are streamed
+ * in fixed-size blocks (never loaded whole) and spread across a pool of
+ * worker threads, each of which owns its own DSPChain instance.
+ *
+ * Usage:
+ *   paranoidFilteroidRender [options] <file|directory>...
+ *
+ * Options:
+ *   --mode=<name|index>                    Filter mode: telephone, radio, custom,
+ *                                          ulaw or alaw (or 0, 1, 2, 4, 5;
+ *                                          default: telephone)
+ *   --mix=<0..1>                           Wet/dry blend (default: 1.0)
+ *   --block=<samples>                      Streaming block size (default: 512)
+ *   --jobs=<n>                             Worker threads (default: all cores)
+ *   --out=<directory>                      Output directory (default: next to
+ *                                          each input, with a "_pf" suffix)
+ */
+namespace {
+
+struct RenderSettings {
+    int mode = static_cast<int>(DSP::Mode::Telephone);
+    float mix = 1.0f;
+    int blockSize = 512;
+    int numJobs = 1;
+};
+
+struct RenderJob {
+    juce::File input;
+    juce::File output;
+};
+
+struct RenderResult {
+    bool ok = false;
+    juce::String error;
+    double audioSeconds = 0.0;
+    double wallSeconds = 0.0;
+};
+
+//==============================================================================
+/** Shared work list. Workers claim jobs through an atomic index and write
+ *  their result into the slot matching the job, so no locking is needed
+ *  apart from console output.
+ */
+class RenderQueue {
+public:
+    explicit RenderQueue(std::vector<RenderJob> jobsToRun)
+        : jobs(std::move(jobsToRun)), results(jobs.size()) {}
+
+    /** Returns the index of the next unclaimed job, or -1 when done. */
+    int claimNext() {
+        const int index = nextIndex.fetch_add(1);
+        return index < static_cast<int>(jobs.size()) ? index : -1;
+    }
+
+    const RenderJob& getJob(int index) const { return jobs[(size_t) index]; }
+    RenderResult& getResult(int index) { return results[(size_t) index]; }
+    int size() const { return static_cast<int>(jobs.size()); }
+
+    juce::CriticalSection outputLock;
+
+private:
+    std::vector<RenderJob> jobs;
+    std::vector<RenderResult> results;
+    std::atomic<int> nextIndex { 0 };
+};
+
+//==============================================================================
+/** One worker thread with its own DSPChain and format manager. */
+class RenderWorker : public juce::Thread {
+public:
+    RenderWorker(RenderQueue& q, const RenderSettings& s, int workerIndex)
+        : juce::Thread("Render worker " + juce::String(workerIndex)),
+          queue(q), settings(s) {
+        formatManager.registerBasicFormats();
+    }
+
+    ~RenderWorker() override {
+        stopThread(-1);
+    }
+
+    void run() override {
+        juce::ScopedNoDenormals noDenormals;
+
+        for (int index = queue.claimNext(); index >= 0 && ! threadShouldExit();
+             index = queue.claimNext()) {
+            const auto& job = queue.getJob(index);
+            auto& result = queue.getResult(index);
+
+            const double startMs = juce::Time::getMillisecondCounterHiRes();
+            result.error = renderFile(job, result.audioSeconds);
+            result.wallSeconds = (juce::Time::getMillisecondCounterHiRes() - startMs) * 0.001;
+            result.ok = result.error.isEmpty();
+
+            const juce::ScopedLock sl(queue.outputLock);
+            if (result.ok) {
+                std::cout << job.input.getFullPathName() << "  "
+                          << juce::String(result.audioSeconds, 2) << " s audio in "
+                          << juce::String(result.wallSeconds, 3) << " s  ("
+                          << juce::String(result.audioSeconds / juce::jmax(result.wallSeconds, 1.0e-9), 1)
+                          << "x realtime)" << std::endl;
+            } else {
+                std::cerr << job.input.getFullPathName() << "  FAILED: " << result.error << std::endl;
+            }
+        }
+    }
+
+private:
+    /** Streams one file through the chain. Returns an error string, or empty on success. */
+    juce::String renderFile(const RenderJob& job, double& audioSeconds) {
+        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(job.input));
+        if (reader == nullptr)
+            return "unsupported or unreadable audio file";
+
+        auto* format = formatManager.findFormatForFileExtension(job.output.getFileExtension());
+        if (format == nullptr)
+            return "no writer for extension " + job.output.getFileExtension();
+
+        const int numChannels = static_cast<int>(reader->numChannels);
+        const double sampleRate = reader->sampleRate;
+        if (numChannels <= 0 || sampleRate <= 0.0)
+            return "invalid channel count or sample rate";
+
+        int bitsPerSample = static_cast<int>(reader->bitsPerSample);
+        if (! format->getPossibleBitDepths().contains(bitsPerSample))
+            bitsPerSample = 24;
+
+        if (! job.output.getParentDirectory().createDirectory())
+            return "cannot create " + job.output.getParentDirectory().getFullPathName();
+
+        job.output.deleteFile();
+        std::unique_ptr<juce::FileOutputStream> stream(job.output.createOutputStream());
+        if (stream == nullptr)
+            return "cannot open " + job.output.getFullPathName() + " for writing";
+
+        std::unique_ptr<juce::AudioFormatWriter> writer(format->createWriterFor(
+            stream.get(), sampleRate, static_cast<unsigned int>(numChannels),
+            bitsPerSample, reader->metadataValues, 0));
+        if (writer == nullptr)
+            return "cannot create writer for " + job.output.getFullPathName();
+        stream.release();  // Writer owns the stream now
+
+        // Re-prepare per file: sample rate and channel count may differ
+        juce::dsp::ProcessSpec spec;
+        spec.sampleRate = sampleRate;
+        spec.maximumBlockSize = static_cast<juce::uint32>(settings.blockSize);
+        spec.numChannels = static_cast<juce::uint32>(numChannels);
+        dspChain.prepare(spec);
+        dspChain.reset();
+
+        buffer.setSize(numChannels, settings.blockSize, false, false, true);
+
+        for (juce::int64 pos = 0; pos < reader->lengthInSamples; pos += settings.blockSize) {
+            const int numSamples = static_cast<int>(
+                juce::jmin<juce::int64>(settings.blockSize, reader->lengthInSamples - pos));
+
+            buffer.setSize(numChannels, numSamples, false, false, true);
+            if (! reader->read(&buffer, 0, numSamples, pos, true, true))
+                return "read error at sample " + juce::String(pos);
+
+            dspChain.processBlock(buffer, settings.mode, settings.mix);
+
+            if (! writer->writeFromAudioSampleBuffer(buffer, 0, numSamples))
+                return "write error at sample " + juce::String(pos);
+        }
+
+        audioSeconds = static_cast<double>(reader->lengthInSamples) / sampleRate;
+        return {};
+    }
+
+    RenderQueue& queue;
+    const RenderSettings& settings;
+
+    juce::AudioFormatManager formatManager;
+    juce::AudioBuffer<float> buffer;
+    DSPChain<float> dspChain;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RenderWorker)
+};
+
+//==============================================================================
+int parseMode(const juce::String& text) {
+    const auto t = text.trim().toLowerCase();
+    if (t == "radio" || t == "1")  return static_cast<int>(DSP::Mode::Radio);
+    if (t == "custom" || t == "2") return static_cast<int>(DSP::Mode::Custom);
+    if (t == "telephone" || t == "0") return static_cast<int>(DSP::Mode::Telephone);
+    if (t == "ulaw" || t == "mulaw" || t == "4") return static_cast<int>(DSP::Mode::MuLaw);
+    if (t == "alaw" || t == "5")   return static_cast<int>(DSP::Mode::ALaw);
+    return -1;
+}
+
+bool isAudioFile(const juce::File& f) {
+    return f.hasFileExtension("wav;aif;aiff");
+}
+
+/** Builds input/output pairs. Directory inputs keep their relative layout under --out. */
+std::vector<RenderJob> collectJobs(const juce::ArgumentList& args, const juce::File& outDir) {
+    std::vector<RenderJob> jobs;
+
+    auto addJob = [&](const juce::File& input, const juce::File& root) {
+        RenderJob job;
+        job.input = input;
+
+        if (outDir == juce::File()) {
+            job.output = input.getSiblingFile(input.getFileNameWithoutExtension() + "_pf"
+                                              + input.getFileExtension());
+        } else {
+            job.output = outDir.getChildFile(root == juce::File() ? input.getFileName()
+                                                                  : input.getRelativePathFrom(root));
+        }
+        jobs.push_back(job);
+    };
+
+    for (const auto& arg : args.arguments) {
+        if (arg.isOption())
+            continue;
+
+        const auto file = arg.resolveAsFile();
+        if (file.isDirectory()) {
+            for (const auto& child : file.findChildFiles(juce::File::findFiles, true, "*.wav;*.aif;*.aiff"))
+                addJob(child, file);
+        } else if (file.existsAsFile() && isAudioFile(file)) {
+            addJob(file, {});
+        } else {
+            std::cerr << "Skipping " << arg.text << " (not a WAV/AIFF file or directory)" << std::endl;
+        }
+    }
+
+    return jobs;
+}
+
+void printUsage() {
+    std::cout << "Usage: paranoidFilteroidRender [options] <file|directory>...\n"
+                 "  --mode=<name|index>                    Filter mode: telephone, radio, custom, ulaw or alaw\n"
+                 "                                         (or 0, 1, 2, 4, 5; default: telephone)\n"
+                 "  --mix=<0..1>                           Wet/dry blend (default: 1.0)\n"
+                 "  --block=<samples>                      Streaming block size (default: 512)\n"
+                 "  --jobs=<n>                             Worker threads (default: all cores)\n"
+                 "  --out=<directory>                      Output directory (default: <name>_pf next to input)\n";
+}
+
+} // namespace
+
+//==============================================================================
+int main(int argc, char* argv[]) {
+    juce::ArgumentList args(argc, argv);
+
+    if (args.size() == 0 || args.containsOption("--help|-h")) {
+        printUsage();
+        return 0;
+    }
+
+    RenderSettings settings;
+    settings.numJobs = juce::SystemStats::getNumCpus();
+
+    if (args.containsOption("--mode")) {
+        settings.mode = parseMode(args.getValueForOption("--mode"));
+        if (settings.mode < 0) {
+            std::cerr << "Unknown mode: " << args.getValueForOption("--mode") << std::endl;
+            return 1;
+        }
+    }
+    if (args.containsOption("--mix"))
+        settings.mix = juce::jlimit(0.0f, 1.0f, args.getValueForOption("--mix").getFloatValue());
+    if (args.containsOption("--block"))
+        settings.blockSize = juce::jlimit(16, 65536, args.getValueForOption("--block").getIntValue());
+    if (args.containsOption("--jobs"))
+        settings.numJobs = juce::jmax(1, args.getValueForOption("--jobs").getIntValue());
+
+    const juce::File outDir = args.containsOption("--out")
+                                  ? args.getFileForOption("--out")
+                                  : juce::File();
+
+    RenderQueue queue(collectJobs(args, outDir));
+    if (queue.size() == 0) {
+        std::cerr << "No input files." << std::endl;
+        return 1;
+    }
+
+    const int numWorkers = juce::jmin(settings.numJobs, queue.size());
+    std::cout << "Rendering " << queue.size() << " file(s) on " << numWorkers
+              << " worker(s), mode " << settings.mode << ", mix " << settings.mix
+              << ", block " << settings.blockSize << std::endl;
+
+    const double startMs = juce::Time::getMillisecondCounterHiRes();
+
+    juce::OwnedArray<RenderWorker> workers;
+    for (int i = 0; i < numWorkers; ++i)
+        workers.add(new RenderWorker(queue, settings, i))->startThread();
+
+    for (auto* worker : workers)
+        worker->waitForThreadToExit(-1);
+
+    const double elapsedSeconds = (juce::Time::getMillisecondCounterHiRes() - startMs) * 0.001;
+
+    // Aggregate throughput: total audio rendered per second of wall-clock time
+    double totalAudioSeconds = 0.0;
+    int numFailed = 0;
+    for (int i = 0; i < queue.size(); ++i) {
+        const auto& result = queue.getResult(i);
+        totalAudioSeconds += result.audioSeconds;
+        numFailed += result.ok ? 0 : 1;
+    }
+
+    std::cout << "Done: " << (queue.size() - numFailed) << " ok, " << numFailed << " failed, "
+              << juce::String(totalAudioSeconds, 2) << " s audio in "
+              << juce::String(elapsedSeconds, 3) << " s  ("
+              << juce::String(totalAudioSeconds / juce::jmax(elapsedSeconds, 1.0e-9), 1)
+              << "x realtime aggregate, "
+              << juce::String(totalAudioSeconds / juce::jmax(elapsedSeconds * numWorkers, 1.0e-9), 1)
+              << "x per worker)" << std::endl;
+
+    return numFailed == 0 ? 0 : 1;
+}
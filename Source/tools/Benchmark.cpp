@@ -0,0 +1,947 @@
+#include "BenchmarkHarness.h"
+#include "../dsp/DSPChain.h"
+#include "../dsp/TelephonyFilter.h"
+#include "../dsp/RadioFilter.h"
+#include "../dsp/BiquadCascade.h"
+#include "../dsp/StateVariableCascade.h"
+#include "../dsp/DriftModulator.h"
+#include "../dsp/Saturation.h"
+#include "../dsp/NoiseGenerator.h"
+#include "../dsp/PartitionedConvolver.h"
+#include "../dsp/Codec.h"
+#include "../dsp/OutputStage.h"
+
+//==============================================================================
+/**
+ * paranoidFilteroidBench - DSP microbenchmarks
+ *
+ * Usage:
+ *   paranoidFilteroidBench [--suite=<name>[,<name>...]] [--quick] [--time=<seconds>]
+ *   paranoidFilteroidBench --null-test
+ *   paranoidFilteroidBench --convolution-test
+ *
+ * Prints CSV (see BenchmarkHarness.h) to stdout so runs can be diffed or
+ * loaded into a spreadsheet to catch regressions between builds.
+ * --null-test instead compares the multirate telephone path against the
+ * full-rate one (per-frequency gain and residual after latency alignment).
+ * --convolution-test checks the IR mode's convolver against direct
+ * convolution (error, latency) and reports its mean and worst block time.
+ * Build in Release: Debug numbers are meaningless.
+ */
+namespace {
+
+juce::dsp::ProcessSpec makeSpec(const Bench::Config& config) {
+    juce::dsp::ProcessSpec spec;
+    spec.sampleRate = config.sampleRate;
+    spec.maximumBlockSize = static_cast<juce::uint32>(config.blockSize);
+    spec.numChannels = static_cast<juce::uint32>(config.numChannels);
+    return spec;
+}
+
+//==============================================================================
+/** DSPChain::processBlock over every mode, mix, block size, rate and channel count. */
+void benchDSPChain(Bench::Runner& runner) {
+    for (int mode : { 0, 1, 2 })
+        for (float mix : { 0.0f, 0.5f, 1.0f })
+            for (double sampleRate : runner.sampleRates())
+                for (int blockSize : runner.blockSizes())
+                    for (int numChannels : runner.channelCounts()) {
+                        Bench::Config config { "chain", "mode=" + juce::String(mode) + ";mix=" + juce::String(mix, 1),
+                                               sampleRate, blockSize, numChannels };
+                        DSPChain<float> chain;
+                        chain.prepare(makeSpec(config));
+
+                        runner.run(config, [&](juce::AudioBuffer<float>& block) {
+                            chain.processBlock(block, mode, mix);
+                        });
+                    }
+}
+
+/** TelephonyFilter::process on its own. */
+void benchTelephonyFilter(Bench::Runner& runner) {
+    for (double sampleRate : runner.sampleRates())
+        for (int blockSize : runner.blockSizes())
+            for (int numChannels : runner.channelCounts()) {
+                Bench::Config config { "telephony", "process", sampleRate, blockSize, numChannels };
+                TelephonyFilter<float> filter;
+                filter.prepare(makeSpec(config));
+
+                runner.run(config, [&](juce::AudioBuffer<float>& block) {
+                    filter.process(block);
+                });
+            }
+}
+
+/** RadioFilter::process on its own. */
+void benchRadioFilter(Bench::Runner& runner) {
+    for (double sampleRate : runner.sampleRates())
+        for (int blockSize : runner.blockSizes())
+            for (int numChannels : runner.channelCounts()) {
+                Bench::Config config { "radio", "process", sampleRate, blockSize, numChannels };
+                RadioFilter<float> filter;
+                filter.prepare(makeSpec(config));
+
+                runner.run(config, [&](juce::AudioBuffer<float>& block) {
+                    filter.process(block);
+                });
+            }
+}
+
+/** One peaking biquad: scalar juce::dsp::IIR::Filter per channel vs a 1-section BiquadCascade in lanes. */
+void benchBiquadEngines(Bench::Runner& runner) {
+    using JuceBiquad = juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>,
+                                                      juce::dsp::IIR::Coefficients<float>>;
+
+    for (double sampleRate : runner.sampleRates())
+        for (int blockSize : runner.blockSizes())
+            for (int numChannels : runner.channelCounts()) {
+                Bench::Config juceConfig { "biquad", "juce-iir", sampleRate, blockSize, numChannels };
+                JuceBiquad juceFilter;
+                *juceFilter.state = *juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, 3500.0f, 2.0f, 2.0f);
+                juceFilter.prepare(makeSpec(juceConfig));
+
+                runner.run(juceConfig, [&](juce::AudioBuffer<float>& block) {
+                    juce::dsp::AudioBlock<float> audioBlock(block);
+                    juceFilter.process(juce::dsp::ProcessContextReplacing<float>(audioBlock));
+                });
+
+                Bench::Config simdConfig { "biquad", "simd-lanes", sampleRate, blockSize, numChannels };
+                const auto peak = DSP::BiquadCoefficients<float>::makePeak(sampleRate, 3500.0f, 2.0f, 2.0f);
+                DSP::BiquadCascade<float> engine;
+                engine.setSections(&peak, 1);
+                engine.prepare(numChannels);
+
+                runner.run(simdConfig, [&](juce::AudioBuffer<float>& block) {
+                    engine.process(block.getArrayOfWritePointers(), block.getNumChannels(), block.getNumSamples());
+                });
+            }
+}
+
+/** TelephonyFilter at the full host rate vs the multirate path. */
+void benchMultirate(Bench::Runner& runner) {
+    for (bool multirate : { false, true })
+        for (double sampleRate : runner.sampleRates())
+            for (int blockSize : runner.blockSizes())
+                for (int numChannels : runner.channelCounts()) {
+                    Bench::Config config { "multirate", multirate ? "multirate" : "full-rate",
+                                           sampleRate, blockSize, numChannels };
+                    TelephonyFilter<float> filter;
+                    filter.prepare(makeSpec(config));
+                    filter.setMultirateEnabled(multirate);
+
+                    runner.run(config, [&](juce::AudioBuffer<float>& block) {
+                        filter.process(block);
+                    });
+                }
+}
+
+/** DSPChain in Telephone mode with fixed cutoffs vs cutoffs moving every block. */
+void benchCutoffAutomation(Bench::Runner& runner) {
+    for (bool multirate : { false, true })
+        for (bool sweeping : { false, true })
+            for (double sampleRate : runner.sampleRates())
+                for (int blockSize : runner.blockSizes())
+                    for (int numChannels : runner.channelCounts()) {
+                        Bench::Config config { "automation",
+                                               juce::String(sweeping ? "sweep" : "static") + (multirate ? ";multirate" : ""),
+                                               sampleRate, blockSize, numChannels };
+                        DSPChain<float> chain;
+                        chain.prepare(makeSpec(config));
+                        chain.setMultirateEnabled(multirate);
+
+                        // Slow triangle through the whole Low Cut range, High Cut mirrored
+                        float position = 0.0f, step = 0.01f;
+
+                        runner.run(config, [&](juce::AudioBuffer<float>& block) {
+                            if (sweeping) {
+                                if (position + step > 1.0f || position + step < 0.0f)
+                                    step = -step;
+                                position += step;
+                                chain.setCutoffs(100.0f + 900.0f * position, 8000.0f - 6000.0f * position);
+                            }
+                            chain.processBlock(block, 0, 1.0f);
+                        });
+                    }
+}
+
+/** Telephone sections four ways: static biquads, static SVF, SVF with per-sample
+ *  drift (modulator included), and biquads redesigned every sample for comparison. */
+void benchDriftKernels(Bench::Runner& runner) {
+    for (double sampleRate : runner.sampleRates())
+        for (int blockSize : runner.blockSizes())
+            for (int numChannels : runner.channelCounts()) {
+                const auto biquads = TelephonyFilter<float>::designSections(sampleRate);
+                const auto svfs = TelephonyFilter<float>::designStateVariableSections(sampleRate);
+                std::vector<float> scale(static_cast<size_t>(blockSize), 1.0f);
+
+                DSP::DriftModulator<float> drift;
+                drift.prepare(sampleRate);
+                drift.setParameters(0.5f * DSP::DRIFT_MAX_DEPTH_OCTAVES, 3.0f);
+                drift.reset();
+
+                DSP::BiquadCascade<float> biquad;
+                biquad.setSections(biquads.data(), 2);
+                biquad.prepare(numChannels);
+
+                runner.run({ "drift", "biquad-static", sampleRate, blockSize, numChannels },
+                           [&](juce::AudioBuffer<float>& block) {
+                    biquad.process(block.getArrayOfWritePointers(), block.getNumChannels(), block.getNumSamples());
+                });
+
+                DSP::StateVariableCascade<float> svf;
+                svf.setSections(svfs.data(), 2);
+                svf.prepare(numChannels);
+
+                runner.run({ "drift", "svf-static", sampleRate, blockSize, numChannels },
+                           [&](juce::AudioBuffer<float>& block) {
+                    svf.process(block.getArrayOfWritePointers(), block.getNumChannels(), block.getNumSamples());
+                });
+
+                runner.run({ "drift", "svf-modulated", sampleRate, blockSize, numChannels },
+                           [&](juce::AudioBuffer<float>& block) {
+                    drift.render(scale.data(), block.getNumSamples());
+                    svf.process(block.getArrayOfWritePointers(), block.getNumChannels(), block.getNumSamples(),
+                                1.0f, scale.data());
+                });
+
+                // What per-sample modulation would cost without the SVF: full redesign + 1-sample blocks
+                std::vector<float*> frame(static_cast<size_t>(numChannels));
+                runner.run({ "drift", "biquad-redesigned", sampleRate, blockSize, numChannels },
+                           [&](juce::AudioBuffer<float>& block) {
+                    drift.render(scale.data(), block.getNumSamples());
+                    for (int n = 0; n < block.getNumSamples(); ++n) {
+                        const auto sections = TelephonyFilter<float>::designSections(sampleRate,
+                                                                              DSP::TELEPHONE_LOW_CUT_HZ * scale[(size_t) n],
+                                                                              DSP::TELEPHONE_HIGH_CUT_HZ * scale[(size_t) n]);
+                        biquad.setCoefficients(0, sections[0]);
+                        biquad.setCoefficients(1, sections[1]);
+
+                        for (int ch = 0; ch < block.getNumChannels(); ++ch)
+                            frame[(size_t) ch] = block.getWritePointer(ch, n);
+                        biquad.process(frame.data(), block.getNumChannels(), 1);
+                    }
+                });
+            }
+}
+
+/** DSPChain in every mode with drift off vs on. */
+void benchDSPChainDrift(Bench::Runner& runner) {
+    for (int mode : { 0, 1, 2 })
+        for (float amount : { 0.0f, 0.5f })
+            for (double sampleRate : runner.sampleRates())
+                for (int blockSize : runner.blockSizes())
+                    for (int numChannels : runner.channelCounts()) {
+                        Bench::Config config { "chain-drift", "mode=" + juce::String(mode) + ";drift=" + juce::String(amount, 1),
+                                               sampleRate, blockSize, numChannels };
+                        DSPChain<float> chain;
+                        chain.setDrift(amount, 3.0f);
+                        chain.prepare(makeSpec(config));
+
+                        runner.run(config, [&](juce::AudioBuffer<float>& block) {
+                            chain.processBlock(block, mode, 1.0f);
+                        });
+                    }
+}
+
+/** DSPChain with a fixed mode vs a mode change every block (a crossfade always
+ *  running: the worst case a transition can cost), full-rate and multirate. */
+void benchModeSwitch(Bench::Runner& runner) {
+    for (bool multirate : { false, true })
+        for (bool switching : { false, true })
+            for (double sampleRate : runner.sampleRates())
+                for (int blockSize : runner.blockSizes())
+                    for (int numChannels : runner.channelCounts()) {
+                        Bench::Config config { "mode-switch",
+                                               juce::String(switching ? "switching" : "steady") + (multirate ? ";multirate" : ""),
+                                               sampleRate, blockSize, numChannels };
+                        DSPChain<float> chain;
+                        chain.prepare(makeSpec(config));
+                        chain.setMultirateEnabled(multirate);
+
+                        // Telephone <-> Radio <-> Custom in turn
+                        int mode = 0;
+
+                        runner.run(config, [&](juce::AudioBuffer<float>& block) {
+                            if (switching)
+                                mode = (mode + 1) % 3;
+                            chain.processBlock(block, mode, 1.0f);
+                        });
+                    }
+}
+
+/** DSPChain on noise, on digital silence (asleep once the tail has died out)
+ *  and on a voice-like pattern: 0.5 s of signal, then 2 s of silence. */
+void benchSilence(Bench::Runner& runner) {
+    for (const char* input : { "signal", "silence", "intermittent" })
+        for (double sampleRate : runner.sampleRates())
+            for (int blockSize : runner.blockSizes())
+                for (int numChannels : runner.channelCounts()) {
+                    Bench::Config config { "silence", input, sampleRate, blockSize, numChannels };
+                    DSPChain<float> chain;
+                    chain.prepare(makeSpec(config));
+
+                    const juce::String pattern(input);
+                    const auto periodSamples = static_cast<juce::int64>(2.5 * sampleRate);
+                    const auto signalSamples = static_cast<juce::int64>(0.5 * sampleRate);
+                    juce::int64 position = 0;
+
+                    runner.run(config, [&](juce::AudioBuffer<float>& block) {
+                        const bool silent = pattern == "silence"
+                                            || (pattern == "intermittent" && position % periodSamples >= signalSamples);
+                        position += block.getNumSamples();
+
+                        if (silent)
+                            block.clear();
+                        chain.processBlock(block, 0, 1.0f);
+                    });
+                }
+}
+
+/** The same work in float and in double: DSPChain per mode (static and drifting)
+ *  and the bare Telephone biquads. Both precisions run SIMD lanes (half as
+ *  many per register in double). */
+void benchPrecision(Bench::Runner& runner) {
+    for (double sampleRate : runner.sampleRates())
+        for (int blockSize : runner.blockSizes())
+            for (int numChannels : runner.channelCounts()) {
+                const Bench::Config base { "precision", "", sampleRate, blockSize, numChannels };
+
+                for (int mode : { 0, 1, 2 })
+                    for (float amount : { 0.0f, 0.5f }) {
+                        const auto variant = "mode=" + juce::String(mode) + ";drift=" + juce::String(amount, 1);
+
+                        auto config = base;
+                        config.variant = "float;" + variant;
+                        DSPChain<float> floatChain;
+                        floatChain.setDrift(amount, 3.0f);
+                        floatChain.prepare(makeSpec(config));
+                        runner.run(config, [&](juce::AudioBuffer<float>& block) {
+                            floatChain.processBlock(block, mode, 1.0f);
+                        });
+
+                        config.variant = "double;" + variant;
+                        DSPChain<double> doubleChain;
+                        doubleChain.setDrift(amount, 3.0f);
+                        doubleChain.prepare(makeSpec(config));
+                        runner.run<double>(config, [&](juce::AudioBuffer<double>& block) {
+                            doubleChain.processBlock(block, mode, 1.0f);
+                        });
+                    }
+
+                DSP::BiquadCascade<float> floatBiquads;
+                const auto floatSections = TelephonyFilter<float>::designSections(sampleRate);
+                floatBiquads.setSections(floatSections.data(), 2);
+                floatBiquads.prepare(numChannels);
+
+                auto config = base;
+                config.variant = "float;biquads";
+                runner.run(config, [&](juce::AudioBuffer<float>& block) {
+                    floatBiquads.process(block.getArrayOfWritePointers(), block.getNumChannels(), block.getNumSamples());
+                });
+
+                DSP::BiquadCascade<double> doubleBiquads;
+                const auto doubleSections = TelephonyFilter<double>::designSections(sampleRate);
+                doubleBiquads.setSections(doubleSections.data(), 2);
+                doubleBiquads.prepare(numChannels);
+
+                config.variant = "double;biquads";
+                runner.run<double>(config, [&](juce::AudioBuffer<double>& block) {
+                    doubleBiquads.process(block.getArrayOfWritePointers(), block.getNumChannels(), block.getNumSamples());
+                });
+            }
+}
+
+/** One mode's stage list through the cascade, section count picked at run time
+ *  (switch per block) vs fixed at compile time by its Chain type. */
+template <typename Stages>
+void benchChainKernel(Bench::Runner& runner, const char* name) {
+    for (double sampleRate : runner.sampleRates())
+        for (int blockSize : runner.blockSizes())
+            for (int numChannels : runner.channelCounts()) {
+                DSP::BiquadCascade<float> cascade;
+                Stages::prepare(cascade, numChannels, sampleRate, DSP::TELEPHONE_LOW_CUT_HZ, DSP::TELEPHONE_HIGH_CUT_HZ);
+
+                runner.run({ "chain-dispatch", juce::String(name) + ";runtime", sampleRate, blockSize, numChannels },
+                           [&](juce::AudioBuffer<float>& block) {
+                               cascade.process(block.getArrayOfWritePointers(), block.getNumChannels(), block.getNumSamples());
+                           });
+
+                runner.run({ "chain-dispatch", juce::String(name) + ";compile-time", sampleRate, blockSize, numChannels },
+                           [&](juce::AudioBuffer<float>& block) {
+                               Stages::process(cascade, block.getArrayOfReadPointers(), block.getArrayOfWritePointers(),
+                                               block.getNumChannels(), block.getNumSamples(), 1.0f);
+                           });
+            }
+}
+
+void benchChainDispatch(Bench::Runner& runner) {
+    benchChainKernel<DSP::TelephoneChain>(runner, "telephone");
+    benchChainKernel<DSP::RadioChain>(runner, "radio");
+    benchChainKernel<DSP::CustomChain>(runner, "custom");
+}
+
+/** DSPChain on immersive channel counts (stereo, 5.1, 7.1.4), each channel
+ *  filtered on its own vs Force Mono (summed once, filtered once, fanned out). */
+void benchForceMono(Bench::Runner& runner) {
+    for (double sampleRate : runner.sampleRates())
+        for (int blockSize : runner.blockSizes())
+            for (int numChannels : { 2, 6, 12 })
+                for (bool forceMono : { false, true }) {
+                    Bench::Config config { "force-mono", forceMono ? "mono" : "per-channel",
+                                           sampleRate, blockSize, numChannels };
+                    DSPChain<float> chain;
+                    chain.setForceMono(forceMono);
+                    chain.prepare(makeSpec(config));
+
+                    runner.run(config, [&](juce::AudioBuffer<float>& block) {
+                        chain.processBlock(block, 0, 1.0f);
+                    });
+                }
+}
+
+/** The saturation stage on its own at 1x, 2x and 4x, with no drive (oversampling
+ *  skipped, only the latency delay runs) and with drive; then the whole
+ *  DSPChain in Telephone mode with and without it. */
+void benchSaturation(Bench::Runner& runner) {
+    for (int factor : { 1, 2, 4 })
+        for (float drive : { 0.0f, 0.5f })
+            for (double sampleRate : runner.sampleRates())
+                for (int blockSize : runner.blockSizes())
+                    for (int numChannels : runner.channelCounts()) {
+                        const auto variant = juce::String(factor) + "x;drive=" + juce::String(drive, 1);
+
+                        DSP::Saturation<float> saturation;
+                        saturation.prepare(sampleRate, blockSize, numChannels);
+                        saturation.setOversampling(factor);
+                        saturation.setDrive(drive);
+                        saturation.reset();
+
+                        runner.run({ "saturation", variant, sampleRate, blockSize, numChannels },
+                                   [&](juce::AudioBuffer<float>& block) {
+                            saturation.process(block.getArrayOfWritePointers(), block.getNumChannels(),
+                                               block.getNumSamples());
+                        });
+
+                        Bench::Config config { "saturation", "chain;" + variant, sampleRate, blockSize, numChannels };
+                        DSPChain<float> chain;
+                        chain.setSaturation(drive);
+                        chain.prepare(makeSpec(config));
+                        chain.setSaturationOversampling(factor);
+
+                        runner.run(config, [&](juce::AudioBuffer<float>& block) {
+                            chain.processBlock(block, 0, 1.0f);
+                        });
+                    }
+}
+
+/** The noise stage on its own (hiss, vinyl), against white noise from
+ *  juce::Random per sample as the naive baseline; then the whole DSPChain in
+ *  Telephone mode with hiss added. */
+void benchNoise(Bench::Runner& runner) {
+    for (double sampleRate : runner.sampleRates())
+        for (int blockSize : runner.blockSizes())
+            for (int numChannels : runner.channelCounts()) {
+                juce::Random random(1);
+                runner.run({ "noise", "juce-random", sampleRate, blockSize, numChannels },
+                           [&](juce::AudioBuffer<float>& block) {
+                    for (int ch = 0; ch < block.getNumChannels(); ++ch) {
+                        auto* data = block.getWritePointer(ch);
+                        for (int n = 0; n < block.getNumSamples(); ++n)
+                            data[n] += 0.005f * (random.nextFloat() * 2.0f - 1.0f);
+                    }
+                });
+
+                for (int mode : { DSP::NoiseGenerator<float>::Hiss, DSP::NoiseGenerator<float>::Vinyl }) {
+                    DSP::NoiseGenerator<float> noise;
+                    noise.setMode(mode);
+                    noise.setLevel(DSP::NOISE_DEFAULT_LEVEL_DB);
+                    noise.prepare(sampleRate, numChannels);
+
+                    runner.run({ "noise", mode == DSP::NoiseGenerator<float>::Hiss ? "hiss" : "vinyl",
+                                 sampleRate, blockSize, numChannels },
+                               [&](juce::AudioBuffer<float>& block) {
+                        noise.process(block.getArrayOfWritePointers(), block.getNumChannels(), block.getNumSamples());
+                    });
+                }
+
+                for (bool withNoise : { false, true }) {
+                    Bench::Config config { "noise", withNoise ? "chain;hiss" : "chain;off", sampleRate, blockSize, numChannels };
+                    DSPChain<float> chain;
+                    chain.setNoise(withNoise ? 1 : 0, DSP::NOISE_DEFAULT_LEVEL_DB);
+                    chain.prepare(makeSpec(config));
+
+                    runner.run(config, [&](juce::AudioBuffer<float>& block) {
+                        chain.processBlock(block, 0, 1.0f);
+                    });
+                }
+            }
+}
+
+/** Exponentially decaying noise (down 60 dB at the end), like a room or a device body. */
+std::vector<float> makeDecayingNoise(double seconds, double sampleRate) {
+    std::vector<float> response(static_cast<size_t>(seconds * sampleRate));
+    juce::Random random(7);
+
+    for (size_t n = 0; n < response.size(); ++n)
+        response[n] = (random.nextFloat() * 2.0f - 1.0f)
+                      * std::pow(0.001f, static_cast<float>(n) / static_cast<float>(response.size()));
+    return response;
+}
+
+/** The IR mode's convolver: head size x level ratio (1 = uniform partitions) x
+ *  response length at 48 kHz stereo, against a direct-form FIR of the shortest
+ *  response; then the whole DSPChain in IR mode against Telephone. */
+void benchConvolution(Bench::Runner& runner) {
+    constexpr double sampleRate = 48000.0;
+    constexpr int numChannels = 2;
+
+    for (double seconds : { 0.05, 0.5, 2.0 }) {
+        const auto response = makeDecayingNoise(seconds, sampleRate);
+        const int length = static_cast<int>(response.size());
+        const auto ir = "ir=" + juce::String(seconds, 2) + "s";
+
+        for (int blockSize : runner.blockSizes()) {
+            // Baseline: every tap, every sample (the shortest response only)
+            if (seconds < 0.1) {
+                std::vector<std::vector<float>> history(numChannels, std::vector<float>(static_cast<size_t>(2 * length)));
+                int position = 0;
+
+                runner.run({ "convolution", ir + ";direct", sampleRate, blockSize, numChannels },
+                           [&](juce::AudioBuffer<float>& block) {
+                    for (int n = 0; n < block.getNumSamples(); ++n) {
+                        for (int ch = 0; ch < numChannels; ++ch) {
+                            // Mirrored history: the last length inputs are contiguous, newest first
+                            auto& h = history[(size_t) ch];
+                            auto* data = block.getWritePointer(ch);
+                            h[(size_t) position] = h[(size_t) (position + length)] = data[n];
+
+                            float sum = 0.0f;
+                            for (int k = 0; k < length; ++k)
+                                sum += response[(size_t) k] * h[(size_t) (position + length - k)];
+                            data[n] = sum;
+                        }
+                        position = (position + 1) % length;
+                    }
+                });
+            }
+
+            for (int headSize : { 16, 32, 64, 128, 256 })
+                for (int ratio : { 1, 4, 8 }) {
+                    DSP::PartitionedConvolver<float> convolver;
+                    convolver.prepare(response.data(), length, numChannels, headSize, ratio);
+
+                    runner.run({ "convolution", ir + ";head=" + juce::String(headSize) + ";ratio=" + juce::String(ratio),
+                                 sampleRate, blockSize, numChannels },
+                               [&](juce::AudioBuffer<float>& block) {
+                        convolver.process(block.getArrayOfReadPointers(), block.getArrayOfWritePointers(),
+                                          block.getNumChannels(), block.getNumSamples(), 1.0f);
+                    });
+                }
+        }
+    }
+
+    const auto response = makeDecayingNoise(0.5, sampleRate);
+
+    for (double rate : runner.sampleRates())
+        for (int blockSize : runner.blockSizes())
+            for (int channels : runner.channelCounts())
+                for (int mode : { 0, 3 }) {
+                    Bench::Config config { "convolution", mode == 0 ? "chain;telephone" : "chain;ir=0.50s",
+                                           rate, blockSize, channels };
+                    DSPChain<float> chain;
+                    chain.prepare(makeSpec(config));
+
+                    auto engine = std::make_unique<DSP::PartitionedConvolver<float>>();
+                    engine->prepare(response.data(), static_cast<int>(response.size()), channels,
+                                    DSP::CONVOLUTION_HEAD_SIZE, DSP::CONVOLUTION_LEVEL_RATIO);
+                    chain.setImpulseResponse(std::move(engine));
+
+                    runner.run(config, [&](juce::AudioBuffer<float>& block) {
+                        chain.processBlock(block, mode, 1.0f);
+                    });
+                }
+}
+
+/** The codec stage on its own (law x bits x packet loss), against a naive
+ *  mu-law (std::log / std::pow per sample, 8 kHz sample-and-hold) as the
+ *  baseline; then the whole DSPChain in the codec modes against the filter
+ *  modes, at full rate and with multirate on. */
+void benchCodec(Bench::Runner& runner) {
+    for (double sampleRate : runner.sampleRates())
+        for (int blockSize : runner.blockSizes())
+            for (int numChannels : runner.channelCounts()) {
+                std::vector<float> held(static_cast<size_t>(numChannels), 0.0f);
+                double phase = 1.0;
+
+                runner.run({ "codec", "naive-mulaw", sampleRate, blockSize, numChannels },
+                           [&](juce::AudioBuffer<float>& block) {
+                    const double increment = DSP::CODEC_SAMPLE_RATE_HZ / sampleRate;
+
+                    for (int n = 0; n < block.getNumSamples(); ++n) {
+                        const bool tick = phase >= 1.0;
+                        phase = tick ? phase - 1.0 + increment : phase + increment;
+
+                        for (int ch = 0; ch < block.getNumChannels(); ++ch) {
+                            auto* data = block.getWritePointer(ch);
+
+                            if (tick) {
+                                const float x = juce::jlimit(-1.0f, 1.0f, data[n]);
+                                const float compressed = std::log1p(255.0f * std::abs(x)) / std::log(256.0f);
+                                const float quantised = std::round(compressed * 127.0f) / 127.0f;
+                                held[(size_t) ch] = std::copysign((std::pow(256.0f, quantised) - 1.0f) / 255.0f, x);
+                            }
+
+                            data[n] = held[(size_t) ch];
+                        }
+                    }
+                });
+
+                for (auto law : { DSP::CodecLaw::MuLaw, DSP::CodecLaw::ALaw })
+                    for (int bits : { 8, 4 })
+                        for (float loss : { 0.0f, 5.0f }) {
+                            DSP::Codec<float> codec;
+                            codec.setBits(bits);
+                            codec.setPacketLoss(loss * 0.01f);
+                            codec.prepare(law, sampleRate, numChannels);
+
+                            const auto variant = juce::String(law == DSP::CodecLaw::MuLaw ? "mulaw" : "alaw")
+                                                 + ";bits=" + juce::String(bits) + ";loss=" + juce::String(loss, 0);
+
+                            runner.run({ "codec", variant, sampleRate, blockSize, numChannels },
+                                       [&](juce::AudioBuffer<float>& block) {
+                                codec.process(block.getArrayOfWritePointers(), block.getNumChannels(),
+                                              block.getNumSamples());
+                            });
+                        }
+
+                for (bool multirate : { false, true })
+                    for (int mode : { 0, 1, 2, 4, 5 }) {
+                        Bench::Config config { "codec", "chain;mode=" + juce::String(mode) + (multirate ? ";multirate" : ""),
+                                               sampleRate, blockSize, numChannels };
+                        DSPChain<float> chain;
+                        chain.setMultirateEnabled(multirate);
+                        chain.prepare(makeSpec(config));
+
+                        runner.run(config, [&](juce::AudioBuffer<float>& block) {
+                            chain.processBlock(block, mode, 1.0f);
+                        });
+                    }
+            }
+}
+
+/** The output limiter at several lookaheads (its cost should not move),
+ *  against a naive limiter that scans the whole lookahead for its peak every
+ *  sample; then the output gain alone, and the whole DSPChain in Custom mode
+ *  with the limiter off and on. */
+void benchLimiter(Bench::Runner& runner) {
+    for (double sampleRate : runner.sampleRates())
+        for (int blockSize : runner.blockSizes())
+            for (int numChannels : runner.channelCounts()) {
+                const float ceiling = juce::Decibels::decibelsToGain(static_cast<float>(DSP::LIMITER_CEILING_DB));
+                const float release = 1.0f - std::exp(-1.0f / static_cast<float>(DSP::LIMITER_RELEASE_MS * 0.001 * sampleRate));
+
+                for (double lookaheadMs : { 0.5, 2.0, 10.0 }) {
+                    const int lookahead = juce::jmax(1, static_cast<int>(std::lround(lookaheadMs * 0.001 * sampleRate)));
+                    std::vector<float> peaks(static_cast<size_t>(lookahead), 0.0f);
+                    std::vector<std::vector<float>> delayed(static_cast<size_t>(numChannels),
+                                                            std::vector<float>(static_cast<size_t>(lookahead), 0.0f));
+                    float envelope = 1.0f;
+                    int position = 0;
+
+                    runner.run({ "limiter", "naive-scan;lookahead=" + juce::String(lookaheadMs, 1) + "ms",
+                                 sampleRate, blockSize, numChannels },
+                               [&](juce::AudioBuffer<float>& block) {
+                        for (int n = 0; n < block.getNumSamples(); ++n) {
+                            float peak = 0.0f;
+                            for (int ch = 0; ch < block.getNumChannels(); ++ch)
+                                peak = juce::jmax(peak, std::abs(block.getSample(ch, n)));
+                            peaks[(size_t) position] = peak;
+
+                            const float held = *std::max_element(peaks.begin(), peaks.end());
+                            const float target = ceiling / juce::jmax(held, ceiling);
+                            envelope = juce::jmin(target, envelope + (target - envelope) * release);
+
+                            for (int ch = 0; ch < block.getNumChannels(); ++ch) {
+                                auto& line = delayed[(size_t) ch];
+                                const float x = block.getSample(ch, n);
+                                block.setSample(ch, n, line[(size_t) position] * envelope);
+                                line[(size_t) position] = x;
+                            }
+                            position = (position + 1) % lookahead;
+                        }
+                    });
+                }
+
+                for (double lookaheadMs : { 0.5, 2.0, 10.0, 50.0 }) {
+                    DSP::OutputStage<float> stage;
+                    stage.prepare(sampleRate, blockSize, numChannels, lookaheadMs * 0.001);
+                    stage.setLimiting(true);
+
+                    runner.run({ "limiter", "lookahead=" + juce::String(lookaheadMs, 1) + "ms", sampleRate, blockSize, numChannels },
+                               [&](juce::AudioBuffer<float>& block) {
+                        stage.process(block.getArrayOfWritePointers(), block.getNumChannels(), block.getNumSamples());
+                    });
+                }
+
+                DSP::OutputStage<float> gainOnly;
+                gainOnly.setGain(6.0f);
+                gainOnly.prepare(sampleRate, blockSize, numChannels);
+
+                runner.run({ "limiter", "gain-only", sampleRate, blockSize, numChannels },
+                           [&](juce::AudioBuffer<float>& block) {
+                    gainOnly.process(block.getArrayOfWritePointers(), block.getNumChannels(), block.getNumSamples());
+                });
+
+                for (bool limiter : { false, true }) {
+                    Bench::Config config { "limiter", limiter ? "chain;custom;limiter" : "chain;custom",
+                                           sampleRate, blockSize, numChannels };
+                    DSPChain<float> chain;
+                    chain.prepare(makeSpec(config));
+                    chain.setLimiterEnabled(limiter);
+
+                    runner.run(config, [&](juce::AudioBuffer<float>& block) {
+                        chain.processBlock(block, static_cast<int>(DSP::Mode::Custom), 1.0f);
+                    });
+                }
+            }
+}
+
+//==============================================================================
+/** Amplitude of one frequency in a signal (single-bin DFT over whole cycles). */
+double measureGain(const float* signal, int numSamples, double frequency, double sampleRate) {
+    const int cycles = juce::jmax(1, static_cast<int>(numSamples * frequency / sampleRate));
+    const int length = static_cast<int>(cycles * sampleRate / frequency);
+
+    double re = 0.0, im = 0.0;
+    for (int n = 0; n < length; ++n) {
+        const double phase = juce::MathConstants<double>::twoPi * frequency * n / sampleRate;
+        re += signal[n] * std::cos(phase);
+        im += signal[n] * std::sin(phase);
+    }
+    return 2.0 * std::sqrt(re * re + im * im) / length;
+}
+
+/** Runs one mono signal through a TelephonyFilter in host-sized blocks. */
+void renderTelephony(TelephonyFilter<float>& filter, const juce::AudioBuffer<float>& input,
+                     juce::AudioBuffer<float>& output, int blockSize) {
+    for (int start = 0; start < input.getNumSamples(); start += blockSize) {
+        const int numSamples = juce::jmin(blockSize, input.getNumSamples() - start);
+        const juce::AudioBuffer<float> in(const_cast<float* const*>(input.getArrayOfReadPointers()), 1, start, numSamples);
+        juce::AudioBuffer<float> out(output.getArrayOfWritePointers(), 1, start, numSamples);
+        filter.process(in, out);
+    }
+}
+
+/** Multirate vs full-rate TelephonyFilter: gain per voice-band frequency and the
+ *  residual of a multi-tone after removing the multirate latency. CSV to stdout. */
+int runMultirateNullTest() {
+    const double frequencies[] = { 300.0, 1000.0, 2000.0, 3000.0, 3400.0 };
+    constexpr int blockSize = 512;
+
+    std::cout << "sampleRate,internalRate,latencySamples,frequency,fullRateDb,multirateDb,differenceDb" << std::endl;
+
+    for (double sampleRate : { 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0 }) {
+        const int numSamples = static_cast<int>(sampleRate);  // 1 s: settle, then measure the second half
+        const int measureStart = numSamples / 2;
+
+        juce::dsp::ProcessSpec spec { sampleRate, static_cast<juce::uint32>(blockSize), 1 };
+        double residualEnergy = 0.0, referenceEnergy = 0.0;
+        int latency = 0;
+        double internalRate = sampleRate;
+
+        juce::AudioBuffer<float> multiTone(1, numSamples), fullMultiTone(1, numSamples), multirateMultiTone(1, numSamples);
+        multiTone.clear();
+
+        for (double frequency : frequencies) {
+            juce::AudioBuffer<float> tone(1, numSamples), full(1, numSamples), multirate(1, numSamples);
+            for (int n = 0; n < numSamples; ++n) {
+                const auto sample = static_cast<float>(0.25 * std::sin(juce::MathConstants<double>::twoPi * frequency * n / sampleRate));
+                tone.setSample(0, n, sample);
+                multiTone.addSample(0, n, sample * 0.2f);
+            }
+
+            TelephonyFilter<float> fullRate, decimated;
+            fullRate.prepare(spec);
+            decimated.prepare(spec);
+            decimated.setMultirateEnabled(true);
+            latency = decimated.getLatencySamples();
+            internalRate = decimated.getInternalSampleRate();
+
+            renderTelephony(fullRate, tone, full, blockSize);
+            renderTelephony(decimated, tone, multirate, blockSize);
+
+            const int length = numSamples - measureStart - latency;
+            const double fullDb = juce::Decibels::gainToDecibels(
+                measureGain(full.getReadPointer(0, measureStart), length, frequency, sampleRate) / 0.25, -200.0);
+            const double multirateDb = juce::Decibels::gainToDecibels(
+                measureGain(multirate.getReadPointer(0, measureStart + latency), length, frequency, sampleRate) / 0.25, -200.0);
+
+            std::cout << sampleRate << ',' << internalRate << ',' << latency << ',' << frequency << ','
+                      << fullDb << ',' << multirateDb << ',' << (multirateDb - fullDb) << std::endl;
+        }
+
+        // Residual of the multi-tone (gain and phase differences together)
+        TelephonyFilter<float> fullRate, decimated;
+        fullRate.prepare(spec);
+        decimated.prepare(spec);
+        decimated.setMultirateEnabled(true);
+        renderTelephony(fullRate, multiTone, fullMultiTone, blockSize);
+        renderTelephony(decimated, multiTone, multirateMultiTone, blockSize);
+
+        for (int n = measureStart; n < numSamples - latency; ++n) {
+            const double reference = fullMultiTone.getSample(0, n);
+            const double difference = multirateMultiTone.getSample(0, n + latency) - reference;
+            residualEnergy += difference * difference;
+            referenceEnergy += reference * reference;
+        }
+
+        std::cout << sampleRate << ',' << internalRate << ',' << latency << ",residual,,,"
+                  << 10.0 * std::log10(residualEnergy / juce::jmax(referenceEnergy, 1.0e-30) + 1.0e-30) << std::endl;
+    }
+
+    return 0;
+}
+
+/** PartitionedConvolver against direct convolution: largest error relative to the
+ *  output peak, latency of an impulse, and mean / worst time per block over a
+ *  long run (the worst block is where a large level's FFTs land). CSV to stdout. */
+int runConvolutionTest() {
+    constexpr double sampleRate = 48000.0;
+    constexpr int referenceSamples = 24000;
+    constexpr int timedSamples = 480000;
+
+    std::cout << "irSeconds,headSize,ratio,blockSize,levels,partitions,relativeError,latencySamples,meanBlockUs,worstBlockUs"
+              << std::endl;
+
+    for (double seconds : { 0.05, 0.25, 2.0 }) {
+        const auto response = makeDecayingNoise(seconds, sampleRate);
+        const int length = static_cast<int>(response.size());
+
+        juce::Random random(3);
+        std::vector<float> input(static_cast<size_t>(timedSamples));
+        for (auto& sample : input)
+            sample = 0.5f * (random.nextFloat() * 2.0f - 1.0f);
+
+        // Direct convolution of the first referenceSamples, in double
+        std::vector<double> reference(static_cast<size_t>(referenceSamples));
+        double referencePeak = 0.0;
+        for (int n = 0; n < referenceSamples; ++n) {
+            double sum = 0.0;
+            for (int k = 0; k <= juce::jmin(n, length - 1); ++k)
+                sum += static_cast<double>(response[(size_t) k]) * input[(size_t) (n - k)];
+            reference[(size_t) n] = sum;
+            referencePeak = juce::jmax(referencePeak, std::abs(sum));
+        }
+
+        for (int headSize : { 16, 64, 256 })
+            for (int ratio : { 1, 8 })
+                for (int blockSize : { 32, 512 }) {
+                    DSP::PartitionedConvolver<float> convolver;
+                    convolver.prepare(response.data(), length, 1, headSize, ratio);
+
+                    // Impulse: the first output sample that moves is the latency
+                    std::vector<float> impulse(static_cast<size_t>(blockSize), 0.0f);
+                    impulse[0] = 1.0f;
+                    float* impulseChannel = impulse.data();
+                    convolver.process(&impulseChannel, &impulseChannel, 1, blockSize, 1.0f);
+                    int latency = 0;
+                    while (latency < blockSize && impulse[(size_t) latency] == 0.0f)
+                        ++latency;
+
+                    convolver.reset();
+                    std::vector<float> output(input);
+                    double meanUs = 0.0, worstUs = 0.0;
+                    int numBlocks = 0;
+
+                    for (int start = 0; start + blockSize <= timedSamples; start += blockSize) {
+                        float* channel = output.data() + start;
+                        const auto begin = std::chrono::steady_clock::now();
+                        convolver.process(&channel, &channel, 1, blockSize, 1.0f);
+                        const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count();
+
+                        meanUs += us;
+                        worstUs = juce::jmax(worstUs, us);
+                        ++numBlocks;
+                    }
+
+                    double error = 0.0;
+                    for (int n = 0; n < referenceSamples; ++n)
+                        error = juce::jmax(error, std::abs(output[(size_t) n] - reference[(size_t) n]));
+
+                    std::cout << seconds << ',' << headSize << ',' << ratio << ',' << blockSize << ','
+                              << convolver.getNumLevels() << ',' << convolver.getNumPartitions() << ','
+                              << error / juce::jmax(referencePeak, 1.0e-30) << ',' << latency << ','
+                              << meanUs / juce::jmax(numBlocks, 1) << ',' << worstUs << std::endl;
+                }
+    }
+
+    return 0;
+}
+
+//==============================================================================
+struct Suite {
+    const char* name;
+    void (*run)(Bench::Runner&);
+};
+
+const Suite suites[] = {
+    { "chain",       benchDSPChain },
+    { "telephony",   benchTelephonyFilter },
+    { "radio",       benchRadioFilter },
+    { "biquad",      benchBiquadEngines },
+    { "multirate",   benchMultirate },
+    { "automation",  benchCutoffAutomation },
+    { "drift",       benchDriftKernels },
+    { "chain-drift", benchDSPChainDrift },
+    { "mode-switch", benchModeSwitch },
+    { "silence",     benchSilence },
+    { "precision",   benchPrecision },
+    { "chain-dispatch", benchChainDispatch },
+    { "force-mono",  benchForceMono },
+    { "saturation",  benchSaturation },
+    { "noise",       benchNoise },
+    { "convolution", benchConvolution },
+    { "codec",       benchCodec },
+    { "limiter",     benchLimiter },
+};
+
+} // namespace
+
+//==============================================================================
+int main(int argc, char* argv[]) {
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h")) {
+        std::cout << "Usage: paranoidFilteroidBench [--suite=<name>[,<name>...]] [--quick] [--time=<seconds>]\n"
+                     "       paranoidFilteroidBench --null-test\n"
+                     "       paranoidFilteroidBench --convolution-test\n"
+                     "Suites:";
+        for (const auto& suite : suites)
+            std::cout << ' ' << suite.name;
+        std::cout << std::endl;
+        return 0;
+    }
+
+    if (args.containsOption("--null-test"))
+        return runMultirateNullTest();
+
+    if (args.containsOption("--convolution-test"))
+        return runConvolutionTest();
+
+    juce::StringArray selected;
+    if (args.containsOption("--suite"))
+        selected.addTokens(args.getValueForOption("--suite"), ",", {});
+
+    const double secondsPerCase = args.containsOption("--time")
+                                      ? juce::jmax(0.001, args.getValueForOption("--time").getDoubleValue())
+                                      : 0.1;
+
+    Bench::Runner runner(secondsPerCase, args.containsOption("--quick"));
+    runner.printHeader();
+
+    for (const auto& suite : suites)
+        if (selected.isEmpty() || selected.contains(suite.name))
+            suite.run(runner);
+
+    return 0;
+}
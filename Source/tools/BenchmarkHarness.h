@@ -0,0 +1,149 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+
+#include <chrono>
+#include <iostream>
+#include <type_traits>
+#include <vector>
+
+//==============================================================================
+/**
+ * Bench - Minimal timing harness for the DSP microbenchmarks
+ *
+ * Every case processes a pre-generated "tape" of seeded white noise block by
+ * block, in place, for at least minSecondsPerCase. The tape is restored from
+ * a pristine copy between passes, outside the timed region, so the filters
+ * always see the same full-scale input instead of a signal decaying towards
+ * denormals.
+ *
+ * Output is one CSV row per case:
+ *   suite,variant,sampleRate,blockSize,channels,nsPerSample,samplesPerSec,realtimeFactor
+ *
+ * run<double>() times a double-precision process on the same tape (converted
+ * outside the timed region).
+ *
+ * "Sample" means one channel-sample, so nsPerSample is comparable across
+ * channel counts. realtimeFactor is how many real-time streams of this
+ * configuration one core could run.
+ */
+namespace Bench {
+
+struct Config {
+    juce::String suite;
+    juce::String variant;
+    double sampleRate = 48000.0;
+    int blockSize = 512;
+    int numChannels = 2;
+};
+
+//==============================================================================
+class Runner {
+public:
+    Runner(double minSecondsPerCaseToUse, bool quickGrid)
+        : minSecondsPerCase(minSecondsPerCaseToUse), quick(quickGrid) {}
+
+    /** Sweep grids used by the suites. The quick grid is for smoke runs. */
+    std::vector<int> blockSizes() const {
+        if (quick) return { 64, 512, 4096 };
+        return { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+    }
+
+    std::vector<double> sampleRates() const {
+        if (quick) return { 48000.0, 96000.0 };
+        return { 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0 };
+    }
+
+    std::vector<int> channelCounts() const { return { 1, 2, 8 }; }
+
+    void printHeader() const {
+        std::cout << "suite,variant,sampleRate,blockSize,channels,nsPerSample,samplesPerSec,realtimeFactor"
+                  << std::endl;
+    }
+
+    //==========================================================================
+    /** Times process(block) over the noise tape and prints one CSV row.
+     *
+     * @param config  Case description (also defines the tape layout)
+     * @param process Callable taking juce::AudioBuffer<SampleType>& (one block, in place)
+     */
+    template <typename SampleType = float, typename ProcessFn>
+    void run(const Config& config, ProcessFn&& process) {
+        const int blocksPerPass = juce::jmax(8, tapeFrames / config.blockSize);
+        const int passFrames = blocksPerPass * config.blockSize;
+
+        fillSource(config.numChannels, passFrames);
+        getTape<SampleType>().setSize(config.numChannels, passFrames, false, false, true);
+
+        juce::ScopedNoDenormals noDenormals;
+
+        // Warm-up pass (caches, branch predictors, lazily touched state)
+        runPass<SampleType>(config, blocksPerPass, process);
+
+        double totalNs = 0.0;
+        juce::int64 totalSamples = 0;
+        while (totalNs < minSecondsPerCase * 1.0e9) {
+            totalNs += runPass<SampleType>(config, blocksPerPass, process);
+            totalSamples += (juce::int64) passFrames * config.numChannels;
+        }
+
+        const double nsPerSample = totalNs / (double) totalSamples;
+        const double samplesPerSec = 1.0e9 / nsPerSample;
+        const double realtimeFactor = samplesPerSec / (config.sampleRate * config.numChannels);
+
+        std::cout << config.suite << ',' << config.variant << ','
+                  << config.sampleRate << ',' << config.blockSize << ',' << config.numChannels << ','
+                  << juce::String(nsPerSample, 4) << ',' << juce::String(samplesPerSec, 0) << ','
+                  << juce::String(realtimeFactor, 1) << std::endl;
+    }
+
+private:
+    template <typename SampleType, typename ProcessFn>
+    double runPass(const Config& config, int blocksPerPass, ProcessFn& process) {
+        auto& tape = getTape<SampleType>();
+        tape.makeCopyOf(source, true);
+
+        const auto start = std::chrono::steady_clock::now();
+
+        for (int b = 0; b < blocksPerPass; ++b) {
+            // Non-owning view into the tape (no allocation)
+            juce::AudioBuffer<SampleType> block(tape.getArrayOfWritePointers(), config.numChannels,
+                                                b * config.blockSize, config.blockSize);
+            process(block);
+        }
+
+        const auto end = std::chrono::steady_clock::now();
+        return (double) std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    }
+
+    void fillSource(int numChannels, int numFrames) {
+        source.setSize(numChannels, numFrames, false, false, true);
+
+        juce::Random random(0x5eed);  // Fixed seed: identical input on every run
+        for (int ch = 0; ch < numChannels; ++ch) {
+            auto* data = source.getWritePointer(ch);
+            for (int n = 0; n < numFrames; ++n)
+                data[n] = 0.5f * (random.nextFloat() * 2.0f - 1.0f);
+        }
+    }
+
+    template <typename SampleType>
+    juce::AudioBuffer<SampleType>& getTape() {
+        if constexpr (std::is_same_v<SampleType, double>)
+            return doubleTape;
+        else
+            return tape;
+    }
+
+    static constexpr int tapeFrames = 65536;
+
+    double minSecondsPerCase;
+    bool quick;
+
+    juce::AudioBuffer<float> source;
+    juce::AudioBuffer<float> tape;
+    juce::AudioBuffer<double> doubleTape;
+};
+
+} // namespace Bench
@@ -0,0 +1,295 @@
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "../core/PluginProcessor.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <vector>
+
+#if JUCE_WINDOWS
+ #include <malloc.h>
+#endif
+
+//==============================================================================
+/**
+ * paranoidFilteroidProfile - Worst-case latency soak test
+ *
+ * Drives PluginProcessor::processBlock the way a host does: random block
+ * sizes up to maxBlockSize, and every parameter automated through the
+ * APVTS between blocks (setValue + listener notification, as the VST3
+ * wrapper does on the audio thread): choices jump to any of their entries,
+ * including the latency-changing switches (multirate, oversampling, limiter).
+ *
+ * Every block is timed individually into a 0.1 us-resolution histogram, and
+ * global operator new is instrumented so any heap allocation made on the
+ * processing thread is counted. Allocations inside processBlock() violate
+ * the "Real-Time Safe" claim in DSPChain.h; allocations during automation
+ * are reported separately since they happen in JUCE/host code.
+ *
+ * Usage:
+ *   paranoidFilteroidProfile [--blocks=<n>] [--sr=<Hz>] [--max-block=<n>]
+ *                            [--seed=<n>] [--histogram=<file.csv>]
+ */
+
+//==============================================================================
+// Allocation counting (only while the processing thread has it switched on)
+namespace {
+
+enum class AllocationPhase { none, automation, process };
+
+thread_local AllocationPhase allocationPhase = AllocationPhase::none;
+std::atomic<juce::int64> automationAllocations { 0 };
+std::atomic<juce::int64> processAllocations { 0 };
+
+void countAllocation() {
+    if (allocationPhase == AllocationPhase::process)
+        processAllocations.fetch_add(1, std::memory_order_relaxed);
+    else if (allocationPhase == AllocationPhase::automation)
+        automationAllocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+void* allocate(std::size_t size) {
+    countAllocation();
+    if (void* p = std::malloc(size == 0 ? 1 : size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* allocateAligned(std::size_t size, std::align_val_t alignment) {
+    countAllocation();
+    const auto align = static_cast<std::size_t>(alignment);
+    const auto rounded = ((size == 0 ? 1 : size) + align - 1) / align * align;
+   #if JUCE_WINDOWS
+    if (void* p = _aligned_malloc(rounded, align))
+   #else
+    if (void* p = std::aligned_alloc(align, rounded))
+   #endif
+        return p;
+    throw std::bad_alloc();
+}
+
+void freeAligned(void* p) noexcept {
+   #if JUCE_WINDOWS
+    _aligned_free(p);
+   #else
+    std::free(p);
+   #endif
+}
+
+} // namespace
+
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new[](std::size_t size) { return allocate(size); }
+void* operator new(std::size_t size, std::align_val_t a) { return allocateAligned(size, a); }
+void* operator new[](std::size_t size, std::align_val_t a) { return allocateAligned(size, a); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { freeAligned(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { freeAligned(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { freeAligned(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { freeAligned(p); }
+
+//==============================================================================
+namespace {
+
+struct ProfileSettings {
+    juce::int64 numBlocks = 2000000;
+    double sampleRate = 48000.0;
+    int maxBlockSize = 512;
+    juce::int64 seed = 1;
+    juce::File histogramFile;
+};
+
+/** Fixed-resolution block time histogram (0.1 us bins up to 20 ms, plus overflow). */
+class BlockTimeHistogram {
+public:
+    void add(double ns) {
+        const auto bin = static_cast<size_t>(ns / binWidthNs);
+        ++bins[juce::jmin(bin, bins.size() - 1)];
+        maxNs = juce::jmax(maxNs, ns);
+        ++count;
+    }
+
+    /** Upper edge of the bin containing the given percentile (0..100). */
+    double percentileNs(double percentile) const {
+        const auto target = static_cast<juce::int64>(std::ceil(count * percentile / 100.0));
+        juce::int64 seen = 0;
+        for (size_t i = 0; i < bins.size(); ++i) {
+            seen += bins[i];
+            if (seen >= target)
+                return juce::jmin((double) (i + 1) * binWidthNs, maxNs);
+        }
+        return maxNs;
+    }
+
+    double getMaxNs() const { return maxNs; }
+    juce::int64 getCount() const { return count; }
+
+    /** Writes non-empty bins as "binStartUs,count" rows. */
+    bool writeCsv(const juce::File& file) const {
+        juce::String csv("binStartUs,count\n");
+        for (size_t i = 0; i < bins.size(); ++i)
+            if (bins[i] != 0)
+                csv << juce::String((double) i * binWidthNs * 0.001, 1) << ',' << bins[i] << '\n';
+        return file.replaceWithText(csv);
+    }
+
+private:
+    static constexpr double binWidthNs = 100.0;
+    std::vector<juce::int64> bins = std::vector<juce::int64>(200001, 0);
+    double maxNs = 0.0;
+    juce::int64 count = 0;
+};
+
+//==============================================================================
+/** Runs the soak test on a high-priority thread standing in for the host audio thread. */
+class ProcessingThread : public juce::Thread {
+public:
+    ProcessingThread(PluginProcessor& p, const ProfileSettings& s)
+        : juce::Thread("Audio"), processor(p), settings(s) {}
+
+    ~ProcessingThread() override { stopThread(-1); }
+
+    void run() override {
+        // Each parameter changes about once in 'period' blocks: mix every block, the
+        // latency-changing switches rarely enough for their settings to play for a while
+        struct Schedule {
+            const char* id;
+            int period;
+        };
+
+        const Schedule schedule[] = {
+            { "mix", 1 },             { "outputGain", 8 },       { "mode", 16 },
+            { "lowCut", 16 },         { "highCut", 16 },         { "saturation", 32 },
+            { "packetLoss", 32 },     { "driftRate", 64 },       { "noiseMode", 64 },
+            { "noiseLevel", 64 },     { "codecBits", 64 },       { "forceMono", 128 },
+            { "multirate", 256 },     { "saturationOversampling", 256 },
+            { "limiter", 256 },       { "enabled", 512 },
+        };
+
+        std::vector<std::pair<juce::RangedAudioParameter*, int>> automatedParameters;
+        for (const auto& entry : schedule)
+            automatedParameters.emplace_back(processor.apvts.getParameter(entry.id), entry.period);
+
+        auto* driftParam = processor.apvts.getParameter("drift");
+
+        const int numChannels = processor.getTotalNumOutputChannels();
+        const int maxBlock = settings.maxBlockSize;
+
+        // Input tape of noise; each block copies a random slice in before timing
+        juce::Random random(settings.seed);
+        juce::AudioBuffer<float> tape(numChannels, maxBlock * 64);
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int n = 0; n < tape.getNumSamples(); ++n)
+                tape.setSample(ch, n, 0.5f * (random.nextFloat() * 2.0f - 1.0f));
+
+        juce::AudioBuffer<float> io(numChannels, maxBlock);
+        juce::MidiBuffer midi;
+
+        auto automate = [&](juce::AudioProcessorParameter* param, float value) {
+            param->setValue(value);
+            param->sendValueChangedMessageToListeners(value);
+        };
+
+        // Choices and switches: any of their entries; continuous parameters: anywhere in the range
+        auto randomValue = [&](const juce::RangedAudioParameter& param) {
+            return param.isDiscrete() ? param.convertTo0to1(static_cast<float>(random.nextInt(param.getNumSteps())))
+                                      : random.nextFloat();
+        };
+
+        for (juce::int64 block = 0; block < settings.numBlocks && ! threadShouldExit(); ++block) {
+            const int numSamples = 1 + random.nextInt(maxBlock);
+            const int offset = random.nextInt(tape.getNumSamples() - numSamples);
+
+            // Host-side automation; drift alternates between off and on, so both topologies run
+            allocationPhase = AllocationPhase::automation;
+            for (const auto& [param, period] : automatedParameters)
+                if (random.nextInt(period) == 0)
+                    automate(param, randomValue(*param));
+            if (random.nextInt(64) == 0)
+                automate(driftParam, driftParam->getValue() > 0.0f ? 0.0f : random.nextFloat());
+            allocationPhase = AllocationPhase::none;
+
+            // Non-owning view of the first numSamples of the I/O buffer (no allocation)
+            juce::AudioBuffer<float> buffer(io.getArrayOfWritePointers(), numChannels, numSamples);
+            for (int ch = 0; ch < numChannels; ++ch)
+                buffer.copyFrom(ch, 0, tape, ch, offset, numSamples);
+
+            allocationPhase = AllocationPhase::process;
+            const auto start = std::chrono::steady_clock::now();
+            processor.processBlock(buffer, midi);
+            const auto end = std::chrono::steady_clock::now();
+            allocationPhase = AllocationPhase::none;
+
+            histogram.add((double) std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        }
+    }
+
+    const BlockTimeHistogram& getHistogram() const { return histogram; }
+
+private:
+    PluginProcessor& processor;
+    const ProfileSettings& settings;
+    BlockTimeHistogram histogram;
+};
+
+} // namespace
+
+//==============================================================================
+int main(int argc, char* argv[]) {
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;  // APVTS needs a message manager
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h")) {
+        std::cout << "Usage: paranoidFilteroidProfile [--blocks=<n>] [--sr=<Hz>] [--max-block=<n>]\n"
+                     "                                [--seed=<n>] [--histogram=<file.csv>]" << std::endl;
+        return 0;
+    }
+
+    ProfileSettings settings;
+    if (args.containsOption("--blocks"))
+        settings.numBlocks = juce::jmax<juce::int64>(1, args.getValueForOption("--blocks").getLargeIntValue());
+    if (args.containsOption("--sr"))
+        settings.sampleRate = juce::jlimit(8000.0, 768000.0, args.getValueForOption("--sr").getDoubleValue());
+    if (args.containsOption("--max-block"))
+        settings.maxBlockSize = juce::jlimit(16, 16384, args.getValueForOption("--max-block").getIntValue());
+    if (args.containsOption("--seed"))
+        settings.seed = args.getValueForOption("--seed").getLargeIntValue();
+    if (args.containsOption("--histogram"))
+        settings.histogramFile = args.getFileForOption("--histogram");
+
+    PluginProcessor processor;
+    processor.prepareToPlay(settings.sampleRate, settings.maxBlockSize);
+
+    std::cout << "Soak test: " << settings.numBlocks << " blocks, " << settings.sampleRate
+              << " Hz, random block sizes 1.." << settings.maxBlockSize << std::endl;
+
+    ProcessingThread thread(processor, settings);
+    thread.startThread(juce::Thread::Priority::highest);
+    thread.waitForThreadToExit(-1);
+
+    processor.releaseResources();
+
+    const auto& histogram = thread.getHistogram();
+    const double budgetUs = settings.maxBlockSize / settings.sampleRate * 1.0e6;
+
+    std::cout << "Blocks timed:     " << histogram.getCount() << "\n"
+              << "p50:              " << juce::String(histogram.percentileNs(50.0) * 0.001, 2) << " us\n"
+              << "p99:              " << juce::String(histogram.percentileNs(99.0) * 0.001, 2) << " us\n"
+              << "p99.9:            " << juce::String(histogram.percentileNs(99.9) * 0.001, 2) << " us\n"
+              << "max:              " << juce::String(histogram.getMaxNs() * 0.001, 2) << " us\n"
+              << "max-block budget: " << juce::String(budgetUs, 2) << " us\n"
+              << "Heap allocations in processBlock:     " << processAllocations.load() << "\n"
+              << "Heap allocations in host automation:  " << automationAllocations.load() << std::endl;
+
+    if (settings.histogramFile != juce::File() && ! histogram.writeCsv(settings.histogramFile))
+        std::cerr << "Could not write " << settings.histogramFile.getFullPathName() << std::endl;
+
+    // Non-zero exit if the real-time safety claim was violated
+    return processAllocations.load() == 0 ? 0 : 2;
+}
@@ -0,0 +1,229 @@
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "../core/PluginProcessor.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+//==============================================================================
+/**
+ * paranoidFilteroidStateBench - Session save/load cost, binary vs XML state
+ *
+ * Creates a session's worth of PluginProcessor instances with randomised
+ * parameters, then times saving and restoring every instance's state:
+ *
+ *   xml    - the previous path: copyState().createXml() + copyXmlToBinary(),
+ *            loaded through setStateInformation() (the migration path)
+ *   binary - getStateInformation() / setStateInformation() (PluginState)
+ *
+ * Prints CSV:
+ *   format,operation,instances,usPerInstance,bytesPerInstance
+ * and checks that both formats restore the same parameter values.
+ *
+ * --noise-test instead renders a state with vinyl noise on silence, loaded
+ * before prepareToPlay() and after some playback, and checks that both
+ * renders are bit-identical (the seed reaches a running chain).
+ *
+ * Usage:
+ *   paranoidFilteroidStateBench [--instances=<n>] [--passes=<n>] [--seed=<n>]
+ *   paranoidFilteroidStateBench --noise-test
+ */
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/** The state format before PluginState (kept here as the baseline). */
+void saveXmlState(PluginProcessor& processor, juce::MemoryBlock& destData) {
+    auto state = processor.apvts.copyState();
+    std::unique_ptr<juce::XmlElement> xml(state.createXml());
+    juce::AudioProcessor::copyXmlToBinary(*xml, destData);
+}
+
+void randomiseParameters(PluginProcessor& processor, juce::Random& random) {
+    for (auto* parameter : processor.getParameters())
+        parameter->setValueNotifyingHost(random.nextFloat());
+}
+
+std::vector<float> getParameterValues(PluginProcessor& processor) {
+    std::vector<float> values;
+    for (auto* parameter : processor.getParameters())
+        values.push_back(parameter->getValue());
+    return values;
+}
+
+/** Times fn(instance) over every instance, passes times; returns microseconds per instance. */
+template <typename Fn>
+double timePerInstance(std::vector<std::unique_ptr<PluginProcessor>>& instances, int passes, Fn&& fn) {
+    double totalUs = 0.0;
+
+    for (int pass = 0; pass < passes; ++pass) {
+        const auto start = Clock::now();
+        for (size_t i = 0; i < instances.size(); ++i)
+            fn(*instances[i], i);
+        const auto end = Clock::now();
+
+        totalUs += std::chrono::duration<double, std::micro>(end - start).count();
+    }
+
+    return totalUs / (passes * (double) instances.size());
+}
+
+/** Renders numBlocks blocks of silence through the processor (stereo, 512 samples each). */
+std::vector<float> renderSilence(PluginProcessor& processor, int numBlocks) {
+    constexpr int blockSize = 512;
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    juce::MidiBuffer midi;
+    std::vector<float> rendered;
+
+    for (int block = 0; block < numBlocks; ++block) {
+        buffer.clear();
+        processor.processBlock(buffer, midi);
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            rendered.insert(rendered.end(), buffer.getReadPointer(ch), buffer.getReadPointer(ch) + blockSize);
+    }
+
+    return rendered;
+}
+
+/** A state with vinyl noise, loaded before prepareToPlay() and after 0..n blocks of
+ *  playback: every render must match the first one bit for bit. CSV to stdout. */
+int runNoiseSeedTest() {
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 512;
+    constexpr int numBlocks = 200;
+
+    PluginProcessor source;
+    const auto set = [&source](const char* id, float value) {
+        auto* parameter = source.apvts.getParameter(id);
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    };
+    set("noiseMode", 2.0f);
+    set("noiseLevel", -30.0f);
+
+    juce::MemoryBlock state;
+    source.getStateInformation(state);
+
+    PluginProcessor loadedFirst;
+    loadedFirst.setStateInformation(state.getData(), (int) state.getSize());
+    loadedFirst.prepareToPlay(sampleRate, blockSize);
+    const auto reference = renderSilence(loadedFirst, numBlocks);
+
+    std::cout << "blocksBeforeLoad,maxDifference" << std::endl;
+    bool identical = true;
+
+    for (int blocksBeforeLoad : { 0, 1, 37 }) {
+        PluginProcessor loadedLater;
+        loadedLater.prepareToPlay(sampleRate, blockSize);
+        renderSilence(loadedLater, blocksBeforeLoad);
+        loadedLater.setStateInformation(state.getData(), (int) state.getSize());
+        const auto rendered = renderSilence(loadedLater, numBlocks);
+
+        float difference = 0.0f;
+        for (size_t i = 0; i < rendered.size(); ++i)
+            difference = juce::jmax(difference, std::abs(rendered[i] - reference[i]));
+
+        identical = identical && difference == 0.0f;
+        std::cout << blocksBeforeLoad << ',' << difference << std::endl;
+    }
+
+    if (!identical)
+        std::cerr << "noise after a state load differs from a render prepared with it" << std::endl;
+
+    return identical ? 0 : 2;
+}
+
+void printRow(const char* format, const char* operation, size_t instances, double usPerInstance, double bytes) {
+    std::cout << format << ',' << operation << ',' << instances << ','
+              << juce::String(usPerInstance, 3) << ',' << juce::String(bytes, 1) << std::endl;
+}
+
+} // namespace
+
+//==============================================================================
+int main(int argc, char* argv[]) {
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;  // APVTS needs a message manager
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h")) {
+        std::cout << "Usage: paranoidFilteroidStateBench [--instances=<n>] [--passes=<n>] [--seed=<n>]\n"
+                     "       paranoidFilteroidStateBench --noise-test" << std::endl;
+        return 0;
+    }
+
+    if (args.containsOption("--noise-test"))
+        return runNoiseSeedTest();
+
+    int numInstances = 200;
+    int passes = 20;
+    juce::int64 seed = 1;
+    if (args.containsOption("--instances"))
+        numInstances = juce::jlimit(1, 100000, args.getValueForOption("--instances").getIntValue());
+    if (args.containsOption("--passes"))
+        passes = juce::jlimit(1, 100000, args.getValueForOption("--passes").getIntValue());
+    if (args.containsOption("--seed"))
+        seed = args.getValueForOption("--seed").getLargeIntValue();
+
+    juce::Random random(seed);
+    std::vector<std::unique_ptr<PluginProcessor>> instances;
+    for (int i = 0; i < numInstances; ++i) {
+        instances.push_back(std::make_unique<PluginProcessor>());
+        randomiseParameters(*instances.back(), random);
+    }
+
+    const auto count = instances.size();
+    std::vector<juce::MemoryBlock> xmlStates(count), binaryStates(count);
+    std::vector<std::vector<float>> expected;
+    for (auto& instance : instances)
+        expected.push_back(getParameterValues(*instance));
+
+    //==========================================================================
+    const double xmlSaveUs = timePerInstance(instances, passes, [&](PluginProcessor& p, size_t i) {
+        saveXmlState(p, xmlStates[i]);
+    });
+    const double binarySaveUs = timePerInstance(instances, passes, [&](PluginProcessor& p, size_t i) {
+        p.getStateInformation(binaryStates[i]);
+    });
+
+    double xmlBytes = 0.0, binaryBytes = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        xmlBytes += (double) xmlStates[i].getSize();
+        binaryBytes += (double) binaryStates[i].getSize();
+    }
+
+    // Load each instance's state back into it: values must come back unchanged
+    // (up to float rounding in the normalise/denormalise round trip)
+    bool identical = true;
+    const auto verify = [&](const char* format) {
+        for (size_t i = 0; i < count; ++i) {
+            const auto values = getParameterValues(*instances[i]);
+            for (size_t v = 0; v < values.size(); ++v)
+                if (std::abs(values[v] - expected[i][v]) > 1.0e-5f) {
+                    std::cerr << format << " state did not restore instance " << i << std::endl;
+                    identical = false;
+                    return;
+                }
+        }
+    };
+
+    const double xmlLoadUs = timePerInstance(instances, passes, [&](PluginProcessor& p, size_t i) {
+        p.setStateInformation(xmlStates[i].getData(), (int) xmlStates[i].getSize());
+    });
+    verify("xml");
+
+    const double binaryLoadUs = timePerInstance(instances, passes, [&](PluginProcessor& p, size_t i) {
+        p.setStateInformation(binaryStates[i].getData(), (int) binaryStates[i].getSize());
+    });
+    verify("binary");
+
+    //==========================================================================
+    std::cout << "format,operation,instances,usPerInstance,bytesPerInstance" << std::endl;
+    printRow("xml", "save", count, xmlSaveUs, xmlBytes / count);
+    printRow("binary", "save", count, binarySaveUs, binaryBytes / count);
+    printRow("xml", "load", count, xmlLoadUs, xmlBytes / count);
+    printRow("binary", "load", count, binaryLoadUs, binaryBytes / count);
+
+    return identical ? 0 : 2;
+}
@@ -0,0 +1,200 @@
+#include "../engine/VoiceEngine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+//==============================================================================
+/**
+ * paranoidFilteroidVoiceBench - Streams per core for the multi-stream voice engine
+ *
+ * Runs VoiceEngine on a server-like load (every stream a separate call,
+ * modes and cutoffs mixed, 20 ms frames) at 8, 16 and 48 kHz and reports how
+ * many real-time streams each core sustains:
+ *
+ *   per-stream - one BiquadCascade per stream on one thread, i.e. what one
+ *                mono DSPChain per call costs in filtering alone
+ *   batch      - VoiceEngine (SoA, streams in SIMD lanes) on one thread
+ *   batch-mt   - VoiceEngine on all threads (--threads)
+ *
+ * Prints CSV:
+ *   variant,sampleRate,blockSize,streams,threads,nsPerSample,realtimeFactor,streamsPerCore
+ *
+ * Plain C++, no JUCE: it links only the headless DSP library.
+ *
+ * Usage:
+ *   paranoidFilteroidVoiceBench [--streams=<n>] [--threads=<n>] [--time=<seconds>]
+ */
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    int streams = 4096;
+    int threads = 0;
+    double seconds = 1.0;
+};
+
+/** --name=value, or fallback if absent. */
+std::string getOption(int argc, char* argv[], const std::string& name, const std::string& fallback) {
+    const auto prefix = "--" + name + "=";
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg(argv[i]);
+        if (arg.compare(0, prefix.size(), prefix) == 0)
+            return arg.substr(prefix.size());
+    }
+    return fallback;
+}
+
+/** Fixed-seed xorshift so every run (and variant) sees the same calls. */
+struct Random {
+    std::uint32_t state = 0x5eed;
+
+    std::uint32_t next() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    float nextFloat() { return static_cast<float>(next() >> 8) * (1.0f / 16777216.0f); }
+};
+
+/** Per-call settings: modes round-robin, cutoffs spread around each mode's defaults. */
+VoiceEngine::Settings makeSettings(int stream, double sampleRate, Random& random) {
+    VoiceEngine::Settings settings;
+    settings.mode = stream % DSP::ModeChainList::size;
+
+    const float nyquistLimit = static_cast<float>(sampleRate * 0.45);
+    settings.lowCut = 200.0f + 200.0f * random.nextFloat();
+    settings.highCut = std::min(nyquistLimit, 3000.0f + 2000.0f * random.nextFloat());
+    settings.mix = 1.0f;
+    return settings;
+}
+
+/** One 20 ms frame of seeded noise per stream, in one block of memory. */
+struct StreamBuffers {
+    StreamBuffers(int numStreams, int frameSize)
+        : samples(static_cast<size_t>(numStreams) * static_cast<size_t>(frameSize)),
+          pointers(static_cast<size_t>(numStreams)) {
+        Random random;
+        for (auto& sample : samples)
+            sample = 0.5f * (random.nextFloat() * 2.0f - 1.0f);
+
+        for (int i = 0; i < numStreams; ++i)
+            pointers[(size_t) i] = samples.data() + static_cast<size_t>(i) * static_cast<size_t>(frameSize);
+    }
+
+    std::vector<float> samples;
+    std::vector<float*> pointers;
+};
+
+/** Calls process() until at least seconds have passed; returns ns per processed frame. */
+template <typename ProcessFn>
+double timeFrames(double seconds, ProcessFn&& process) {
+    process();  // Warm-up
+
+    double totalNs = 0.0;
+    long long frames = 0;
+    while (totalNs < seconds * 1.0e9) {
+        const auto start = Clock::now();
+        for (int i = 0; i < 16; ++i)
+            process();
+        totalNs += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        frames += 16;
+    }
+    return totalNs / (double) frames;
+}
+
+void printRow(const char* variant, double sampleRate, int blockSize, int streams, int threads, double nsPerFrame) {
+    const double nsPerSample = nsPerFrame / ((double) streams * blockSize);
+    const double realtimeFactor = (blockSize / sampleRate) * 1.0e9 / nsPerFrame;
+    const double streamsPerCore = streams * realtimeFactor / threads;
+
+    std::cout << variant << ',' << sampleRate << ',' << blockSize << ',' << streams << ',' << threads << ','
+              << std::fixed << std::setprecision(4) << nsPerSample << ','
+              << std::setprecision(1) << realtimeFactor << ','
+              << std::setprecision(0) << streamsPerCore << std::endl;
+}
+
+//==============================================================================
+/** Baseline: one BiquadCascade per stream, each run on its own (its scalar mono path). */
+void benchPerStream(const Options& options, double sampleRate, int blockSize) {
+    struct Stream {
+        DSP::BiquadCascade<float> cascade;
+        int numSections = 0;
+    };
+
+    Random random;
+    std::vector<Stream> streams(static_cast<size_t>(options.streams));
+    for (int i = 0; i < options.streams; ++i) {
+        const auto settings = makeSettings(i, sampleRate, random);
+        auto& stream = streams[(size_t) i];
+
+        DSP::BiquadCoefficients<float> sections[DSP::BiquadCascade<float>::maxSections];
+        stream.numSections = DSP::VoiceBatch<float>::designMode(sampleRate, settings.mode, settings.lowCut,
+                                                                settings.highCut, sections);
+        stream.cascade.setSections(sections, stream.numSections);
+        stream.cascade.prepare(1);
+    }
+
+    StreamBuffers buffers(options.streams, blockSize);
+    const double nsPerFrame = timeFrames(options.seconds, [&] {
+        for (int i = 0; i < options.streams; ++i) {
+            float* channel = buffers.pointers[(size_t) i];
+            streams[(size_t) i].cascade.process(&channel, 1, blockSize);
+        }
+    });
+
+    printRow("per-stream", sampleRate, blockSize, options.streams, 1, nsPerFrame);
+}
+
+/** VoiceEngine with the given thread count. */
+void benchEngine(const Options& options, double sampleRate, int blockSize, int threads, const char* variant) {
+    VoiceEngine::Options engineOptions;
+    engineOptions.sampleRate = sampleRate;
+    engineOptions.maxStreams = options.streams;
+    engineOptions.numThreads = threads;
+
+    VoiceEngine engine(engineOptions);
+
+    Random random;
+    for (int i = 0; i < options.streams; ++i)
+        engine.createStream(makeSettings(i, sampleRate, random));
+
+    // Buffers by stream id (ids are not dense across shards)
+    StreamBuffers buffers(engine.getCapacity(), blockSize);
+    const double nsPerFrame = timeFrames(options.seconds, [&] {
+        engine.process(buffers.pointers.data(), buffers.pointers.data(), blockSize);
+    });
+
+    printRow(variant, sampleRate, blockSize, options.streams, engine.getNumThreads(), nsPerFrame);
+}
+
+} // namespace
+
+//==============================================================================
+int main(int argc, char* argv[]) {
+    Options options;
+    options.streams = std::max(1, std::atoi(getOption(argc, argv, "streams", "4096").c_str()));
+    options.threads = std::max(0, std::atoi(getOption(argc, argv, "threads", "0").c_str()));
+    options.seconds = std::max(0.05, std::atof(getOption(argc, argv, "time", "1.0").c_str()));
+
+    std::cout << "variant,sampleRate,blockSize,streams,threads,nsPerSample,realtimeFactor,streamsPerCore" << std::endl;
+
+    for (double sampleRate : { 8000.0, 16000.0, 48000.0 }) {
+        const int blockSize = static_cast<int>(sampleRate * 0.02);  // 20 ms frames, as in VoIP
+
+        benchPerStream(options, sampleRate, blockSize);
+        benchEngine(options, sampleRate, blockSize, 1, "batch");
+        benchEngine(options, sampleRate, blockSize, options.threads, "batch-mt");
+    }
+
+    return 0;
+}
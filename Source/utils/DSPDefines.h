@@ -12,10 +12,50 @@ namespace DSP {
     constexpr float RADIO_LOW_CUT_HZ = 200.0f;
     constexpr float RADIO_HIGH_CUT_HZ = 5000.0f;
 
+    // Multirate telephone band: decimate by 2 while the rate stays at or above this
+    // (44.1k -> 11.025k, 48k/96k/192k -> 12k)
+    constexpr double MULTIRATE_MIN_INTERNAL_RATE_HZ = 11025.0;
+
+    // Tuning drift: cutoff wobble at full amount (+/- octaves)
+    constexpr float DRIFT_MAX_DEPTH_OCTAVES = 1.0f;
+
+    // Saturation: gain into the soft clipper at full drive
+    constexpr float SATURATION_MAX_DRIVE_DB = 24.0f;
+
+    // Noise: hiss level range and default (dB RMS)
+    constexpr float NOISE_MIN_LEVEL_DB = -60.0f;
+    constexpr float NOISE_MAX_LEVEL_DB = -20.0f;
+    constexpr float NOISE_DEFAULT_LEVEL_DB = -45.0f;
+
+    // Impulse response mode: longest response kept, and the convolution's
+    // direct-form head (samples) and partition growth per level
+    constexpr double IMPULSE_RESPONSE_MAX_SECONDS = 10.0;
+    constexpr int CONVOLUTION_HEAD_SIZE = 64;
+    constexpr int CONVOLUTION_LEVEL_RATIO = 8;
+
+    // Codec modes: G.711 line rate, and the Packet Loss range (% of packets lost)
+    constexpr double CODEC_SAMPLE_RATE_HZ = 8000.0;
+    constexpr float CODEC_MAX_PACKET_LOSS_PERCENT = 20.0f;
+
+    // Output: gain range (dB), and the limiter's ceiling (dB true peak), lookahead and release
+    constexpr float OUTPUT_GAIN_MIN_DB = -24.0f;
+    constexpr float OUTPUT_GAIN_MAX_DB = 24.0f;
+    constexpr double LIMITER_CEILING_DB = -1.0;
+    constexpr double LIMITER_LOOKAHEAD_MS = 2.0;
+    constexpr double LIMITER_RELEASE_MS = 80.0;
+
+    // Silence: input below this peak level counts as silent (-120 dBFS), and
+    // filter tails are measured until they have decayed by the same amount
+    constexpr float SILENCE_THRESHOLD = 1.0e-6f;
+    constexpr double SILENCE_TAIL_DECAY_DB = 120.0;
+
     // Mode enum
     enum class Mode {
         Telephone = 0,
         Radio = 1,
-        Custom = 2
+        Custom = 2,
+        ImpulseResponse = 3,
+        MuLaw = 4,
+        ALaw = 5
     };
 }